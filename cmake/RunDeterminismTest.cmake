@@ -33,6 +33,12 @@ function(db_run_once out_output args_string)
       "stdout:\n${run_stdout}\n"
       "stderr:\n${run_stderr}\n")
   endif()
+  if(DEFINED TEST_RESULTS_FILE AND NOT "${TEST_RESULTS_FILE}" STREQUAL "")
+    # Hashes must come from the --results-file record, not the log.
+    file(READ "${TEST_RESULTS_FILE}" results_text)
+    set(${out_output} "${results_text}" PARENT_SCOPE)
+    return()
+  endif()
   set(${out_output} "${run_stdout}\n${run_stderr}" PARENT_SCOPE)
 endfunction()
 
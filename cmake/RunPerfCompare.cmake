@@ -0,0 +1,61 @@
+if(NOT DEFINED TEST_BIN)
+  message(FATAL_ERROR "TEST_BIN is required")
+endif()
+if(NOT DEFINED TEST_BASELINE OR "${TEST_BASELINE}" STREQUAL "")
+  message(FATAL_ERROR "TEST_BASELINE is required")
+endif()
+if(NOT DEFINED TEST_CANDIDATE OR "${TEST_CANDIDATE}" STREQUAL "")
+  message(FATAL_ERROR "TEST_CANDIDATE is required")
+endif()
+
+set(run_command ${TEST_BIN})
+if(DEFINED TEST_ARGS AND NOT "${TEST_ARGS}" STREQUAL "")
+  separate_arguments(run_args NATIVE_COMMAND "${TEST_ARGS}")
+  list(APPEND run_command ${run_args})
+endif()
+list(APPEND run_command --results-file ${TEST_CANDIDATE})
+execute_process(
+  COMMAND ${run_command}
+  RESULT_VARIABLE run_status
+  OUTPUT_VARIABLE run_stdout
+  ERROR_VARIABLE run_stderr
+)
+if(NOT run_status EQUAL 0)
+  message(FATAL_ERROR
+    "Perf run failed (status=${run_status})\n"
+    "stdout:\n${run_stdout}\n"
+    "stderr:\n${run_stderr}\n")
+endif()
+
+# A missing baseline fails unless recording was asked for; otherwise every
+# fresh build directory would compare a run against itself and pass.
+if(NOT EXISTS "${TEST_BASELINE}")
+  if(NOT TEST_RECORD_BASELINE)
+    message(FATAL_ERROR
+      "Missing perf baseline ${TEST_BASELINE}; configure with "
+      "-DDB_PERF_RECORD_BASELINE=ON once to record it")
+  endif()
+  get_filename_component(baseline_dir "${TEST_BASELINE}" DIRECTORY)
+  file(MAKE_DIRECTORY "${baseline_dir}")
+  configure_file("${TEST_CANDIDATE}" "${TEST_BASELINE}" COPYONLY)
+  message(STATUS "Recorded perf baseline ${TEST_BASELINE}")
+  return()
+endif()
+
+set(compare_command ${TEST_BIN} compare ${TEST_BASELINE} ${TEST_CANDIDATE})
+if(DEFINED TEST_COMPARE_ARGS AND NOT "${TEST_COMPARE_ARGS}" STREQUAL "")
+  separate_arguments(compare_args NATIVE_COMMAND "${TEST_COMPARE_ARGS}")
+  list(APPEND compare_command ${compare_args})
+endif()
+execute_process(
+  COMMAND ${compare_command}
+  RESULT_VARIABLE compare_status
+  OUTPUT_VARIABLE compare_stdout
+  ERROR_VARIABLE compare_stderr
+)
+if(NOT compare_status EQUAL 0)
+  message(FATAL_ERROR
+    "Perf regression against ${TEST_BASELINE} (status=${compare_status})\n"
+    "${compare_stdout}\n${compare_stderr}\n")
+endif()
+message(STATUS "Perf OK for ${TEST_BIN}:\n${compare_stdout}")
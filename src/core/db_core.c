@@ -1,6 +1,7 @@
 #include "db_core.h"
 
 #include <errno.h>
+#include <math.h>
 #include <signal.h>
 #include <stdarg.h>
 #include <stdint.h>
@@ -12,13 +13,70 @@
 #include <sys/signal.h>
 #endif
 
+#include "../config/benchmark_config.h"
+#include "db_histogram.h"
+#include "db_perf_counters.h"
+#include "db_results.h"
+#include "db_trace.h"
+
 #define DB_MAX_TEXT_FILE_BYTES (16U * 1024U * 1024U)
 #define DB_RUNTIME_OPTION_CAPACITY 32U
+#define DB_WARMUP_CV_WINDOW 32U
+// Steady-state detection gives up this many frames after the other warmup
+// limits are met, so a noisy run still produces a measurement.
+#define DB_WARMUP_CV_MAX_EXTRA_FRAMES 1000U
 #define DB_MAX_SLEEP_NS_D 100000000.0
 #define DISPLAY_LOCALHOST_PREFIX "localhost:"
 #define DISPLAY_LOOPBACK_PREFIX "127.0.0.1:"
 
 static volatile sig_atomic_t db_stop_requested = 0;
+static uint32_t db_grid_size_width = BENCH_WINDOW_WIDTH_PX;
+static uint32_t db_grid_size_height = BENCH_WINDOW_HEIGHT_PX;
+static struct {
+    uint64_t frames;
+    double elapsed_ms;
+} db_benchmark_last_final_result = {0};
+static struct {
+    db_histogram_t histogram;
+    uint64_t budget_ns;
+    uint64_t over_budget;
+} db_benchmark_frame_times = {0};
+static struct {
+    uint32_t frames;
+    double ms;
+    double cv_pct;
+} db_benchmark_warmup_config = {0};
+static struct {
+    int active;
+    int measuring;
+    uint64_t begin_ns;
+    uint64_t measure_start_ns;
+    uint64_t frames;
+    uint64_t limits_met_frames;
+    double window_ns[DB_WARMUP_CV_WINDOW];
+    uint32_t window_count;
+} db_benchmark_warmup = {0};
+static struct {
+    uint32_t spin_us;
+    db_pacer_catchup_t catchup;
+} db_pacer_config = {
+    .spin_us = DB_PACER_DEFAULT_SPIN_US,
+    .catchup = DB_PACER_CATCHUP_SKIP_AHEAD,
+};
+static struct {
+    int anchored;
+    double fps_cap;
+    uint64_t origin_ns;
+    uint64_t slot;
+    uint64_t last_start_ns;
+    uint64_t missed;
+    uint64_t skipped_slots;
+    // How late each paced frame actually started, in ns.
+    db_histogram_t wake_error;
+    uint64_t interval_count;
+    double interval_mean_ns;
+    double interval_m2;
+} db_pacer = {0};
 static struct {
     const char *key;
     const char *value;
@@ -239,34 +297,160 @@ uint64_t db_now_ns_monotonic(void) {
     return ((uint64_t)ts.tv_sec * DB_NS_PER_SECOND_U64) + (uint64_t)ts.tv_nsec;
 }
 
+int db_pacer_catchup_parse(const char *text, db_pacer_catchup_t *out_catchup) {
+    if ((text == NULL) || (out_catchup == NULL)) {
+        return 0;
+    }
+    if (strcmp(text, "skip-ahead") == 0) {
+        *out_catchup = DB_PACER_CATCHUP_SKIP_AHEAD;
+        return 1;
+    }
+    if (strcmp(text, "drop") == 0) {
+        *out_catchup = DB_PACER_CATCHUP_DROP;
+        return 1;
+    }
+    return 0;
+}
+
+const char *db_pacer_catchup_name(db_pacer_catchup_t catchup) {
+    return (catchup == DB_PACER_CATCHUP_DROP) ? "drop" : "skip-ahead";
+}
+
+void db_pacer_configure(uint32_t spin_us, db_pacer_catchup_t catchup) {
+    db_pacer_config.spin_us = spin_us;
+    db_pacer_config.catchup = catchup;
+}
+
+static void db_pacer_reset(void) {
+    memset(&db_pacer, 0, sizeof(db_pacer));
+    db_histogram_reset(&db_pacer.wake_error);
+}
+
+// Sleeps to spin_us before the deadline on the absolute timeline, then spins
+// out the rest so timer slack and wakeup latency do not add up per frame.
+static void db_pacer_sleep_until(const char *backend, uint64_t deadline_ns) {
+    const uint64_t spin_ns = (uint64_t)db_pacer_config.spin_us * 1000U;
+    if (deadline_ns > spin_ns) {
+        const uint64_t wake_ns = deadline_ns - spin_ns;
+#ifdef __linux__
+        (void)backend;
+        const struct timespec request = {
+            .tv_sec = (time_t)(wake_ns / DB_NS_PER_SECOND_U64),
+            .tv_nsec = (long)(wake_ns % DB_NS_PER_SECOND_U64),
+        };
+        // NOLINTNEXTLINE(misc-include-cleaner)
+        while ((clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &request,
+                                NULL) == EINTR) &&
+               !db_should_stop()) {
+        }
+#else
+        for (uint64_t now_ns = db_now_ns_monotonic();
+             (now_ns < wake_ns) && !db_should_stop();
+             now_ns = db_now_ns_monotonic()) {
+            const double remaining_ns_d = (double)(wake_ns - now_ns);
+            const double sleep_ns_d = (remaining_ns_d > DB_MAX_SLEEP_NS_D)
+                                          ? DB_MAX_SLEEP_NS_D
+                                          : remaining_ns_d;
+            struct timespec request = {0};
+            request.tv_nsec =
+                db_checked_double_to_long(backend, "sleep_ns", sleep_ns_d);
+            // NOLINTNEXTLINE(misc-include-cleaner)
+            if ((nanosleep(&request, NULL) != 0) && (errno != EINTR)) {
+                break;
+            }
+        }
+#endif
+    }
+    while ((db_now_ns_monotonic() < deadline_ns) && !db_should_stop()) {
+    }
+}
+
 void db_sleep_to_fps_cap(const char *backend, uint64_t frame_start_ns,
                          double fps_cap) {
     if (fps_cap <= 0.0) {
         return;
     }
 
-    const double frame_budget_ns_d = DB_NS_PER_SECOND_D / fps_cap;
-    double remaining_ns_d =
-        frame_budget_ns_d - (double)(db_now_ns_monotonic() - frame_start_ns);
-    while (remaining_ns_d > 0.0) {
-        const double sleep_ns_d = (remaining_ns_d > DB_MAX_SLEEP_NS_D)
-                                      ? DB_MAX_SLEEP_NS_D
-                                      : remaining_ns_d;
-        const long sleep_ns =
-            db_checked_double_to_long(backend, "sleep_ns", sleep_ns_d);
-        if (sleep_ns <= 0L) {
-            break;
+    // Frame n starts at origin + n * period; deriving every deadline from
+    // the origin keeps rounding and oversleep from accumulating.
+    const double period_ns_d = DB_NS_PER_SECOND_D / fps_cap;
+    db_pacer.fps_cap = fps_cap;
+    if (db_pacer.anchored == 0) {
+        db_pacer.anchored = 1;
+        db_pacer.origin_ns = frame_start_ns;
+        db_pacer.slot = 0U;
+        db_pacer.last_start_ns = frame_start_ns;
+    }
+    db_pacer.slot++;
+    uint64_t deadline_ns =
+        db_pacer.origin_ns +
+        (uint64_t)llround((double)db_pacer.slot * period_ns_d);
+    const uint64_t now_ns = db_now_ns_monotonic();
+    int paced = 1;
+    if (now_ns >= deadline_ns) {
+        db_pacer.missed++;
+        if (db_pacer_config.catchup == DB_PACER_CATCHUP_DROP) {
+            // Start the late frame's successor now and rebase the timeline
+            // on it.
+            db_pacer.origin_ns = now_ns;
+            db_pacer.slot = 0U;
+            deadline_ns = now_ns;
+            paced = 0;
+        } else {
+            // Skip the slots that already passed and wait for the next one,
+            // keeping the original phase.
+            const uint64_t late_slots =
+                (uint64_t)((double)(now_ns - deadline_ns) / period_ns_d) + 1U;
+            db_pacer.slot += late_slots;
+            db_pacer.skipped_slots += late_slots;
+            deadline_ns = db_pacer.origin_ns +
+                          (uint64_t)llround((double)db_pacer.slot *
+                                            period_ns_d);
         }
+    }
+    DB_TRACE_BEGIN("fps_cap_sleep");
+    if (paced != 0) {
+        db_pacer_sleep_until(backend, deadline_ns);
+    }
+    DB_TRACE_END("fps_cap_sleep");
+
+    const uint64_t start_ns = db_now_ns_monotonic();
+    if (paced != 0) {
+        db_histogram_record(&db_pacer.wake_error,
+                            (start_ns > deadline_ns) ? (start_ns - deadline_ns)
+                                                     : 0U);
+    }
+    // Welford update of the achieved frame-start interval.
+    const double interval_ns = (double)(start_ns - db_pacer.last_start_ns);
+    db_pacer.last_start_ns = start_ns;
+    db_pacer.interval_count++;
+    const double delta = interval_ns - db_pacer.interval_mean_ns;
+    db_pacer.interval_mean_ns += delta / (double)db_pacer.interval_count;
+    db_pacer.interval_m2 += delta * (interval_ns - db_pacer.interval_mean_ns);
+}
 
-        struct timespec request = {0};
-        request.tv_nsec = sleep_ns;
-        // NOLINTNEXTLINE(misc-include-cleaner)
-        if ((nanosleep(&request, NULL) != 0) && (errno != EINTR)) {
-            break;
-        }
-        remaining_ns_d = frame_budget_ns_d -
-                         (double)(db_now_ns_monotonic() - frame_start_ns);
+static void db_pacer_log_final(const char *api_name) {
+    if (db_pacer.interval_count == 0U) {
+        return;
     }
+    const double interval_stddev_ns =
+        (db_pacer.interval_count > 1U)
+            ? sqrt(db_pacer.interval_m2 /
+                   (double)(db_pacer.interval_count - 1U))
+            : 0.0;
+    const db_histogram_t *wake_error = &db_pacer.wake_error;
+    printf("%s pacing (final): target_hz=%.2f achieved_hz=%.2f "
+           "interval_stddev_us=%.1f missed=%llu skipped_slots=%llu "
+           "catchup=%s wake_late_p50_us=%.1f wake_late_p99_us=%.1f "
+           "wake_late_max_us=%.1f spin_us=%u\n",
+           api_name, db_pacer.fps_cap,
+           DB_NS_PER_SECOND_D / db_pacer.interval_mean_ns,
+           interval_stddev_ns / 1000.0, (unsigned long long)db_pacer.missed,
+           (unsigned long long)db_pacer.skipped_slots,
+           db_pacer_catchup_name(db_pacer_config.catchup),
+           (double)db_histogram_percentile(wake_error, 50.0) / 1000.0,
+           (double)db_histogram_percentile(wake_error, 99.0) / 1000.0,
+           (double)wake_error->max_value / 1000.0, db_pacer_config.spin_us);
 }
 
 uint8_t *db_read_file_or_fail(const char *backend, const char *path,
@@ -329,6 +513,188 @@ char *db_read_text_file_or_fail(const char *backend, const char *path) {
     return text;
 }
 
+void db_benchmark_warmup_set(uint32_t frames, double ms, double cv_pct) {
+    db_benchmark_warmup_config.frames = frames;
+    db_benchmark_warmup_config.ms = ms;
+    db_benchmark_warmup_config.cv_pct = cv_pct;
+}
+
+static int db_benchmark_warmup_enabled(void) {
+    return (db_benchmark_warmup_config.frames > 0U) ||
+           (db_benchmark_warmup_config.ms > 0.0) ||
+           (db_benchmark_warmup_config.cv_pct > 0.0);
+}
+
+void db_benchmark_frame_times_begin(double fps_cap) {
+    db_histogram_reset(&db_benchmark_frame_times.histogram);
+    db_benchmark_frame_times.over_budget = 0U;
+    db_benchmark_frame_times.budget_ns =
+        (fps_cap > 0.0) ? (uint64_t)(DB_NS_PER_SECOND_D / fps_cap) : 0U;
+    memset(&db_benchmark_warmup, 0, sizeof(db_benchmark_warmup));
+    db_benchmark_warmup.active = db_benchmark_warmup_enabled();
+    db_benchmark_warmup.begin_ns = db_now_ns_monotonic();
+    db_pacer_reset();
+    db_perf_counters_begin();
+}
+
+static double db_benchmark_warmup_window_cv_pct(void) {
+    double sum = 0.0;
+    for (uint32_t i = 0U; i < DB_WARMUP_CV_WINDOW; i++) {
+        sum += db_benchmark_warmup.window_ns[i];
+    }
+    const double mean = sum / (double)DB_WARMUP_CV_WINDOW;
+    if (mean <= 0.0) {
+        return 0.0;
+    }
+    double sum_sq = 0.0;
+    for (uint32_t i = 0U; i < DB_WARMUP_CV_WINDOW; i++) {
+        const double delta = db_benchmark_warmup.window_ns[i] - mean;
+        sum_sq += delta * delta;
+    }
+    return 100.0 * sqrt(sum_sq / (double)(DB_WARMUP_CV_WINDOW - 1U)) / mean;
+}
+
+// Returns 1 while frame_ns still belongs to the warmup.
+static int db_benchmark_warmup_consume(uint64_t frame_ns) {
+    if (db_benchmark_warmup.active == 0) {
+        return 0;
+    }
+    const uint64_t now_ns = db_now_ns_monotonic();
+    db_benchmark_warmup.frames++;
+    db_benchmark_warmup
+        .window_ns[db_benchmark_warmup.window_count % DB_WARMUP_CV_WINDOW] =
+        (double)frame_ns;
+    db_benchmark_warmup.window_count++;
+
+    const double warmup_ms =
+        (double)(now_ns - db_benchmark_warmup.begin_ns) / DB_NS_PER_MS_D;
+    if ((db_benchmark_warmup.frames < db_benchmark_warmup_config.frames) ||
+        (warmup_ms < db_benchmark_warmup_config.ms)) {
+        return 1;
+    }
+    double cv_pct = 0.0;
+    if (db_benchmark_warmup_config.cv_pct > 0.0) {
+        if (db_benchmark_warmup.limits_met_frames == 0U) {
+            db_benchmark_warmup.limits_met_frames = db_benchmark_warmup.frames;
+        }
+        const int gave_up = (db_benchmark_warmup.frames -
+                             db_benchmark_warmup.limits_met_frames) >=
+                            DB_WARMUP_CV_MAX_EXTRA_FRAMES;
+        if (db_benchmark_warmup.window_count < DB_WARMUP_CV_WINDOW) {
+            return 1;
+        }
+        cv_pct = db_benchmark_warmup_window_cv_pct();
+        if ((cv_pct > db_benchmark_warmup_config.cv_pct) && !gave_up) {
+            return 1;
+        }
+        if (gave_up) {
+            db_infof("db_core",
+                     "warmup: frame-time cv stayed above %.2f%% (last %.2f%%); "
+                     "measuring anyway",
+                     db_benchmark_warmup_config.cv_pct, cv_pct);
+        }
+    }
+    db_benchmark_warmup.active = 0;
+    db_infof("db_core", "warmup done: frames=%llu ms=%.2f cv_pct=%.2f",
+             (unsigned long long)db_benchmark_warmup.frames, warmup_ms, cv_pct);
+    return 1;
+}
+
+void db_benchmark_frame_time_record_ns(uint64_t frame_ns) {
+    const int warming_up = db_benchmark_warmup_consume(frame_ns);
+    db_perf_counters_frame_end(warming_up == 0);
+    if (warming_up != 0) {
+        return;
+    }
+    if ((db_benchmark_warmup.frames > 0U) &&
+        (db_benchmark_warmup.measuring == 0)) {
+        // Measurement starts at the first post-warmup frame's start, so the
+        // last warmup frame's pacing sleep is not counted.
+        db_benchmark_warmup.measuring = 1;
+        db_benchmark_warmup.measure_start_ns = db_now_ns_monotonic() - frame_ns;
+    }
+    db_histogram_record(&db_benchmark_frame_times.histogram, frame_ns);
+    if ((db_benchmark_frame_times.budget_ns > 0U) &&
+        (frame_ns > db_benchmark_frame_times.budget_ns)) {
+        db_benchmark_frame_times.over_budget++;
+    }
+}
+
+static double db_benchmark_frame_time_ms(double percentile) {
+    return (double)db_histogram_percentile(
+               &db_benchmark_frame_times.histogram, percentile) /
+           DB_NS_PER_MS_D;
+}
+
+static void db_benchmark_log_frame_times(const char *api_name) {
+    const db_histogram_t *histogram = &db_benchmark_frame_times.histogram;
+    if (histogram->total_count == 0U) {
+        return;
+    }
+    char over_budget[64];
+    if (db_benchmark_frame_times.budget_ns > 0U) {
+        (void)db_snprintf(
+            over_budget, sizeof(over_budget), "%llu (budget_ms=%.3f)",
+            (unsigned long long)db_benchmark_frame_times.over_budget,
+            (double)db_benchmark_frame_times.budget_ns / DB_NS_PER_MS_D);
+    } else {
+        (void)db_snprintf(over_budget, sizeof(over_budget), "n/a");
+    }
+    printf("%s frame times (final): min_ms=%.3f p50_ms=%.3f p90_ms=%.3f "
+           "p99_ms=%.3f p99_9_ms=%.3f max_ms=%.3f over_budget=%s\n",
+           api_name, (double)histogram->min_value / DB_NS_PER_MS_D,
+           db_benchmark_frame_time_ms(50.0), db_benchmark_frame_time_ms(90.0),
+           db_benchmark_frame_time_ms(99.0), db_benchmark_frame_time_ms(99.9),
+           (double)histogram->max_value / DB_NS_PER_MS_D, over_budget);
+}
+
+// Narrows frames/elapsed_ms to the post-warmup window. Returns 0 (leaving
+// them untouched) when warmup is on but nothing has been measured yet.
+static int db_benchmark_measured_window(uint64_t *frames, double *elapsed_ms) {
+    if (db_benchmark_warmup.measuring != 0) {
+        *frames -= db_benchmark_warmup.frames;
+        *elapsed_ms = (double)(db_now_ns_monotonic() -
+                               db_benchmark_warmup.measure_start_ns) /
+                      DB_NS_PER_MS_D;
+        return 1;
+    }
+    return (db_benchmark_warmup.active == 0) &&
+           (db_benchmark_warmup.frames == 0U);
+}
+
+static void db_benchmark_record_results(
+    const char *api_name, const char *renderer_name, const char *backend_name,
+    uint64_t frames, uint32_t work_units, double elapsed_ms, const char *tag,
+    const char *mode) {
+    const db_histogram_t *histogram = &db_benchmark_frame_times.histogram;
+    db_results_record_t record = {
+        .api = api_name,
+        .renderer = renderer_name,
+        .backend = backend_name,
+        .capability_mode = mode,
+        .record = tag,
+        .frames = frames,
+        .work_units = work_units,
+        .total_ms = elapsed_ms,
+        .ms_per_frame = elapsed_ms / (double)frames,
+        .fps = ((double)frames * DB_MS_PER_SECOND_D) / elapsed_ms,
+        .frame_time_count = histogram->total_count,
+        .budget_ms =
+            (double)db_benchmark_frame_times.budget_ns / DB_NS_PER_MS_D,
+        .over_budget = db_benchmark_frame_times.over_budget,
+        .perf = db_perf_counters_summary(),
+    };
+    if (histogram->total_count > 0U) {
+        record.min_ms = (double)histogram->min_value / DB_NS_PER_MS_D;
+        record.p50_ms = db_benchmark_frame_time_ms(50.0);
+        record.p90_ms = db_benchmark_frame_time_ms(90.0);
+        record.p99_ms = db_benchmark_frame_time_ms(99.0);
+        record.p99_9_ms = db_benchmark_frame_time_ms(99.9);
+        record.max_ms = (double)histogram->max_value / DB_NS_PER_MS_D;
+    }
+    db_results_record(&record);
+}
+
 static void db_benchmark_log(const char *api_name, const char *renderer_name,
                              const char *backend_name, uint64_t frames,
                              uint32_t work_units, double elapsed_ms,
@@ -340,6 +706,8 @@ static void db_benchmark_log(const char *api_name, const char *renderer_name,
     double ms_per_frame = elapsed_ms / (double)frames;
     double fps = DB_MS_PER_SECOND_D / ms_per_frame;
     const char *mode = (capability_mode != NULL) ? capability_mode : "default";
+    db_benchmark_record_results(api_name, renderer_name, backend_name, frames,
+                                work_units, elapsed_ms, tag, mode);
     if (strcmp(tag, "progress") == 0) {
         printf("%s benchmark (%s): mode=%s frames=%llu total_ms=%.2f "
                "ms_per_frame=%.3f fps=%.2f\n",
@@ -370,8 +738,13 @@ void db_benchmark_log_periodic(const char *api_name, const char *renderer_name,
         return;
     }
 
-    db_benchmark_log(api_name, renderer_name, backend_name, frames, work_units,
-                     elapsed_ms, "progress", capability_mode);
+    uint64_t measured_frames = frames;
+    double measured_ms = elapsed_ms;
+    if (db_benchmark_measured_window(&measured_frames, &measured_ms) != 0) {
+        db_benchmark_log(api_name, renderer_name, backend_name,
+                         measured_frames, work_units, measured_ms, "progress",
+                         capability_mode);
+    }
     do {
         *next_log_due_ms += interval_ms;
     } while (elapsed_ms >= *next_log_due_ms);
@@ -381,6 +754,72 @@ void db_benchmark_log_final(const char *api_name, const char *renderer_name,
                             const char *backend_name, uint64_t frames,
                             uint32_t work_units, double elapsed_ms,
                             const char *capability_mode) {
+    if ((db_benchmark_measured_window(&frames, &elapsed_ms) == 0) &&
+        (db_benchmark_warmup_enabled() != 0)) {
+        db_infof("db_core", "warmup did not finish after %llu frames; "
+                            "reporting every frame",
+                 (unsigned long long)frames);
+    }
+    db_benchmark_last_final_result.frames = frames;
+    db_benchmark_last_final_result.elapsed_ms = elapsed_ms;
     db_benchmark_log(api_name, renderer_name, backend_name, frames, work_units,
                      elapsed_ms, "final", capability_mode);
+    db_benchmark_log_frame_times(api_name);
+    db_pacer_log_final(api_name);
+    db_perf_counters_log_final(api_name);
+}
+
+void db_benchmark_last_final(uint64_t *out_frames, double *out_elapsed_ms) {
+    if (out_frames != NULL) {
+        *out_frames = db_benchmark_last_final_result.frames;
+    }
+    if (out_elapsed_ms != NULL) {
+        *out_elapsed_ms = db_benchmark_last_final_result.elapsed_ms;
+    }
+}
+
+int db_parse_grid_size_text(const char *value, uint32_t *out_width,
+                            uint32_t *out_height) {
+    if ((value == NULL) || (value[0] == '\0')) {
+        return 0;
+    }
+    char *end = NULL;
+    const unsigned long width = strtoul(value, &end, 10);
+    if ((end == value) || (end == NULL) || ((*end != 'x') && (*end != 'X'))) {
+        return 0;
+    }
+    const char *height_text = end + 1;
+    const unsigned long height = strtoul(height_text, &end, 10);
+    if ((end == height_text) || (end == NULL) || (*end != '\0')) {
+        return 0;
+    }
+    if ((width == 0UL) || (height == 0UL) || (width > DB_GRID_MAX_WIDTH) ||
+        (height > DB_GRID_MAX_HEIGHT)) {
+        return 0;
+    }
+    if (out_width != NULL) {
+        *out_width = (uint32_t)width;
+    }
+    if (out_height != NULL) {
+        *out_height = (uint32_t)height;
+    }
+    return 1;
+}
+
+void db_grid_size_set(uint32_t width, uint32_t height) {
+    if ((width == 0U) || (height == 0U) || (width > DB_GRID_MAX_WIDTH) ||
+        (height > DB_GRID_MAX_HEIGHT)) {
+        db_failf("db_core", "invalid grid size: %ux%u (max: %ux%u)", width,
+                 height, DB_GRID_MAX_WIDTH, DB_GRID_MAX_HEIGHT);
+    }
+    db_grid_size_width = width;
+    db_grid_size_height = height;
+}
+
+uint32_t db_grid_width(void) {
+    return db_grid_size_width;
+}
+
+uint32_t db_grid_height(void) {
+    return db_grid_size_height;
 }
@@ -12,21 +12,60 @@
 #define DB_CAN_USE_STDCKDINT 1
 #endif
 #endif
+#define DB_GRID_MAX_HEIGHT 4320U
+#define DB_GRID_MAX_WIDTH 7680U
 #define DB_MS_PER_SECOND_D 1000.0
 #define DB_NS_PER_MS_D 1000000.0
 #define DB_NS_PER_SECOND_D 1000000000.0
 #define DB_NS_PER_SECOND_U64 UINT64_C(1000000000)
+#define DB_PACER_DEFAULT_SPIN_US 200U
+#define DB_PACER_MAX_SPIN_US 100000U
 #define DB_U24_MAX_F 16777215.0F
 #define DB_RUNTIME_OPT_ALLOW_REMOTE_DISPLAY "allow_remote_display"
 #define DB_RUNTIME_OPT_BENCH_SPEED "bench_speed"
 #define DB_RUNTIME_OPT_BENCHMARK_MODE "benchmark_mode"
+#define DB_RUNTIME_OPT_CHECKPOINT_FILE "checkpoint_file"
+#define DB_RUNTIME_OPT_CHECKPOINT_INTERVAL "checkpoint_interval"
+#define DB_RUNTIME_OPT_CPU_BLEND "cpu_blend"
+#define DB_RUNTIME_OPT_CPU_KERNEL "cpu_kernel"
+#define DB_RUNTIME_OPT_CPU_LAYOUT "cpu_layout"
+#define DB_RUNTIME_OPT_CPU_MEM "cpu_mem"
+#define DB_RUNTIME_OPT_CPU_THREADS "cpu_threads"
 #define DB_RUNTIME_OPT_FPS_CAP "fps_cap"
 #define DB_RUNTIME_OPT_FRAME_LIMIT "frame_limit"
+#define DB_RUNTIME_OPT_GRADIENT_PLANNER "gradient_planner"
+#define DB_RUNTIME_OPT_GRID "grid"
 #define DB_RUNTIME_OPT_HASH "hash"
+#define DB_RUNTIME_OPT_HASH_ALGO "hash_algo"
+#define DB_RUNTIME_OPT_HASH_INCREMENTAL "hash_incremental"
+#define DB_RUNTIME_OPT_HASH_QUEUE_DEPTH "hash_queue_depth"
 #define DB_RUNTIME_OPT_HASH_REPORT "hash_report"
+#define DB_RUNTIME_OPT_HASH_TRACE "hash_trace"
+#define DB_RUNTIME_OPT_HASH_VERIFY "hash_verify"
 #define DB_RUNTIME_OPT_OFFSCREEN "offscreen"
+#define DB_RUNTIME_OPT_PACER_CATCHUP "pacer_catchup"
+#define DB_RUNTIME_OPT_PACER_SPIN_US "pacer_spin_us"
+#define DB_RUNTIME_OPT_PERF_COUNTERS "perf_counters"
 #define DB_RUNTIME_OPT_RANDOM_SEED "random_seed"
+#define DB_RUNTIME_OPT_REPEAT "repeat"
+#define DB_RUNTIME_OPT_RESOLUTION_SWEEP "resolution_sweep"
+#define DB_RUNTIME_OPT_RESULTS_FILE "results_file"
+#define DB_RUNTIME_OPT_RESULTS_FORMAT "results_format"
+#define DB_RUNTIME_OPT_START_FRAME "start_frame"
+#define DB_RUNTIME_OPT_SWEEP "sweep"
+#define DB_RUNTIME_OPT_TRACE_FILE "trace_file"
 #define DB_RUNTIME_OPT_VSYNC "vsync"
+#define DB_RUNTIME_OPT_WARMUP_CV "warmup_cv"
+#define DB_RUNTIME_OPT_WARMUP_FRAMES "warmup_frames"
+#define DB_RUNTIME_OPT_WARMUP_MS "warmup_ms"
+
+// What the fps-cap pacer does after a frame overruns its deadline.
+typedef enum {
+    // Wait for the next slot on the original timeline, keeping its phase.
+    DB_PACER_CATCHUP_SKIP_AHEAD = 0,
+    // Start the next frame immediately and rebase the timeline on it.
+    DB_PACER_CATCHUP_DROP = 1,
+} db_pacer_catchup_t;
 
 void db_failf(const char *backend, const char *fmt, ...)
     __attribute__((format(printf, 2, 3), noreturn));
@@ -45,8 +84,16 @@ void db_validate_runtime_environment(const char *backend,
 void db_install_signal_handlers(void);
 int db_should_stop(void);
 uint64_t db_now_ns_monotonic(void);
+// Paces frame starts on an absolute timeline anchored at the first call's
+// frame_start_ns (re-anchored by db_benchmark_frame_times_begin): sleeps
+// with an absolute-deadline clock_nanosleep, then spins for the final
+// spin_us. Missed deadlines follow the catch-up policy and are reported with
+// the wakeup jitter by db_benchmark_log_final.
 void db_sleep_to_fps_cap(const char *backend, uint64_t frame_start_ns,
                          double fps_cap);
+int db_pacer_catchup_parse(const char *text, db_pacer_catchup_t *out_catchup);
+const char *db_pacer_catchup_name(db_pacer_catchup_t catchup);
+void db_pacer_configure(uint32_t spin_us, db_pacer_catchup_t catchup);
 
 uint8_t *db_read_file_or_fail(const char *backend, const char *path,
                               size_t *out_sz);
@@ -61,6 +108,26 @@ void db_benchmark_log_final(const char *api_name, const char *renderer_name,
                             const char *backend_name, uint64_t frames,
                             uint32_t work_units, double elapsed_ms,
                             const char *capability_mode);
+void db_benchmark_last_final(uint64_t *out_frames, double *out_elapsed_ms);
+// Per-frame work time (frame start to just before fps-cap pacing), kept in a
+// fixed-size histogram and summarized by db_benchmark_log_final. Display
+// loops call begin once before their first frame.
+void db_benchmark_frame_times_begin(double fps_cap);
+void db_benchmark_frame_time_record_ns(uint64_t frame_ns);
+// Frames recorded before the warmup ends are rendered as usual but left out
+// of the histogram, progress logs and the final frames/elapsed figures. The
+// warmup ends once every enabled limit is met: a frame count, a duration,
+// and a rolling coefficient of variation of frame time at or below cv_pct.
+// All zero disables warmup.
+void db_benchmark_warmup_set(uint32_t frames, double ms, double cv_pct);
+
+// Benchmark grid (= render target) size; defaults to BENCH_WINDOW_*_PX and
+// may be overridden with --grid before a display run starts.
+int db_parse_grid_size_text(const char *value, uint32_t *out_width,
+                            uint32_t *out_height);
+void db_grid_size_set(uint32_t width, uint32_t height);
+uint32_t db_grid_width(void);
+uint32_t db_grid_height(void);
 
 static inline int32_t db_checked_u32_to_i32(const char *backend,
                                             const char *field_name,
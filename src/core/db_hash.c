@@ -2,6 +2,129 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "db_core.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) &&                             \
+    (defined(__GNUC__) || defined(__clang__))
+#define DB_HASH_X86 1
+#include <immintrin.h>
+#endif
+
+#define DB_XXH3_MIDSIZE_LAST_OFFSET 17U
+#define DB_XXH3_MIDSIZE_MAX 240U
+#define DB_XXH3_MIDSIZE_START_OFFSET 3U
+#define DB_XXH3_PRIME_MX1 UINT64_C(0x165667919E3779F9)
+#define DB_XXH3_PRIME_MX2 UINT64_C(0x9FB21C651E98DF25)
+#define DB_XXH3_SECRET_CONSUME_RATE 8U
+#define DB_XXH3_SECRET_LASTACC_START 7U
+#define DB_XXH3_SECRET_LIMIT (DB_XXH3_SECRET_SIZE - DB_XXH3_STRIPE_LEN)
+#define DB_XXH3_SECRET_MERGE_START 11U
+#define DB_XXH3_SECRET_SIZE 192U
+#define DB_XXH3_SECRET_SIZE_MIN 136U
+#define DB_XXH3_STRIPE_LEN 64U
+#define DB_XXH3_STRIPES_PER_BLOCK                                              \
+    (DB_XXH3_SECRET_LIMIT / DB_XXH3_SECRET_CONSUME_RATE)
+#define DB_XXH_PRIME32_1 UINT32_C(0x9E3779B1)
+#define DB_XXH_PRIME32_2 UINT32_C(0x85EBCA77)
+#define DB_XXH_PRIME32_3 UINT32_C(0xC2B2AE3D)
+#define DB_XXH_PRIME64_1 UINT64_C(0x9E3779B185EBCA87)
+#define DB_XXH_PRIME64_2 UINT64_C(0xC2B2AE3D27D4EB4F)
+#define DB_XXH_PRIME64_3 UINT64_C(0x165667B19E3779F9)
+#define DB_XXH_PRIME64_4 UINT64_C(0x85EBCA77C2B2AE63)
+#define DB_XXH_PRIME64_5 UINT64_C(0x27D4EB2F165667C5)
+
+// Reflected CRC-32C (Castagnoli, polynomial 0x82F63B78) byte table.
+static const uint32_t g_crc32c_table[256] = {
+    0x00000000U, 0xF26B8303U, 0xE13B70F7U, 0x1350F3F4U,
+    0xC79A971FU, 0x35F1141CU, 0x26A1E7E8U, 0xD4CA64EBU,
+    0x8AD958CFU, 0x78B2DBCCU, 0x6BE22838U, 0x9989AB3BU,
+    0x4D43CFD0U, 0xBF284CD3U, 0xAC78BF27U, 0x5E133C24U,
+    0x105EC76FU, 0xE235446CU, 0xF165B798U, 0x030E349BU,
+    0xD7C45070U, 0x25AFD373U, 0x36FF2087U, 0xC494A384U,
+    0x9A879FA0U, 0x68EC1CA3U, 0x7BBCEF57U, 0x89D76C54U,
+    0x5D1D08BFU, 0xAF768BBCU, 0xBC267848U, 0x4E4DFB4BU,
+    0x20BD8EDEU, 0xD2D60DDDU, 0xC186FE29U, 0x33ED7D2AU,
+    0xE72719C1U, 0x154C9AC2U, 0x061C6936U, 0xF477EA35U,
+    0xAA64D611U, 0x580F5512U, 0x4B5FA6E6U, 0xB93425E5U,
+    0x6DFE410EU, 0x9F95C20DU, 0x8CC531F9U, 0x7EAEB2FAU,
+    0x30E349B1U, 0xC288CAB2U, 0xD1D83946U, 0x23B3BA45U,
+    0xF779DEAEU, 0x05125DADU, 0x1642AE59U, 0xE4292D5AU,
+    0xBA3A117EU, 0x4851927DU, 0x5B016189U, 0xA96AE28AU,
+    0x7DA08661U, 0x8FCB0562U, 0x9C9BF696U, 0x6EF07595U,
+    0x417B1DBCU, 0xB3109EBFU, 0xA0406D4BU, 0x522BEE48U,
+    0x86E18AA3U, 0x748A09A0U, 0x67DAFA54U, 0x95B17957U,
+    0xCBA24573U, 0x39C9C670U, 0x2A993584U, 0xD8F2B687U,
+    0x0C38D26CU, 0xFE53516FU, 0xED03A29BU, 0x1F682198U,
+    0x5125DAD3U, 0xA34E59D0U, 0xB01EAA24U, 0x42752927U,
+    0x96BF4DCCU, 0x64D4CECFU, 0x77843D3BU, 0x85EFBE38U,
+    0xDBFC821CU, 0x2997011FU, 0x3AC7F2EBU, 0xC8AC71E8U,
+    0x1C661503U, 0xEE0D9600U, 0xFD5D65F4U, 0x0F36E6F7U,
+    0x61C69362U, 0x93AD1061U, 0x80FDE395U, 0x72966096U,
+    0xA65C047DU, 0x5437877EU, 0x4767748AU, 0xB50CF789U,
+    0xEB1FCBADU, 0x197448AEU, 0x0A24BB5AU, 0xF84F3859U,
+    0x2C855CB2U, 0xDEEEDFB1U, 0xCDBE2C45U, 0x3FD5AF46U,
+    0x7198540DU, 0x83F3D70EU, 0x90A324FAU, 0x62C8A7F9U,
+    0xB602C312U, 0x44694011U, 0x5739B3E5U, 0xA55230E6U,
+    0xFB410CC2U, 0x092A8FC1U, 0x1A7A7C35U, 0xE811FF36U,
+    0x3CDB9BDDU, 0xCEB018DEU, 0xDDE0EB2AU, 0x2F8B6829U,
+    0x82F63B78U, 0x709DB87BU, 0x63CD4B8FU, 0x91A6C88CU,
+    0x456CAC67U, 0xB7072F64U, 0xA457DC90U, 0x563C5F93U,
+    0x082F63B7U, 0xFA44E0B4U, 0xE9141340U, 0x1B7F9043U,
+    0xCFB5F4A8U, 0x3DDE77ABU, 0x2E8E845FU, 0xDCE5075CU,
+    0x92A8FC17U, 0x60C37F14U, 0x73938CE0U, 0x81F80FE3U,
+    0x55326B08U, 0xA759E80BU, 0xB4091BFFU, 0x466298FCU,
+    0x1871A4D8U, 0xEA1A27DBU, 0xF94AD42FU, 0x0B21572CU,
+    0xDFEB33C7U, 0x2D80B0C4U, 0x3ED04330U, 0xCCBBC033U,
+    0xA24BB5A6U, 0x502036A5U, 0x4370C551U, 0xB11B4652U,
+    0x65D122B9U, 0x97BAA1BAU, 0x84EA524EU, 0x7681D14DU,
+    0x2892ED69U, 0xDAF96E6AU, 0xC9A99D9EU, 0x3BC21E9DU,
+    0xEF087A76U, 0x1D63F975U, 0x0E330A81U, 0xFC588982U,
+    0xB21572C9U, 0x407EF1CAU, 0x532E023EU, 0xA145813DU,
+    0x758FE5D6U, 0x87E466D5U, 0x94B49521U, 0x66DF1622U,
+    0x38CC2A06U, 0xCAA7A905U, 0xD9F75AF1U, 0x2B9CD9F2U,
+    0xFF56BD19U, 0x0D3D3E1AU, 0x1E6DCDEEU, 0xEC064EEDU,
+    0xC38D26C4U, 0x31E6A5C7U, 0x22B65633U, 0xD0DDD530U,
+    0x0417B1DBU, 0xF67C32D8U, 0xE52CC12CU, 0x1747422FU,
+    0x49547E0BU, 0xBB3FFD08U, 0xA86F0EFCU, 0x5A048DFFU,
+    0x8ECEE914U, 0x7CA56A17U, 0x6FF599E3U, 0x9D9E1AE0U,
+    0xD3D3E1ABU, 0x21B862A8U, 0x32E8915CU, 0xC083125FU,
+    0x144976B4U, 0xE622F5B7U, 0xF5720643U, 0x07198540U,
+    0x590AB964U, 0xAB613A67U, 0xB831C993U, 0x4A5A4A90U,
+    0x9E902E7BU, 0x6CFBAD78U, 0x7FAB5E8CU, 0x8DC0DD8FU,
+    0xE330A81AU, 0x115B2B19U, 0x020BD8EDU, 0xF0605BEEU,
+    0x24AA3F05U, 0xD6C1BC06U, 0xC5914FF2U, 0x37FACCF1U,
+    0x69E9F0D5U, 0x9B8273D6U, 0x88D28022U, 0x7AB90321U,
+    0xAE7367CAU, 0x5C18E4C9U, 0x4F48173DU, 0xBD23943EU,
+    0xF36E6F75U, 0x0105EC76U, 0x12551F82U, 0xE03E9C81U,
+    0x34F4F86AU, 0xC69F7B69U, 0xD5CF889DU, 0x27A40B9EU,
+    0x79B737BAU, 0x8BDCB4B9U, 0x988C474DU, 0x6AE7C44EU,
+    0xBE2DA0A5U, 0x4C4623A6U, 0x5F16D052U, 0xAD7D5351U,
+};
+
+// Default XXH3 secret (kSecret from the reference implementation).
+static const uint8_t g_xxh3_secret[DB_XXH3_SECRET_SIZE] = {
+    0xB8U, 0xFEU, 0x6CU, 0x39U, 0x23U, 0xA4U, 0x4BU, 0xBEU, 0x7CU, 0x01U, 0x81U,
+    0x2CU, 0xF7U, 0x21U, 0xADU, 0x1CU, 0xDEU, 0xD4U, 0x6DU, 0xE9U, 0x83U, 0x90U,
+    0x97U, 0xDBU, 0x72U, 0x40U, 0xA4U, 0xA4U, 0xB7U, 0xB3U, 0x67U, 0x1FU, 0xCBU,
+    0x79U, 0xE6U, 0x4EU, 0xCCU, 0xC0U, 0xE5U, 0x78U, 0x82U, 0x5AU, 0xD0U, 0x7DU,
+    0xCCU, 0xFFU, 0x72U, 0x21U, 0xB8U, 0x08U, 0x46U, 0x74U, 0xF7U, 0x43U, 0x24U,
+    0x8EU, 0xE0U, 0x35U, 0x90U, 0xE6U, 0x81U, 0x3AU, 0x26U, 0x4CU, 0x3CU, 0x28U,
+    0x52U, 0xBBU, 0x91U, 0xC3U, 0x00U, 0xCBU, 0x88U, 0xD0U, 0x65U, 0x8BU, 0x1BU,
+    0x53U, 0x2EU, 0xA3U, 0x71U, 0x64U, 0x48U, 0x97U, 0xA2U, 0x0DU, 0xF9U, 0x4EU,
+    0x38U, 0x19U, 0xEFU, 0x46U, 0xA9U, 0xDEU, 0xACU, 0xD8U, 0xA8U, 0xFAU, 0x76U,
+    0x3FU, 0xE3U, 0x9CU, 0x34U, 0x3FU, 0xF9U, 0xDCU, 0xBBU, 0xC7U, 0xC7U, 0x0BU,
+    0x4FU, 0x1DU, 0x8AU, 0x51U, 0xE0U, 0x4BU, 0xCDU, 0xB4U, 0x59U, 0x31U, 0xC8U,
+    0x9FU, 0x7EU, 0xC9U, 0xD9U, 0x78U, 0x73U, 0x64U, 0xEAU, 0xC5U, 0xACU, 0x83U,
+    0x34U, 0xD3U, 0xEBU, 0xC3U, 0xC5U, 0x81U, 0xA0U, 0xFFU, 0xFAU, 0x13U, 0x63U,
+    0xEBU, 0x17U, 0x0DU, 0xDDU, 0x51U, 0xB7U, 0xF0U, 0xDAU, 0x49U, 0xD3U, 0x16U,
+    0x55U, 0x26U, 0x29U, 0xD4U, 0x68U, 0x9EU, 0x2BU, 0x16U, 0xBEU, 0x58U, 0x7DU,
+    0x47U, 0xA1U, 0xFCU, 0x8FU, 0xF8U, 0xB8U, 0xD1U, 0x7AU, 0xD0U, 0x31U, 0xCEU,
+    0x45U, 0xCBU, 0x3AU, 0x8FU, 0x95U, 0x16U, 0x04U, 0x28U, 0xAFU, 0xD7U, 0xFBU,
+    0xCAU, 0xBBU, 0x4BU, 0x40U, 0x7EU,
+};
 
 uint32_t db_fold_u64_to_u32(uint64_t value) {
     return (uint32_t)(value ^ (value >> 32U));
@@ -33,6 +156,11 @@ uint64_t db_fnv1a64_mix_u64(uint64_t hash, uint64_t value) {
     return db_fnv1a64_extend(hash, &value, sizeof(value));
 }
 
+uint64_t db_hash_combine_term(uint64_t frame_index, uint64_t hash) {
+    return db_fnv1a64_mix_u64(
+        db_fnv1a64_mix_u64(DB_FNV1A64_OFFSET, frame_index), hash);
+}
+
 uint64_t db_hash_rgba8_pixels_canonical(const uint8_t *pixels, uint32_t width,
                                         uint32_t height, size_t stride_bytes,
                                         int rows_bottom_to_top) {
@@ -53,3 +181,711 @@ uint64_t db_hash_rgba8_pixels_canonical(const uint8_t *pixels, uint32_t width,
     }
     return hash;
 }
+
+int db_hash_algo_parse(const char *name, db_hash_algo_t *out_algo) {
+    if ((name == NULL) || (name[0] == '\0') ||
+        (strcmp(name, DB_HASH_ALGO_NAME_FNV1A) == 0)) {
+        *out_algo = DB_HASH_ALGO_FNV1A;
+        return 1;
+    }
+    if (strcmp(name, DB_HASH_ALGO_NAME_XXH3) == 0) {
+        *out_algo = DB_HASH_ALGO_XXH3;
+        return 1;
+    }
+    if (strcmp(name, DB_HASH_ALGO_NAME_CRC32C) == 0) {
+        *out_algo = DB_HASH_ALGO_CRC32C;
+        return 1;
+    }
+    return 0;
+}
+
+const char *db_hash_algo_name(db_hash_algo_t algo) {
+    if (algo == DB_HASH_ALGO_XXH3) {
+        return DB_HASH_ALGO_NAME_XXH3;
+    }
+    if (algo == DB_HASH_ALGO_CRC32C) {
+        return DB_HASH_ALGO_NAME_CRC32C;
+    }
+    return DB_HASH_ALGO_NAME_FNV1A;
+}
+
+static uint64_t db_read_le64(const uint8_t *bytes) {
+    uint64_t value = 0U;
+    for (uint32_t i = 8U; i > 0U; i--) {
+        value = (value << 8U) | (uint64_t)bytes[i - 1U];
+    }
+    return value;
+}
+
+static uint32_t db_read_le32(const uint8_t *bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8U) |
+           ((uint32_t)bytes[2] << 16U) | ((uint32_t)bytes[3] << 24U);
+}
+
+static uint32_t db_crc32c_extend_table(uint32_t crc, const uint8_t *bytes,
+                                       size_t size) {
+    for (size_t i = 0U; i < size; i++) {
+        crc = g_crc32c_table[(crc ^ bytes[i]) & 0xFFU] ^ (crc >> 8U);
+    }
+    return crc;
+}
+
+#ifdef DB_HASH_X86
+__attribute__((target("sse4.2"))) static uint32_t
+db_crc32c_extend_sse42(uint32_t crc, const uint8_t *bytes, size_t size) {
+    size_t i = 0U;
+#ifdef __x86_64__
+    uint64_t crc64 = crc;
+    for (; (i + 8U) <= size; i += 8U) {
+        uint64_t chunk = 0U;
+        memcpy(&chunk, bytes + i, sizeof(chunk));
+        crc64 = _mm_crc32_u64(crc64, chunk);
+    }
+    crc = (uint32_t)crc64;
+#endif
+    for (; (i + 4U) <= size; i += 4U) {
+        uint32_t chunk = 0U;
+        memcpy(&chunk, bytes + i, sizeof(chunk));
+        crc = _mm_crc32_u32(crc, chunk);
+    }
+    for (; i < size; i++) {
+        crc = _mm_crc32_u8(crc, bytes[i]);
+    }
+    return crc;
+}
+#endif
+
+static int db_hash_has_sse42(void) {
+#ifdef DB_HASH_X86
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2") ? 1 : 0;
+#else
+    return 0;
+#endif
+}
+
+static int db_hash_has_avx2(void) {
+#ifdef DB_HASH_X86
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? 1 : 0;
+#else
+    return 0;
+#endif
+}
+
+uint32_t db_crc32c_extend(uint32_t crc, const void *data, size_t size) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    crc = ~crc;
+#ifdef DB_HASH_X86
+    if (db_hash_has_sse42() != 0) {
+        return ~db_crc32c_extend_sse42(crc, bytes, size);
+    }
+#endif
+    return ~db_crc32c_extend_table(crc, bytes, size);
+}
+
+// XXH3-64 with seed 0 and the default secret, following the reference
+// streaming implementation (stripe = 64 bytes, block = 16 stripes).
+typedef void (*db_xxh3_accumulate_fn)(uint64_t *acc, const uint8_t *input,
+                                      const uint8_t *secret,
+                                      size_t stripe_count);
+typedef void (*db_xxh3_scramble_fn)(uint64_t *acc, const uint8_t *secret);
+
+typedef struct {
+    db_xxh3_accumulate_fn accumulate;
+    db_xxh3_scramble_fn scramble;
+} db_xxh3_kernels_t;
+
+static uint64_t db_xxh3_mul128_fold64(uint64_t lhs, uint64_t rhs) {
+#ifdef __SIZEOF_INT128__
+    const unsigned __int128 product = (unsigned __int128)lhs * rhs;
+    return (uint64_t)product ^ (uint64_t)(product >> 64U);
+#else
+    const uint64_t lo_lo = (lhs & 0xFFFFFFFFU) * (rhs & 0xFFFFFFFFU);
+    const uint64_t hi_lo = (lhs >> 32U) * (rhs & 0xFFFFFFFFU);
+    const uint64_t lo_hi = (lhs & 0xFFFFFFFFU) * (rhs >> 32U);
+    const uint64_t hi_hi = (lhs >> 32U) * (rhs >> 32U);
+    const uint64_t cross = (lo_lo >> 32U) + (hi_lo & 0xFFFFFFFFU) + lo_hi;
+    const uint64_t upper = (hi_lo >> 32U) + (cross >> 32U) + hi_hi;
+    const uint64_t lower = (cross << 32U) | (lo_lo & 0xFFFFFFFFU);
+    return lower ^ upper;
+#endif
+}
+
+static uint64_t db_bswap64(uint64_t value) {
+    uint64_t swapped = 0U;
+    for (uint32_t i = 0U; i < 8U; i++) {
+        swapped = (swapped << 8U) | ((value >> (8U * i)) & 0xFFU);
+    }
+    return swapped;
+}
+
+static uint64_t db_rotl64(uint64_t value, uint32_t amount) {
+    return (value << amount) | (value >> (64U - amount));
+}
+
+static uint64_t db_xxh64_avalanche(uint64_t hash) {
+    hash ^= hash >> 33U;
+    hash *= DB_XXH_PRIME64_2;
+    hash ^= hash >> 29U;
+    hash *= DB_XXH_PRIME64_3;
+    hash ^= hash >> 32U;
+    return hash;
+}
+
+static uint64_t db_xxh3_avalanche(uint64_t hash) {
+    hash ^= hash >> 37U;
+    hash *= DB_XXH3_PRIME_MX1;
+    hash ^= hash >> 32U;
+    return hash;
+}
+
+static uint64_t db_xxh3_rrmxmx(uint64_t hash, uint64_t len) {
+    hash ^= db_rotl64(hash, 49U) ^ db_rotl64(hash, 24U);
+    hash *= DB_XXH3_PRIME_MX2;
+    hash ^= (hash >> 35U) + len;
+    hash *= DB_XXH3_PRIME_MX2;
+    return hash ^ (hash >> 28U);
+}
+
+static uint64_t db_xxh3_mix16(const uint8_t *input, const uint8_t *secret) {
+    return db_xxh3_mul128_fold64(
+        db_read_le64(input) ^ db_read_le64(secret),
+        db_read_le64(input + 8U) ^ db_read_le64(secret + 8U));
+}
+
+static uint64_t db_xxh3_len_0to16(const uint8_t *input, size_t len) {
+    const uint8_t *secret = g_xxh3_secret;
+    if (len > 8U) {
+        const uint64_t lo = db_read_le64(input) ^ (db_read_le64(secret + 24U) ^
+                                                   db_read_le64(secret + 32U));
+        const uint64_t hi =
+            db_read_le64(input + len - 8U) ^
+            (db_read_le64(secret + 40U) ^ db_read_le64(secret + 48U));
+        return db_xxh3_avalanche(len + db_bswap64(lo) + hi +
+                                 db_xxh3_mul128_fold64(lo, hi));
+    }
+    if (len >= 4U) {
+        const uint64_t input64 =
+            (uint64_t)db_read_le32(input + len - 4U) +
+            ((uint64_t)db_read_le32(input) << 32U);
+        const uint64_t bitflip =
+            db_read_le64(secret + 8U) ^ db_read_le64(secret + 16U);
+        return db_xxh3_rrmxmx(input64 ^ bitflip, len);
+    }
+    if (len > 0U) {
+        const uint32_t combined =
+            ((uint32_t)input[0] << 16U) | ((uint32_t)input[len >> 1U] << 24U) |
+            (uint32_t)input[len - 1U] | ((uint32_t)len << 8U);
+        const uint64_t bitflip =
+            (uint64_t)(db_read_le32(secret) ^ db_read_le32(secret + 4U));
+        return db_xxh64_avalanche((uint64_t)combined ^ bitflip);
+    }
+    return db_xxh64_avalanche(db_read_le64(secret + 56U) ^
+                              db_read_le64(secret + 64U));
+}
+
+static uint64_t db_xxh3_len_17to128(const uint8_t *input, size_t len) {
+    const uint8_t *secret = g_xxh3_secret;
+    uint64_t acc = len * DB_XXH_PRIME64_1;
+    if (len > 32U) {
+        if (len > 64U) {
+            if (len > 96U) {
+                acc += db_xxh3_mix16(input + 48U, secret + 96U);
+                acc += db_xxh3_mix16(input + len - 64U, secret + 112U);
+            }
+            acc += db_xxh3_mix16(input + 32U, secret + 64U);
+            acc += db_xxh3_mix16(input + len - 48U, secret + 80U);
+        }
+        acc += db_xxh3_mix16(input + 16U, secret + 32U);
+        acc += db_xxh3_mix16(input + len - 32U, secret + 48U);
+    }
+    acc += db_xxh3_mix16(input, secret);
+    acc += db_xxh3_mix16(input + len - 16U, secret + 16U);
+    return db_xxh3_avalanche(acc);
+}
+
+static uint64_t db_xxh3_len_129to240(const uint8_t *input, size_t len) {
+    const uint8_t *secret = g_xxh3_secret;
+    uint64_t acc = len * DB_XXH_PRIME64_1;
+    const size_t rounds = len / 16U;
+    for (size_t i = 0U; i < 8U; i++) {
+        acc += db_xxh3_mix16(input + (16U * i), secret + (16U * i));
+    }
+    acc = db_xxh3_avalanche(acc);
+    uint64_t acc_end =
+        db_xxh3_mix16(input + len - 16U, secret + DB_XXH3_SECRET_SIZE_MIN -
+                                             DB_XXH3_MIDSIZE_LAST_OFFSET);
+    for (size_t i = 8U; i < rounds; i++) {
+        acc_end +=
+            db_xxh3_mix16(input + (16U * i), secret + (16U * (i - 8U)) +
+                                                 DB_XXH3_MIDSIZE_START_OFFSET);
+    }
+    return db_xxh3_avalanche(acc + acc_end);
+}
+
+static void db_xxh3_accumulate_scalar(uint64_t *acc, const uint8_t *input,
+                                      const uint8_t *secret,
+                                      size_t stripe_count) {
+    for (size_t stripe = 0U; stripe < stripe_count; stripe++) {
+        const uint8_t *stripe_input = input + (stripe * DB_XXH3_STRIPE_LEN);
+        const uint8_t *stripe_secret =
+            secret + (stripe * DB_XXH3_SECRET_CONSUME_RATE);
+        for (uint32_t lane = 0U; lane < DB_XXH3_ACC_LANES; lane++) {
+            const uint64_t data_val = db_read_le64(stripe_input + (lane * 8U));
+            const uint64_t data_key =
+                data_val ^ db_read_le64(stripe_secret + (lane * 8U));
+            acc[lane ^ 1U] += data_val;
+            acc[lane] += (data_key & 0xFFFFFFFFU) * (data_key >> 32U);
+        }
+    }
+}
+
+static void db_xxh3_scramble_scalar(uint64_t *acc, const uint8_t *secret) {
+    for (uint32_t lane = 0U; lane < DB_XXH3_ACC_LANES; lane++) {
+        uint64_t value = acc[lane];
+        value ^= value >> 47U;
+        value ^= db_read_le64(secret + (lane * 8U));
+        value *= DB_XXH_PRIME32_1;
+        acc[lane] = value;
+    }
+}
+
+#ifdef DB_HASH_X86
+__attribute__((target("sse2"))) static void
+db_xxh3_accumulate_sse2(uint64_t *acc, const uint8_t *input,
+                        const uint8_t *secret, size_t stripe_count) {
+    __m128i acc_vec[4];
+    for (uint32_t i = 0U; i < 4U; i++) {
+        acc_vec[i] = _mm_loadu_si128((const __m128i *)(acc + (2U * i)));
+    }
+    for (size_t stripe = 0U; stripe < stripe_count; stripe++) {
+        const uint8_t *stripe_input = input + (stripe * DB_XXH3_STRIPE_LEN);
+        const uint8_t *stripe_secret =
+            secret + (stripe * DB_XXH3_SECRET_CONSUME_RATE);
+        for (uint32_t i = 0U; i < 4U; i++) {
+            const __m128i data =
+                _mm_loadu_si128((const __m128i *)(stripe_input + (16U * i)));
+            const __m128i key =
+                _mm_loadu_si128((const __m128i *)(stripe_secret + (16U * i)));
+            const __m128i data_key = _mm_xor_si128(data, key);
+            const __m128i data_key_hi =
+                _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+            const __m128i product = _mm_mul_epu32(data_key, data_key_hi);
+            const __m128i data_swap =
+                _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            acc_vec[i] =
+                _mm_add_epi64(product, _mm_add_epi64(acc_vec[i], data_swap));
+        }
+    }
+    for (uint32_t i = 0U; i < 4U; i++) {
+        _mm_storeu_si128((__m128i *)(acc + (2U * i)), acc_vec[i]);
+    }
+}
+
+__attribute__((target("sse2"))) static void
+db_xxh3_scramble_sse2(uint64_t *acc, const uint8_t *secret) {
+    const __m128i prime = _mm_set1_epi32((int)DB_XXH_PRIME32_1);
+    for (uint32_t i = 0U; i < 4U; i++) {
+        const __m128i value =
+            _mm_loadu_si128((const __m128i *)(acc + (2U * i)));
+        const __m128i key =
+            _mm_loadu_si128((const __m128i *)(secret + (16U * i)));
+        const __m128i data_key = _mm_xor_si128(
+            _mm_xor_si128(value, _mm_srli_epi64(value, 47)), key);
+        const __m128i data_key_hi =
+            _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+        const __m128i product_lo = _mm_mul_epu32(data_key, prime);
+        const __m128i product_hi = _mm_mul_epu32(data_key_hi, prime);
+        _mm_storeu_si128(
+            (__m128i *)(acc + (2U * i)),
+            _mm_add_epi64(product_lo, _mm_slli_epi64(product_hi, 32)));
+    }
+}
+
+__attribute__((target("avx2"))) static void
+db_xxh3_accumulate_avx2(uint64_t *acc, const uint8_t *input,
+                        const uint8_t *secret, size_t stripe_count) {
+    __m256i acc_vec[2];
+    for (uint32_t i = 0U; i < 2U; i++) {
+        acc_vec[i] = _mm256_loadu_si256((const __m256i *)(acc + (4U * i)));
+    }
+    for (size_t stripe = 0U; stripe < stripe_count; stripe++) {
+        const uint8_t *stripe_input = input + (stripe * DB_XXH3_STRIPE_LEN);
+        const uint8_t *stripe_secret =
+            secret + (stripe * DB_XXH3_SECRET_CONSUME_RATE);
+        for (uint32_t i = 0U; i < 2U; i++) {
+            const __m256i data = _mm256_loadu_si256(
+                (const __m256i *)(stripe_input + (32U * i)));
+            const __m256i key = _mm256_loadu_si256(
+                (const __m256i *)(stripe_secret + (32U * i)));
+            const __m256i data_key = _mm256_xor_si256(data, key);
+            const __m256i data_key_hi =
+                _mm256_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+            const __m256i product = _mm256_mul_epu32(data_key, data_key_hi);
+            const __m256i data_swap =
+                _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            acc_vec[i] = _mm256_add_epi64(
+                product, _mm256_add_epi64(acc_vec[i], data_swap));
+        }
+    }
+    for (uint32_t i = 0U; i < 2U; i++) {
+        _mm256_storeu_si256((__m256i *)(acc + (4U * i)), acc_vec[i]);
+    }
+}
+
+__attribute__((target("avx2"))) static void
+db_xxh3_scramble_avx2(uint64_t *acc, const uint8_t *secret) {
+    const __m256i prime = _mm256_set1_epi32((int)DB_XXH_PRIME32_1);
+    for (uint32_t i = 0U; i < 2U; i++) {
+        const __m256i value =
+            _mm256_loadu_si256((const __m256i *)(acc + (4U * i)));
+        const __m256i key =
+            _mm256_loadu_si256((const __m256i *)(secret + (32U * i)));
+        const __m256i data_key = _mm256_xor_si256(
+            _mm256_xor_si256(value, _mm256_srli_epi64(value, 47)), key);
+        const __m256i data_key_hi =
+            _mm256_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+        const __m256i product_lo = _mm256_mul_epu32(data_key, prime);
+        const __m256i product_hi = _mm256_mul_epu32(data_key_hi, prime);
+        _mm256_storeu_si256(
+            (__m256i *)(acc + (4U * i)),
+            _mm256_add_epi64(product_lo, _mm256_slli_epi64(product_hi, 32)));
+    }
+}
+#endif
+
+static int db_hash_has_sse2(void) {
+#ifdef DB_HASH_X86
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2") ? 1 : 0;
+#else
+    return 0;
+#endif
+}
+
+static db_xxh3_kernels_t db_xxh3_kernels_select(void) {
+#ifdef DB_HASH_X86
+    if (db_hash_has_avx2() != 0) {
+        return (db_xxh3_kernels_t){db_xxh3_accumulate_avx2,
+                                   db_xxh3_scramble_avx2};
+    }
+    if (db_hash_has_sse2() != 0) {
+        return (db_xxh3_kernels_t){db_xxh3_accumulate_sse2,
+                                   db_xxh3_scramble_sse2};
+    }
+#endif
+    return (db_xxh3_kernels_t){db_xxh3_accumulate_scalar,
+                               db_xxh3_scramble_scalar};
+}
+
+const char *db_hash_algo_isa_name(db_hash_algo_t algo) {
+    if (algo == DB_HASH_ALGO_XXH3) {
+        if (db_hash_has_avx2() != 0) {
+            return "avx2";
+        }
+        return (db_hash_has_sse2() != 0) ? "sse2" : "scalar";
+    }
+    if (algo == DB_HASH_ALGO_CRC32C) {
+        return (db_hash_has_sse42() != 0) ? "sse4.2" : "table";
+    }
+    return "scalar";
+}
+
+static const uint8_t *
+db_xxh3_consume_stripes(const db_xxh3_kernels_t *kernels, uint64_t *acc,
+                        size_t *stripes_so_far, const uint8_t *input,
+                        size_t stripe_count) {
+    const uint8_t *secret = g_xxh3_secret;
+    const uint8_t *stripe_secret =
+        secret + (*stripes_so_far * DB_XXH3_SECRET_CONSUME_RATE);
+    size_t stripes_left_in_block = DB_XXH3_STRIPES_PER_BLOCK - *stripes_so_far;
+    while (stripe_count >= stripes_left_in_block) {
+        kernels->accumulate(acc, input, stripe_secret, stripes_left_in_block);
+        kernels->scramble(acc, secret + DB_XXH3_SECRET_LIMIT);
+        input += stripes_left_in_block * DB_XXH3_STRIPE_LEN;
+        stripe_count -= stripes_left_in_block;
+        stripes_left_in_block = DB_XXH3_STRIPES_PER_BLOCK;
+        stripe_secret = secret;
+        *stripes_so_far = 0U;
+    }
+    if (stripe_count > 0U) {
+        kernels->accumulate(acc, input, stripe_secret, stripe_count);
+        input += stripe_count * DB_XXH3_STRIPE_LEN;
+        *stripes_so_far += stripe_count;
+    }
+    return input;
+}
+
+void db_xxh3_init(db_xxh3_state_t *state) {
+    *state = (db_xxh3_state_t){
+        .acc = {DB_XXH_PRIME32_3, DB_XXH_PRIME64_1, DB_XXH_PRIME64_2,
+                DB_XXH_PRIME64_3, DB_XXH_PRIME64_4, DB_XXH_PRIME32_2,
+                DB_XXH_PRIME64_5, DB_XXH_PRIME32_1},
+    };
+}
+
+void db_xxh3_update(db_xxh3_state_t *state, const void *data, size_t size) {
+    if ((data == NULL) || (size == 0U)) {
+        return;
+    }
+    const uint8_t *input = (const uint8_t *)data;
+    const uint8_t *const end = input + size;
+    state->total_len += size;
+    if (size <= (DB_XXH3_BUFFER_BYTES - state->buffered_size)) {
+        memcpy(state->buffer + state->buffered_size, input, size);
+        state->buffered_size += size;
+        return;
+    }
+
+    const db_xxh3_kernels_t kernels = db_xxh3_kernels_select();
+    if (state->buffered_size > 0U) {
+        const size_t load_size = DB_XXH3_BUFFER_BYTES - state->buffered_size;
+        memcpy(state->buffer + state->buffered_size, input, load_size);
+        input += load_size;
+        (void)db_xxh3_consume_stripes(
+            &kernels, state->acc, &state->stripes_so_far, state->buffer,
+            DB_XXH3_BUFFER_BYTES / DB_XXH3_STRIPE_LEN);
+        state->buffered_size = 0U;
+    }
+    // Always keep the final (possibly full) stripe buffered: the digest
+    // treats it specially.
+    if ((size_t)(end - input) > DB_XXH3_BUFFER_BYTES) {
+        const size_t stripe_count =
+            (size_t)(end - 1 - input) / DB_XXH3_STRIPE_LEN;
+        input = db_xxh3_consume_stripes(&kernels, state->acc,
+                                        &state->stripes_so_far, input,
+                                        stripe_count);
+        memcpy(state->buffer + DB_XXH3_BUFFER_BYTES - DB_XXH3_STRIPE_LEN,
+               input - DB_XXH3_STRIPE_LEN, DB_XXH3_STRIPE_LEN);
+    }
+    memcpy(state->buffer, input, (size_t)(end - input));
+    state->buffered_size = (size_t)(end - input);
+}
+
+uint64_t db_xxh3_digest(const db_xxh3_state_t *state) {
+    if (state->total_len <= DB_XXH3_MIDSIZE_MAX) {
+        const size_t len = (size_t)state->total_len;
+        if (len <= 16U) {
+            return db_xxh3_len_0to16(state->buffer, len);
+        }
+        if (len <= 128U) {
+            return db_xxh3_len_17to128(state->buffer, len);
+        }
+        return db_xxh3_len_129to240(state->buffer, len);
+    }
+
+    const db_xxh3_kernels_t kernels = db_xxh3_kernels_select();
+    uint64_t acc[DB_XXH3_ACC_LANES];
+    memcpy(acc, state->acc, sizeof(acc));
+    uint8_t last_stripe[DB_XXH3_STRIPE_LEN];
+    const uint8_t *last_stripe_ptr = NULL;
+    if (state->buffered_size >= DB_XXH3_STRIPE_LEN) {
+        size_t stripes_so_far = state->stripes_so_far;
+        (void)db_xxh3_consume_stripes(
+            &kernels, acc, &stripes_so_far, state->buffer,
+            (state->buffered_size - 1U) / DB_XXH3_STRIPE_LEN);
+        last_stripe_ptr =
+            state->buffer + state->buffered_size - DB_XXH3_STRIPE_LEN;
+    } else {
+        const size_t catchup = DB_XXH3_STRIPE_LEN - state->buffered_size;
+        memcpy(last_stripe, state->buffer + DB_XXH3_BUFFER_BYTES - catchup,
+               catchup);
+        memcpy(last_stripe + catchup, state->buffer, state->buffered_size);
+        last_stripe_ptr = last_stripe;
+    }
+    kernels.accumulate(acc, last_stripe_ptr,
+                       g_xxh3_secret + DB_XXH3_SECRET_LIMIT -
+                           DB_XXH3_SECRET_LASTACC_START,
+                       1U);
+
+    uint64_t result = state->total_len * DB_XXH_PRIME64_1;
+    const uint8_t *merge_secret = g_xxh3_secret + DB_XXH3_SECRET_MERGE_START;
+    for (uint32_t i = 0U; i < 4U; i++) {
+        result += db_xxh3_mul128_fold64(
+            acc[2U * i] ^ db_read_le64(merge_secret + (16U * i)),
+            acc[(2U * i) + 1U] ^ db_read_le64(merge_secret + (16U * i) + 8U));
+    }
+    return db_xxh3_avalanche(result);
+}
+
+uint64_t db_xxh3_64(const void *data, size_t size) {
+    db_xxh3_state_t state;
+    db_xxh3_init(&state);
+    db_xxh3_update(&state, data, size);
+    return db_xxh3_digest(&state);
+}
+
+uint64_t db_hash_rgba8_pixels(db_hash_algo_t algo, const uint8_t *pixels,
+                              uint32_t width, uint32_t height,
+                              size_t stride_bytes, int rows_bottom_to_top) {
+    if (algo == DB_HASH_ALGO_FNV1A) {
+        return db_hash_rgba8_pixels_canonical(pixels, width, height,
+                                              stride_bytes, rows_bottom_to_top);
+    }
+    if ((pixels == NULL) || (width == 0U) || (height == 0U)) {
+        return 0U;
+    }
+    const size_t row_bytes = (size_t)width * 4U;
+    if (stride_bytes < row_bytes) {
+        return 0U;
+    }
+    // Tightly packed top-down frames are one contiguous span.
+    const int contiguous =
+        (stride_bytes == row_bytes) && (rows_bottom_to_top == 0);
+    const uint32_t span_count = (contiguous != 0) ? 1U : height;
+    const size_t span_bytes =
+        (contiguous != 0) ? (row_bytes * (size_t)height) : row_bytes;
+
+    if (algo == DB_HASH_ALGO_CRC32C) {
+        uint32_t crc = 0U;
+        for (uint32_t span = 0U; span < span_count; span++) {
+            const uint32_t src_row =
+                (rows_bottom_to_top != 0) ? (height - 1U - span) : span;
+            crc = db_crc32c_extend(
+                crc, pixels + ((size_t)src_row * stride_bytes), span_bytes);
+        }
+        return (uint64_t)crc;
+    }
+
+    db_xxh3_state_t state;
+    db_xxh3_init(&state);
+    for (uint32_t span = 0U; span < span_count; span++) {
+        const uint32_t src_row =
+            (rows_bottom_to_top != 0) ? (height - 1U - span) : span;
+        db_xxh3_update(&state, pixels + ((size_t)src_row * stride_bytes),
+                       span_bytes);
+    }
+    return db_xxh3_digest(&state);
+}
+
+int db_hash_incremental_parse(const char *name, db_hash_incremental_t *out) {
+    if ((name == NULL) || (name[0] == '\0') ||
+        (strcmp(name, DB_HASH_INCREMENTAL_NAME_OFF) == 0)) {
+        *out = DB_HASH_INCREMENTAL_OFF;
+        return 1;
+    }
+    if (strcmp(name, DB_HASH_INCREMENTAL_NAME_ON) == 0) {
+        *out = DB_HASH_INCREMENTAL_ON;
+        return 1;
+    }
+    if (strcmp(name, DB_HASH_INCREMENTAL_NAME_VALIDATE) == 0) {
+        *out = DB_HASH_INCREMENTAL_VALIDATE;
+        return 1;
+    }
+    return 0;
+}
+
+const char *db_hash_incremental_name(db_hash_incremental_t mode) {
+    switch (mode) {
+    case DB_HASH_INCREMENTAL_ON:
+        return DB_HASH_INCREMENTAL_NAME_ON;
+    case DB_HASH_INCREMENTAL_VALIDATE:
+        return DB_HASH_INCREMENTAL_NAME_VALIDATE;
+    case DB_HASH_INCREMENTAL_OFF:
+    default:
+        return DB_HASH_INCREMENTAL_NAME_OFF;
+    }
+}
+
+static uint64_t db_row_hash_tree_row(const db_row_hash_tree_t *tree,
+                                     const uint8_t *pixels,
+                                     size_t stride_bytes, uint32_t row) {
+    return db_hash_rgba8_pixels(tree->algo,
+                                pixels + ((size_t)row * stride_bytes),
+                                tree->width, 1U, stride_bytes, 0);
+}
+
+static uint64_t db_row_hash_tree_combine(uint64_t left, uint64_t right) {
+    return db_fnv1a64_mix_u64(db_fnv1a64_mix_u64(DB_FNV1A64_OFFSET, left),
+                              right);
+}
+
+static void db_row_hash_tree_resize(db_row_hash_tree_t *tree, uint32_t width,
+                                    uint32_t height) {
+    uint32_t leaf_capacity = 1U;
+    while (leaf_capacity < height) {
+        leaf_capacity <<= 1U;
+    }
+    if (leaf_capacity != tree->leaf_capacity) {
+        free(tree->nodes);
+        tree->nodes = (uint64_t *)db_alloc_array_or_fail(
+            "db_hash", "row_hash_tree.nodes", (size_t)leaf_capacity * 2U,
+            sizeof(uint64_t));
+        tree->leaf_capacity = leaf_capacity;
+    }
+    // Padding leaves stay zero so the tree shape depends only on height.
+    memset(tree->nodes, 0, (size_t)leaf_capacity * 2U * sizeof(uint64_t));
+    tree->width = width;
+    tree->height = height;
+    tree->primed = 1;
+}
+
+void db_row_hash_tree_init(db_row_hash_tree_t *tree, db_hash_algo_t algo) {
+    *tree = (db_row_hash_tree_t){0};
+    tree->algo = algo;
+}
+
+void db_row_hash_tree_refresh(db_row_hash_tree_t *tree, const uint8_t *pixels,
+                              uint32_t width, uint32_t height,
+                              size_t stride_bytes, uint32_t row_start,
+                              uint32_t row_count) {
+    if ((pixels == NULL) || (width == 0U) || (height == 0U) ||
+        (stride_bytes < ((size_t)width * 4U))) {
+        return;
+    }
+    if ((tree->primed == 0) || (tree->width != width) ||
+        (tree->height != height)) {
+        db_row_hash_tree_resize(tree, width, height);
+        row_start = 0U;
+        row_count = height;
+    }
+    if ((row_start >= height) || (row_count == 0U)) {
+        return;
+    }
+    const uint32_t row_end =
+        (row_count > (height - row_start)) ? height : (row_start + row_count);
+    for (uint32_t row = row_start; row < row_end; row++) {
+        tree->nodes[tree->leaf_capacity + row] =
+            db_row_hash_tree_row(tree, pixels, stride_bytes, row);
+    }
+    uint32_t first = tree->leaf_capacity + row_start;
+    uint32_t last = tree->leaf_capacity + row_end - 1U;
+    while (first > 1U) {
+        first >>= 1U;
+        last >>= 1U;
+        for (uint32_t node = first; node <= last; node++) {
+            tree->nodes[node] = db_row_hash_tree_combine(
+                tree->nodes[node * 2U], tree->nodes[(node * 2U) + 1U]);
+        }
+    }
+}
+
+uint64_t db_row_hash_tree_digest(const db_row_hash_tree_t *tree) {
+    if (tree->primed == 0) {
+        return 0U;
+    }
+    uint64_t hash = db_fnv1a64_mix_u64(DB_FNV1A64_OFFSET, tree->width);
+    hash = db_fnv1a64_mix_u64(hash, tree->height);
+    return db_fnv1a64_mix_u64(hash, tree->nodes[1]);
+}
+
+uint32_t db_row_hash_tree_find_stale_row(const db_row_hash_tree_t *tree,
+                                         const uint8_t *pixels,
+                                         size_t stride_bytes) {
+    if ((tree->primed == 0) || (pixels == NULL)) {
+        return UINT32_MAX;
+    }
+    for (uint32_t row = 0U; row < tree->height; row++) {
+        if (tree->nodes[tree->leaf_capacity + row] !=
+            db_row_hash_tree_row(tree, pixels, stride_bytes, row)) {
+            return row;
+        }
+    }
+    return UINT32_MAX;
+}
+
+void db_row_hash_tree_free(db_row_hash_tree_t *tree) {
+    free(tree->nodes);
+    *tree = (db_row_hash_tree_t){0};
+}
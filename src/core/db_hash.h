@@ -16,14 +16,99 @@
 #define DB_U32_SALT_PALETTE 0xA511E9B3U
 #define DB_FNV1A64_OFFSET UINT64_C(1469598103934665603)
 #define DB_FNV1A64_PRIME UINT64_C(1099511628211)
+#define DB_HASH_ALGO_NAME_CRC32C "crc32c"
+#define DB_HASH_ALGO_NAME_FNV1A "fnv1a"
+#define DB_HASH_ALGO_NAME_XXH3 "xxh3"
+#define DB_XXH3_ACC_LANES 8U
+#define DB_XXH3_BUFFER_BYTES 256U
+#define DB_HASH_INCREMENTAL_NAME_OFF "0"
+#define DB_HASH_INCREMENTAL_NAME_ON "1"
+#define DB_HASH_INCREMENTAL_NAME_VALIDATE "validate"
+
+typedef enum {
+    // Byte-serial FNV-1a; the only algorithm the checked-in goldens use.
+    DB_HASH_ALGO_FNV1A = 0,
+    // XXH3-64 (seed 0, default secret), bit-compatible with libxxhash.
+    DB_HASH_ALGO_XXH3 = 1,
+    // CRC-32C (Castagnoli), zero-extended to 64 bits.
+    DB_HASH_ALGO_CRC32C = 2,
+} db_hash_algo_t;
+
+typedef enum {
+    DB_HASH_INCREMENTAL_OFF = 0,
+    // Per-frame output hash is the row-tree digest, refreshed from damage.
+    DB_HASH_INCREMENTAL_ON = 1,
+    // As ON, but also rehashes every row and fails on stale cached rows.
+    DB_HASH_INCREMENTAL_VALIDATE = 2,
+} db_hash_incremental_t;
+
+// Streaming XXH3-64 state; see db_xxh3_init/update/digest.
+typedef struct {
+    uint64_t acc[DB_XXH3_ACC_LANES];
+    uint8_t buffer[DB_XXH3_BUFFER_BYTES];
+    uint64_t total_len;
+    size_t buffered_size;
+    size_t stripes_so_far;
+} db_xxh3_state_t;
 
 uint32_t db_fold_u64_to_u32(uint64_t value);
 uint32_t db_mix_u32(uint32_t value);
 uint64_t db_fnv1a64_extend(uint64_t hash, const void *data, size_t size);
 uint64_t db_fnv1a64_bytes(const void *data, size_t size);
 uint64_t db_fnv1a64_mix_u64(uint64_t hash, uint64_t value);
+// Per-frame term of the combinable aggregate. Unlike the db_fnv1a64_mix_u64
+// chain, the aggregate is the wrapping sum of these terms and each term is
+// keyed by its absolute frame index, so the sums of disjoint frame ranges
+// add up to the sum of the whole run in any order.
+uint64_t db_hash_combine_term(uint64_t frame_index, uint64_t hash);
+int db_hash_algo_parse(const char *name, db_hash_algo_t *out_algo);
+const char *db_hash_algo_name(db_hash_algo_t algo);
+// Name of the instruction set the algorithm runs on for this host.
+const char *db_hash_algo_isa_name(db_hash_algo_t algo);
+
+// Standard CRC-32C: db_crc32c_extend(0U, "123456789", 9) == 0xE3069283.
+uint32_t db_crc32c_extend(uint32_t crc, const void *data, size_t size);
+void db_xxh3_init(db_xxh3_state_t *state);
+void db_xxh3_update(db_xxh3_state_t *state, const void *data, size_t size);
+uint64_t db_xxh3_digest(const db_xxh3_state_t *state);
+uint64_t db_xxh3_64(const void *data, size_t size);
+
+uint64_t db_hash_rgba8_pixels(db_hash_algo_t algo, const uint8_t *pixels,
+                              uint32_t width, uint32_t height,
+                              size_t stride_bytes, int rows_bottom_to_top);
 uint64_t db_hash_rgba8_pixels_canonical(const uint8_t *pixels, uint32_t width,
                                         uint32_t height, size_t stride_bytes,
                                         int rows_bottom_to_top);
 
+// Caches one hash per framebuffer row and folds them through a fixed-shape
+// binary tree (leaves padded to a power of two), so the digest depends only
+// on pixel contents while an update costs O(dirty rows + log rows).
+typedef struct {
+    uint64_t *nodes; // nodes[1] is the root; leaves start at leaf_capacity.
+    uint32_t leaf_capacity;
+    uint32_t width;
+    uint32_t height;
+    db_hash_algo_t algo;
+    int primed;
+} db_row_hash_tree_t;
+
+int db_hash_incremental_parse(const char *name, db_hash_incremental_t *out);
+const char *db_hash_incremental_name(db_hash_incremental_t mode);
+
+void db_row_hash_tree_init(db_row_hash_tree_t *tree, db_hash_algo_t algo);
+// Rehashes rows [row_start, row_start + row_count) and their tree
+// ancestors. The first call, or one with a new width/height, rehashes every
+// row instead; rows outside the range must be unchanged since the last call.
+void db_row_hash_tree_refresh(db_row_hash_tree_t *tree, const uint8_t *pixels,
+                              uint32_t width, uint32_t height,
+                              size_t stride_bytes, uint32_t row_start,
+                              uint32_t row_count);
+uint64_t db_row_hash_tree_digest(const db_row_hash_tree_t *tree);
+// Returns the first row whose cached hash no longer matches pixels, or
+// UINT32_MAX when every cached row is current.
+uint32_t db_row_hash_tree_find_stale_row(const db_row_hash_tree_t *tree,
+                                         const uint8_t *pixels,
+                                         size_t stride_bytes);
+void db_row_hash_tree_free(db_row_hash_tree_t *tree);
+
 #endif
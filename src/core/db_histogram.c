@@ -0,0 +1,80 @@
+#include "db_histogram.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#define DB_HISTOGRAM_MAX_VALUE                                                 \
+    ((UINT64_C(1) << (DB_HISTOGRAM_MAX_EXPONENT + 1U)) - 1U)
+
+static uint32_t db_histogram_bucket_index(uint64_t value) {
+    if (value < DB_HISTOGRAM_SUB_BUCKETS) {
+        return (uint32_t)value;
+    }
+    if (value > DB_HISTOGRAM_MAX_VALUE) {
+        value = DB_HISTOGRAM_MAX_VALUE;
+    }
+    uint32_t exponent = DB_HISTOGRAM_SUB_BUCKET_BITS;
+    while ((value >> (exponent + 1U)) != 0U) {
+        exponent++;
+    }
+    const uint32_t shift = exponent - DB_HISTOGRAM_SUB_BUCKET_BITS;
+    const uint32_t sub_bucket =
+        (uint32_t)(value >> shift) - DB_HISTOGRAM_SUB_BUCKETS;
+    return ((shift + 1U) * DB_HISTOGRAM_SUB_BUCKETS) + sub_bucket;
+}
+
+static uint64_t db_histogram_bucket_upper(uint32_t index) {
+    if (index < DB_HISTOGRAM_SUB_BUCKETS) {
+        return index;
+    }
+    const uint32_t shift = (index / DB_HISTOGRAM_SUB_BUCKETS) - 1U;
+    const uint64_t sub_bucket = index % DB_HISTOGRAM_SUB_BUCKETS;
+    const uint64_t lower = (DB_HISTOGRAM_SUB_BUCKETS + sub_bucket) << shift;
+    return lower + ((UINT64_C(1) << shift) - 1U);
+}
+
+void db_histogram_reset(db_histogram_t *histogram) {
+    memset(histogram, 0, sizeof(*histogram));
+    histogram->min_value = UINT64_MAX;
+}
+
+void db_histogram_record(db_histogram_t *histogram, uint64_t value) {
+    histogram->counts[db_histogram_bucket_index(value)]++;
+    histogram->total_count++;
+    if (value < histogram->min_value) {
+        histogram->min_value = value;
+    }
+    if (value > histogram->max_value) {
+        histogram->max_value = value;
+    }
+}
+
+uint64_t db_histogram_percentile(const db_histogram_t *histogram,
+                                 double percentile) {
+    if (histogram->total_count == 0U) {
+        return 0U;
+    }
+    double rank_d = ceil((percentile / 100.0) * (double)histogram->total_count);
+    if (rank_d < 1.0) {
+        rank_d = 1.0;
+    }
+    const uint64_t rank = (rank_d >= (double)histogram->total_count)
+                              ? histogram->total_count
+                              : (uint64_t)rank_d;
+    uint64_t seen = 0U;
+    for (uint32_t i = 0U; i < DB_HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->counts[i];
+        if (seen >= rank) {
+            uint64_t value = db_histogram_bucket_upper(i);
+            if (value < histogram->min_value) {
+                value = histogram->min_value;
+            }
+            if (value > histogram->max_value) {
+                value = histogram->max_value;
+            }
+            return value;
+        }
+    }
+    return histogram->max_value;
+}
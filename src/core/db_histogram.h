@@ -0,0 +1,30 @@
+#ifndef DRIVERBENCH_DB_HISTOGRAM_H
+#define DRIVERBENCH_DB_HISTOGRAM_H
+
+#include <stdint.h>
+
+// Log-linear (HDR-style) buckets: values below 2^SUB_BUCKET_BITS are exact,
+// larger ones keep SUB_BUCKET_BITS bits below the leading one, i.e. about
+// 3% relative precision, up to 2^(MAX_EXPONENT + 1) ns (~36 minutes).
+#define DB_HISTOGRAM_SUB_BUCKET_BITS 5U
+#define DB_HISTOGRAM_SUB_BUCKETS (1U << DB_HISTOGRAM_SUB_BUCKET_BITS)
+#define DB_HISTOGRAM_MAX_EXPONENT 40U
+#define DB_HISTOGRAM_BUCKETS                                                   \
+    ((DB_HISTOGRAM_MAX_EXPONENT - DB_HISTOGRAM_SUB_BUCKET_BITS + 2U) *         \
+     DB_HISTOGRAM_SUB_BUCKETS)
+
+typedef struct {
+    uint64_t counts[DB_HISTOGRAM_BUCKETS];
+    uint64_t total_count;
+    uint64_t min_value;
+    uint64_t max_value;
+} db_histogram_t;
+
+void db_histogram_reset(db_histogram_t *histogram);
+void db_histogram_record(db_histogram_t *histogram, uint64_t value);
+// Upper bound of the bucket holding the percentile-th smallest value,
+// clamped to the exact min/max. Returns 0 when empty.
+uint64_t db_histogram_percentile(const db_histogram_t *histogram,
+                                 double percentile);
+
+#endif
@@ -0,0 +1,320 @@
+#define _GNU_SOURCE // NOLINT(bugprone-reserved-identifier)
+
+#include "db_mem.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include "db_core.h"
+
+#define BACKEND_NAME "db_mem"
+#define DB_MEM_HEADER_BYTES 64U
+#define DB_MEM_HUGEPAGE_BYTES (2U * 1024U * 1024U)
+#define DB_MEM_NUMA_CPULIST_PATH_FMT "/sys/devices/system/node/node%u/cpulist"
+#define DB_MEM_NUMA_CPULIST_TEXT_LEN 4096U
+
+typedef enum {
+    DB_MEM_BACKING_MALLOC = 0,
+    DB_MEM_BACKING_MMAP = 1,
+} db_mem_backing_t;
+
+// Stored DB_MEM_HEADER_BYTES before every returned pointer, which keeps the
+// payload cache-line aligned.
+typedef struct {
+    void *base;
+    size_t mapping_bytes;
+    db_mem_backing_t backing;
+} db_mem_header_t;
+
+_Static_assert(sizeof(db_mem_header_t) <= DB_MEM_HEADER_BYTES,
+               "db_mem_header_t must fit in DB_MEM_HEADER_BYTES");
+
+static struct {
+    struct rusage start_usage;
+    int dtlb_fd;
+    int active;
+} g_mem_stats = {.dtlb_fd = -1};
+
+static size_t db_mem_round_up(size_t value, size_t alignment) {
+    return ((value + alignment - 1U) / alignment) * alignment;
+}
+
+int db_mem_policy_parse(const char *text, db_mem_policy_t *out_policy) {
+    if ((text == NULL) || (text[0] == '\0') ||
+        (strcmp(text, DB_MEM_POLICY_NAME_DEFAULT) == 0)) {
+        *out_policy = (db_mem_policy_t){DB_MEM_POLICY_DEFAULT, 0U};
+        return 1;
+    }
+    if (strcmp(text, DB_MEM_POLICY_NAME_HUGEPAGE) == 0) {
+        *out_policy = (db_mem_policy_t){DB_MEM_POLICY_HUGEPAGE, 0U};
+        return 1;
+    }
+    const size_t prefix_len = strlen(DB_MEM_POLICY_NUMA_PREFIX);
+    if (strncmp(text, DB_MEM_POLICY_NUMA_PREFIX, prefix_len) != 0) {
+        return 0;
+    }
+    const char *node_text = text + prefix_len;
+    char *end = NULL;
+    const unsigned long node = strtoul(node_text, &end, 10);
+    if ((end == node_text) || (end == NULL) || (*end != '\0') ||
+        (node > UINT16_MAX)) {
+        return 0;
+    }
+    *out_policy = (db_mem_policy_t){DB_MEM_POLICY_NUMA, (uint32_t)node};
+    return 1;
+}
+
+void db_mem_policy_format(const db_mem_policy_t *policy, char *buffer,
+                          size_t buffer_size) {
+    if (policy->kind == DB_MEM_POLICY_HUGEPAGE) {
+        (void)db_snprintf(buffer, buffer_size, "%s",
+                          DB_MEM_POLICY_NAME_HUGEPAGE);
+    } else if (policy->kind == DB_MEM_POLICY_NUMA) {
+        (void)db_snprintf(buffer, buffer_size, "%s%u",
+                          DB_MEM_POLICY_NUMA_PREFIX, policy->numa_node);
+    } else {
+        (void)db_snprintf(buffer, buffer_size, "%s",
+                          DB_MEM_POLICY_NAME_DEFAULT);
+    }
+}
+
+static void *db_mem_finish_mapping(void *base, size_t mapping_bytes,
+                                   size_t payload_alignment) {
+    const uintptr_t first = (uintptr_t)base + DB_MEM_HEADER_BYTES;
+    const uintptr_t payload =
+        (uintptr_t)db_mem_round_up((size_t)first, payload_alignment);
+    db_mem_header_t *header =
+        (db_mem_header_t *)(payload - DB_MEM_HEADER_BYTES);
+    header->base = base;
+    header->mapping_bytes = mapping_bytes;
+    header->backing = DB_MEM_BACKING_MMAP;
+    return (void *)payload;
+}
+
+static void *db_mem_map_hugepage(size_t payload_bytes) {
+#ifdef MAP_HUGETLB
+    const size_t hugetlb_bytes = db_mem_round_up(
+        payload_bytes + DB_MEM_HEADER_BYTES, DB_MEM_HUGEPAGE_BYTES);
+    void *base = mmap(NULL, hugetlb_bytes, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (base != MAP_FAILED) {
+        return db_mem_finish_mapping(base, hugetlb_bytes, DB_MEM_HEADER_BYTES);
+    }
+#endif
+    // No reserved hugetlbfs pages: over-allocate so the payload can start on
+    // a 2 MiB boundary and ask for transparent huge pages instead.
+    const size_t mapping_bytes =
+        payload_bytes + DB_MEM_HEADER_BYTES + DB_MEM_HUGEPAGE_BYTES;
+    void *thp_base = mmap(NULL, mapping_bytes, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (thp_base == MAP_FAILED) {
+        return NULL;
+    }
+    void *payload = db_mem_finish_mapping(thp_base, mapping_bytes,
+                                          DB_MEM_HUGEPAGE_BYTES);
+#ifdef MADV_HUGEPAGE
+    // Rounding the payload up to a whole huge page can run past the end of
+    // the mapping, which madvise rejects with ENOMEM.
+    const size_t mapping_tail =
+        (size_t)(((uintptr_t)thp_base + mapping_bytes) - (uintptr_t)payload);
+    size_t advise_bytes =
+        db_mem_round_up(payload_bytes, DB_MEM_HUGEPAGE_BYTES);
+    if (advise_bytes > mapping_tail) {
+        advise_bytes = mapping_tail;
+    }
+    (void)madvise(payload, advise_bytes, MADV_HUGEPAGE);
+#endif
+    return payload;
+}
+
+static void *db_mem_map_untouched(size_t payload_bytes) {
+    const size_t page_bytes = (size_t)sysconf(_SC_PAGESIZE);
+    const size_t mapping_bytes =
+        db_mem_round_up(payload_bytes + DB_MEM_HEADER_BYTES, page_bytes);
+    void *base = mmap(NULL, mapping_bytes, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+    return db_mem_finish_mapping(base, mapping_bytes, DB_MEM_HEADER_BYTES);
+}
+
+void *db_mem_alloc_or_fail(const char *backend, const char *field_name,
+                           size_t element_count, size_t element_size,
+                           const db_mem_policy_t *policy) {
+    if (element_size == 0U) {
+        db_failf(backend, "%s element_size is zero", field_name);
+    }
+    if (element_count >
+        ((SIZE_MAX - DB_MEM_HEADER_BYTES - DB_MEM_HUGEPAGE_BYTES) /
+         element_size)) {
+        db_failf(backend, "%s allocation overflow (%zu * %zu)", field_name,
+                 element_count, element_size);
+    }
+    const size_t payload_bytes = element_count * element_size;
+    const db_mem_policy_kind_t kind =
+        (policy != NULL) ? policy->kind : DB_MEM_POLICY_DEFAULT;
+
+    void *payload = NULL;
+    if (kind == DB_MEM_POLICY_HUGEPAGE) {
+        payload = db_mem_map_hugepage(payload_bytes);
+    } else if (kind == DB_MEM_POLICY_NUMA) {
+        payload = db_mem_map_untouched(payload_bytes);
+    } else {
+        uint8_t *base = (uint8_t *)malloc(payload_bytes + DB_MEM_HEADER_BYTES);
+        if (base != NULL) {
+            db_mem_header_t *header = (db_mem_header_t *)base;
+            header->base = base;
+            header->mapping_bytes = 0U;
+            header->backing = DB_MEM_BACKING_MALLOC;
+            payload = base + DB_MEM_HEADER_BYTES;
+        }
+    }
+    if (payload == NULL) {
+        db_failf(backend, "failed to allocate %s (%zu * %zu)", field_name,
+                 element_count, element_size);
+    }
+    return payload;
+}
+
+void db_mem_free(void *memory) {
+    if (memory == NULL) {
+        return;
+    }
+    const db_mem_header_t *header =
+        (const db_mem_header_t *)((uint8_t *)memory - DB_MEM_HEADER_BYTES);
+    if (header->backing == DB_MEM_BACKING_MMAP) {
+        (void)munmap(header->base, header->mapping_bytes);
+        return;
+    }
+    free(header->base);
+}
+
+static size_t db_mem_parse_cpulist(const char *text, uint32_t *out_cpus,
+                                   size_t capacity) {
+    size_t count = 0U;
+    const char *cursor = text;
+    while ((*cursor != '\0') && (*cursor != '\n')) {
+        char *end = NULL;
+        const unsigned long first = strtoul(cursor, &end, 10);
+        if (end == cursor) {
+            return 0U;
+        }
+        unsigned long last = first;
+        cursor = end;
+        if (*cursor == '-') {
+            const char *range_text = cursor + 1;
+            last = strtoul(range_text, &end, 10);
+            if ((end == range_text) || (last < first)) {
+                return 0U;
+            }
+            cursor = end;
+        }
+        for (unsigned long cpu = first; (cpu <= last) && (count < capacity);
+             cpu++) {
+            out_cpus[count++] = (uint32_t)cpu;
+        }
+        if (*cursor == ',') {
+            cursor++;
+        }
+    }
+    return count;
+}
+
+size_t db_mem_numa_node_cpus(const char *backend, uint32_t node,
+                             uint32_t *out_cpus, size_t capacity) {
+    char path[128];
+    (void)db_snprintf(path, sizeof(path), DB_MEM_NUMA_CPULIST_PATH_FMT, node);
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        db_failf(backend, "NUMA node %u not found (%s)", node, path);
+    }
+    char text[DB_MEM_NUMA_CPULIST_TEXT_LEN] = {0};
+    const size_t read_bytes = fread(text, 1U, sizeof(text) - 1U, file);
+    (void)fclose(file);
+    text[read_bytes] = '\0';
+    const size_t count = db_mem_parse_cpulist(text, out_cpus, capacity);
+    if (count == 0U) {
+        db_failf(backend, "NUMA node %u has no usable CPUs", node);
+    }
+    return count;
+}
+
+#ifdef __linux__
+static int db_mem_open_dtlb_counter(void) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = (uint64_t)PERF_COUNT_HW_CACHE_DTLB |
+                  ((uint64_t)PERF_COUNT_HW_CACHE_OP_READ << 8U) |
+                  ((uint64_t)PERF_COUNT_HW_CACHE_RESULT_MISS << 16U);
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0UL);
+    if (fd < 0) {
+        return -1;
+    }
+    (void)ioctl((int)fd, PERF_EVENT_IOC_RESET, 0);
+    (void)ioctl((int)fd, PERF_EVENT_IOC_ENABLE, 0);
+    return (int)fd;
+}
+#endif
+
+void db_mem_stats_begin(const char *backend) {
+    db_mem_stats_end();
+    (void)getrusage(RUSAGE_SELF, &g_mem_stats.start_usage);
+    g_mem_stats.dtlb_fd = -1;
+#ifdef __linux__
+    g_mem_stats.dtlb_fd = db_mem_open_dtlb_counter();
+#endif
+    if (g_mem_stats.dtlb_fd < 0) {
+        db_infof(backend, "dTLB miss counter unavailable "
+                          "(perf_event_open denied or unsupported)");
+    }
+    g_mem_stats.active = 1;
+}
+
+void db_mem_stats_sample(db_mem_stats_t *out_stats) {
+    *out_stats = (db_mem_stats_t){0};
+    if (g_mem_stats.active == 0) {
+        return;
+    }
+    struct rusage usage;
+    (void)getrusage(RUSAGE_SELF, &usage);
+    out_stats->minor_faults = (uint64_t)(usage.ru_minflt -
+                                         g_mem_stats.start_usage.ru_minflt);
+    out_stats->major_faults = (uint64_t)(usage.ru_majflt -
+                                         g_mem_stats.start_usage.ru_majflt);
+    if (g_mem_stats.dtlb_fd >= 0) {
+        uint64_t value = 0U;
+        if (read(g_mem_stats.dtlb_fd, &value, sizeof(value)) ==
+            (ssize_t)sizeof(value)) {
+            out_stats->dtlb_misses = value;
+            out_stats->dtlb_available = 1;
+        }
+    }
+}
+
+void db_mem_stats_end(void) {
+    if (g_mem_stats.dtlb_fd >= 0) {
+        (void)close(g_mem_stats.dtlb_fd);
+    }
+    g_mem_stats.dtlb_fd = -1;
+    g_mem_stats.active = 0;
+}
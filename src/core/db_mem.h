@@ -0,0 +1,55 @@
+#ifndef DRIVERBENCH_DB_MEM_H
+#define DRIVERBENCH_DB_MEM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DB_MEM_NUMA_MAX_CPUS 1024U
+#define DB_MEM_POLICY_NAME_DEFAULT "default"
+#define DB_MEM_POLICY_NAME_HUGEPAGE "hugepage"
+#define DB_MEM_POLICY_NUMA_PREFIX "numa="
+
+typedef enum {
+    DB_MEM_POLICY_DEFAULT = 0,
+    // mmap + MAP_HUGETLB, falling back to madvise(MADV_HUGEPAGE).
+    DB_MEM_POLICY_HUGEPAGE = 1,
+    // Untouched mmap pages; callers first-touch them from threads pinned to
+    // numa_node so the kernel places them there.
+    DB_MEM_POLICY_NUMA = 2,
+} db_mem_policy_kind_t;
+
+typedef struct {
+    db_mem_policy_kind_t kind;
+    uint32_t numa_node;
+} db_mem_policy_t;
+
+typedef struct {
+    uint64_t minor_faults;
+    uint64_t major_faults;
+    uint64_t dtlb_misses;
+    int dtlb_available;
+} db_mem_stats_t;
+
+int db_mem_policy_parse(const char *text, db_mem_policy_t *out_policy);
+// Writes the canonical text for policy (e.g. "numa=1") into buffer.
+void db_mem_policy_format(const db_mem_policy_t *policy, char *buffer,
+                          size_t buffer_size);
+
+// Buffers from db_mem_alloc_or_fail must be released with db_mem_free.
+void *db_mem_alloc_or_fail(const char *backend, const char *field_name,
+                           size_t element_count, size_t element_size,
+                           const db_mem_policy_t *policy);
+void db_mem_free(void *memory);
+
+// Fills out_cpus with the CPU ids of a NUMA node; fails if it is absent.
+size_t db_mem_numa_node_cpus(const char *backend, uint32_t node,
+                             uint32_t *out_cpus, size_t capacity);
+
+// Page-fault and dTLB-miss counters for the whole process. Call
+// db_mem_stats_begin before spawning worker threads so the perf counter
+// is inherited by them.
+void db_mem_stats_begin(const char *backend);
+void db_mem_stats_sample(db_mem_stats_t *out_stats);
+void db_mem_stats_end(void);
+
+#endif
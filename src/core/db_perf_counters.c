@@ -0,0 +1,411 @@
+#define _GNU_SOURCE // NOLINT(bugprone-reserved-identifier)
+
+#include "db_perf_counters.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "db_core.h"
+
+#define BACKEND_NAME "db_perf_counters"
+#define DB_PERF_NAME_BYTES 32U
+#define DB_PERF_VALUE_TEXT_BYTES 32U
+// No phase is active between frame_end and the next mark.
+#define DB_PERF_PHASE_NONE DB_PERF_PHASE_COUNT
+
+typedef struct {
+    int fds[DB_PERF_EVENT_COUNT];
+    // Event held at each position of the group read.
+    db_perf_event_t order[DB_PERF_EVENT_COUNT];
+    uint32_t count;
+    uint64_t last_values[DB_PERF_EVENT_COUNT];
+    uint64_t last_enabled_ns;
+    uint64_t last_running_ns;
+    int open;
+} db_perf_group_t;
+
+static const char *const g_perf_event_names[DB_PERF_EVENT_COUNT] = {
+    "cycles", "instructions", "cache-misses", "branch-misses", "page-faults",
+};
+
+// Log keys use underscores like the rest of the benchmark lines.
+static const char *const g_perf_event_log_keys[DB_PERF_EVENT_COUNT] = {
+    "cycles", "instructions", "cache_misses", "branch_misses", "page_faults",
+};
+
+static const char *const g_perf_phase_names[DB_PERF_PHASE_COUNT] = {
+    "render",
+    "hash",
+    "present",
+};
+
+static struct {
+    pthread_mutex_t mutex;
+    uint32_t event_mask;
+    db_perf_group_t groups[DB_PERF_COUNTERS_MAX_THREADS];
+    uint32_t phase;
+    uint64_t frame[DB_PERF_PHASE_COUNT][DB_PERF_EVENT_COUNT];
+    db_perf_counters_summary_t summary;
+} g_perf = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .phase = DB_PERF_PHASE_NONE,
+};
+
+const char *db_perf_event_name(db_perf_event_t event) {
+    return ((uint32_t)event < DB_PERF_EVENT_COUNT) ? g_perf_event_names[event]
+                                                   : "unknown";
+}
+
+const char *db_perf_phase_name(db_perf_phase_t phase) {
+    return ((uint32_t)phase < DB_PERF_PHASE_COUNT) ? g_perf_phase_names[phase]
+                                                   : "unknown";
+}
+
+int db_perf_counters_parse(const char *text, uint32_t *out_mask) {
+    if ((text == NULL) || (out_mask == NULL) || (text[0] == '\0')) {
+        return 0;
+    }
+    uint32_t mask = 0U;
+    const char *cursor = text;
+    for (;;) {
+        const char *comma = strchr(cursor, ',');
+        const size_t len =
+            (comma != NULL) ? (size_t)(comma - cursor) : strlen(cursor);
+        char name[DB_PERF_NAME_BYTES];
+        if ((len == 0U) || (len >= sizeof(name))) {
+            return 0;
+        }
+        memcpy(name, cursor, len);
+        name[len] = '\0';
+        uint32_t event = 0U;
+        while ((event < DB_PERF_EVENT_COUNT) &&
+               (strcmp(name, g_perf_event_names[event]) != 0)) {
+            event++;
+        }
+        if (event == DB_PERF_EVENT_COUNT) {
+            return 0;
+        }
+        mask |= 1U << event;
+        if (comma == NULL) {
+            break;
+        }
+        cursor = comma + 1;
+    }
+    *out_mask = mask;
+    return 1;
+}
+
+#ifdef __linux__
+static int db_perf_event_open(db_perf_event_t event, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    switch (event) {
+    case DB_PERF_EVENT_CYCLES:
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case DB_PERF_EVENT_INSTRUCTIONS:
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case DB_PERF_EVENT_CACHE_MISSES:
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    case DB_PERF_EVENT_BRANCH_MISSES:
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    case DB_PERF_EVENT_PAGE_FAULTS:
+    default:
+        attr.type = PERF_TYPE_SOFTWARE;
+        attr.config = PERF_COUNT_SW_PAGE_FAULTS;
+        break;
+    }
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // Only the leader starts disabled; enabling it starts the whole group.
+    attr.disabled = (group_fd < 0) ? 1 : 0;
+    // User-space only, so perf_event_paranoid <= 2 is enough.
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    const long fd =
+        syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0UL);
+    return (fd < 0) ? -1 : (int)fd;
+}
+
+// Reads the group and charges the scaled deltas to `phase` (or drops them
+// for DB_PERF_PHASE_NONE).
+static void db_perf_group_sample(db_perf_group_t *group, uint32_t phase) {
+    uint64_t buffer[3U + DB_PERF_EVENT_COUNT];
+    const ssize_t expected =
+        (ssize_t)((3U + group->count) * sizeof(buffer[0]));
+    if (read(group->fds[0], buffer, sizeof(buffer)) != expected) {
+        return;
+    }
+    const uint64_t enabled_ns = buffer[1];
+    const uint64_t running_ns = buffer[2];
+    const uint64_t delta_enabled = enabled_ns - group->last_enabled_ns;
+    const uint64_t delta_running = running_ns - group->last_running_ns;
+    group->last_enabled_ns = enabled_ns;
+    group->last_running_ns = running_ns;
+    for (uint32_t i = 0U; i < group->count; i++) {
+        uint64_t delta = buffer[3U + i] - group->last_values[i];
+        group->last_values[i] = buffer[3U + i];
+        if ((delta_running > 0U) && (delta_running < delta_enabled)) {
+            // The group was multiplexed out for part of the interval.
+            delta = (uint64_t)((double)delta * (double)delta_enabled /
+                               (double)delta_running);
+        }
+        if (phase != DB_PERF_PHASE_NONE) {
+            g_perf.frame[phase][group->order[i]] += delta;
+        }
+    }
+}
+
+static void db_perf_group_close(db_perf_group_t *group) {
+    for (uint32_t i = 0U; i < group->count; i++) {
+        (void)close(group->fds[i]);
+    }
+    memset(group, 0, sizeof(*group));
+}
+#endif
+
+void db_perf_counters_configure(uint32_t event_mask) {
+    g_perf.event_mask = 0U;
+    if (event_mask == 0U) {
+        return;
+    }
+#ifdef __linux__
+    // Probe every event once so unsupported ones (common in VMs) are
+    // dropped up front instead of per thread.
+    for (uint32_t event = 0U; event < DB_PERF_EVENT_COUNT; event++) {
+        if ((event_mask & (1U << event)) == 0U) {
+            continue;
+        }
+        const int fd = db_perf_event_open((db_perf_event_t)event, -1);
+        if (fd < 0) {
+            db_infof(BACKEND_NAME, "perf counter %s unavailable: %s",
+                     g_perf_event_names[event], strerror(errno));
+            continue;
+        }
+        (void)close(fd);
+        g_perf.event_mask |= 1U << event;
+    }
+    if (g_perf.event_mask == 0U) {
+        db_failf(BACKEND_NAME,
+                 "none of the requested perf counters could be opened "
+                 "(check /proc/sys/kernel/perf_event_paranoid)");
+    }
+#else
+    db_failf(BACKEND_NAME, "perf counters are only supported on Linux");
+#endif
+}
+
+int db_perf_counters_enabled(void) { return g_perf.event_mask != 0U; }
+
+void db_perf_counters_attach_thread(uint32_t slot) {
+    if ((g_perf.event_mask == 0U) || (slot >= DB_PERF_COUNTERS_MAX_THREADS)) {
+        return;
+    }
+#ifdef __linux__
+    (void)pthread_mutex_lock(&g_perf.mutex);
+    db_perf_group_t *group = &g_perf.groups[slot];
+    if (group->open == 0) {
+        for (uint32_t event = 0U; event < DB_PERF_EVENT_COUNT; event++) {
+            if ((g_perf.event_mask & (1U << event)) == 0U) {
+                continue;
+            }
+            const int fd = db_perf_event_open(
+                (db_perf_event_t)event,
+                (group->count > 0U) ? group->fds[0] : -1);
+            if (fd < 0) {
+                db_failf(BACKEND_NAME,
+                         "failed to open perf counter %s for thread %u: %s",
+                         g_perf_event_names[event], slot, strerror(errno));
+            }
+            group->fds[group->count] = fd;
+            group->order[group->count] = (db_perf_event_t)event;
+            group->count++;
+        }
+        (void)ioctl(group->fds[0], PERF_EVENT_IOC_RESET,
+                    PERF_IOC_FLAG_GROUP);
+        (void)ioctl(group->fds[0], PERF_EVENT_IOC_ENABLE,
+                    PERF_IOC_FLAG_GROUP);
+        group->open = 1;
+    }
+    // Re-attaching only restarts the deltas from here.
+    db_perf_group_sample(group, DB_PERF_PHASE_NONE);
+    (void)pthread_mutex_unlock(&g_perf.mutex);
+#endif
+}
+
+void db_perf_counters_detach_thread(uint32_t slot) {
+    if ((g_perf.event_mask == 0U) || (slot >= DB_PERF_COUNTERS_MAX_THREADS)) {
+        return;
+    }
+#ifdef __linux__
+    (void)pthread_mutex_lock(&g_perf.mutex);
+    if (g_perf.groups[slot].open != 0) {
+        db_perf_group_close(&g_perf.groups[slot]);
+    }
+    (void)pthread_mutex_unlock(&g_perf.mutex);
+#endif
+}
+
+void db_perf_counters_begin(void) {
+    if (g_perf.event_mask == 0U) {
+        return;
+    }
+    memset(&g_perf.summary, 0, sizeof(g_perf.summary));
+    memset(g_perf.frame, 0, sizeof(g_perf.frame));
+    g_perf.summary.event_mask = g_perf.event_mask;
+    g_perf.phase = DB_PERF_PHASE_NONE;
+    db_perf_counters_attach_thread(0U);
+}
+
+static void db_perf_counters_sample_all(void) {
+#ifdef __linux__
+    (void)pthread_mutex_lock(&g_perf.mutex);
+    uint32_t thread_count = 0U;
+    for (uint32_t slot = 0U; slot < DB_PERF_COUNTERS_MAX_THREADS; slot++) {
+        if (g_perf.groups[slot].open != 0) {
+            db_perf_group_sample(&g_perf.groups[slot], g_perf.phase);
+            thread_count++;
+        }
+    }
+    (void)pthread_mutex_unlock(&g_perf.mutex);
+    if (thread_count > g_perf.summary.thread_count) {
+        g_perf.summary.thread_count = thread_count;
+    }
+#endif
+}
+
+void db_perf_counters_phase(db_perf_phase_t phase) {
+    if (g_perf.event_mask == 0U) {
+        return;
+    }
+    db_perf_counters_sample_all();
+    g_perf.phase = (uint32_t)phase;
+}
+
+void db_perf_counters_frame_end(int keep) {
+    if (g_perf.event_mask == 0U) {
+        return;
+    }
+    db_perf_counters_sample_all();
+    g_perf.phase = DB_PERF_PHASE_NONE;
+    if (keep != 0) {
+        for (uint32_t phase = 0U; phase < DB_PERF_PHASE_COUNT; phase++) {
+            for (uint32_t event = 0U; event < DB_PERF_EVENT_COUNT; event++) {
+                g_perf.summary.phase_totals[phase][event] +=
+                    g_perf.frame[phase][event];
+                g_perf.summary.totals[event] += g_perf.frame[phase][event];
+            }
+        }
+        g_perf.summary.frames++;
+    }
+    memset(g_perf.frame, 0, sizeof(g_perf.frame));
+}
+
+const db_perf_counters_summary_t *db_perf_counters_summary(void) {
+    return (g_perf.event_mask != 0U) ? &g_perf.summary : NULL;
+}
+
+db_perf_event_t
+db_perf_counters_split_event(const db_perf_counters_summary_t *summary) {
+    uint32_t event = 0U;
+    while ((event < DB_PERF_EVENT_COUNT) &&
+           ((summary->event_mask & (1U << event)) == 0U)) {
+        event++;
+    }
+    return (event < DB_PERF_EVENT_COUNT) ? (db_perf_event_t)event
+                                         : DB_PERF_EVENT_CYCLES;
+}
+
+static const char *db_perf_format_count(const db_perf_counters_summary_t *sum,
+                                        db_perf_event_t event, char *buffer,
+                                        size_t buffer_size) {
+    if ((sum->event_mask & (1U << event)) == 0U) {
+        return "n/a";
+    }
+    (void)db_snprintf(buffer, buffer_size, "%llu",
+                      (unsigned long long)sum->totals[event]);
+    return buffer;
+}
+
+static const char *
+db_perf_format_per_mpix(const db_perf_counters_summary_t *sum,
+                        db_perf_event_t event, double mpix, char *buffer,
+                        size_t buffer_size) {
+    if (((sum->event_mask & (1U << event)) == 0U) || (mpix <= 0.0)) {
+        return "n/a";
+    }
+    (void)db_snprintf(buffer, buffer_size, "%.1f",
+                      (double)sum->totals[event] / mpix);
+    return buffer;
+}
+
+void db_perf_counters_log_final(const char *api_name) {
+    if (g_perf.event_mask == 0U) {
+        return;
+    }
+    const db_perf_counters_summary_t *sum = &g_perf.summary;
+    const uint32_t ipc_mask = (1U << DB_PERF_EVENT_CYCLES) |
+                              (1U << DB_PERF_EVENT_INSTRUCTIONS);
+    const double mpix = ((double)sum->frames * (double)db_grid_width() *
+                         (double)db_grid_height()) /
+                        1.0e6;
+    char ipc[DB_PERF_VALUE_TEXT_BYTES] = "n/a";
+    if (((sum->event_mask & ipc_mask) == ipc_mask) &&
+        (sum->totals[DB_PERF_EVENT_CYCLES] > 0U)) {
+        (void)db_snprintf(ipc, sizeof(ipc), "%.3f",
+                          (double)sum->totals[DB_PERF_EVENT_INSTRUCTIONS] /
+                              (double)sum->totals[DB_PERF_EVENT_CYCLES]);
+    }
+    char text[7][DB_PERF_VALUE_TEXT_BYTES];
+    printf("%s perf counters (final): threads=%u frames=%llu cycles=%s "
+           "instructions=%s ipc=%s cache_misses=%s cache_misses_per_mpix=%s "
+           "branch_misses=%s branch_misses_per_mpix=%s page_faults=%s\n",
+           api_name, sum->thread_count, (unsigned long long)sum->frames,
+           db_perf_format_count(sum, DB_PERF_EVENT_CYCLES, text[0],
+                                sizeof(text[0])),
+           db_perf_format_count(sum, DB_PERF_EVENT_INSTRUCTIONS, text[1],
+                                sizeof(text[1])),
+           ipc,
+           db_perf_format_count(sum, DB_PERF_EVENT_CACHE_MISSES, text[2],
+                                sizeof(text[2])),
+           db_perf_format_per_mpix(sum, DB_PERF_EVENT_CACHE_MISSES, mpix,
+                                   text[3], sizeof(text[3])),
+           db_perf_format_count(sum, DB_PERF_EVENT_BRANCH_MISSES, text[4],
+                                sizeof(text[4])),
+           db_perf_format_per_mpix(sum, DB_PERF_EVENT_BRANCH_MISSES, mpix,
+                                   text[5], sizeof(text[5])),
+           db_perf_format_count(sum, DB_PERF_EVENT_PAGE_FAULTS, text[6],
+                                sizeof(text[6])));
+
+    for (uint32_t phase = 0U; phase < DB_PERF_PHASE_COUNT; phase++) {
+        printf("%s perf counters (final): phase=%s", api_name,
+               g_perf_phase_names[phase]);
+        for (uint32_t event = 0U; event < DB_PERF_EVENT_COUNT; event++) {
+            if ((sum->event_mask & (1U << event)) == 0U) {
+                continue;
+            }
+            const uint64_t value = sum->phase_totals[phase][event];
+            const uint64_t total = sum->totals[event];
+            printf(" %s=%llu (%.1f%%)", g_perf_event_log_keys[event],
+                   (unsigned long long)value,
+                   (total > 0U) ? (100.0 * (double)value / (double)total)
+                                : 0.0);
+        }
+        printf("\n");
+    }
+    db_perf_counters_detach_thread(0U);
+}
@@ -0,0 +1,68 @@
+#ifndef DRIVERBENCH_DB_PERF_COUNTERS_H
+#define DRIVERBENCH_DB_PERF_COUNTERS_H
+
+#include <stdint.h>
+
+#define DB_PERF_COUNTERS_MAX_THREADS 256U
+
+typedef enum {
+    DB_PERF_EVENT_CYCLES = 0,
+    DB_PERF_EVENT_INSTRUCTIONS = 1,
+    DB_PERF_EVENT_CACHE_MISSES = 2,
+    DB_PERF_EVENT_BRANCH_MISSES = 3,
+    DB_PERF_EVENT_PAGE_FAULTS = 4,
+    DB_PERF_EVENT_COUNT = 5,
+} db_perf_event_t;
+
+// Frame phases the display loops mark; counts taken between the end of one
+// frame and the first mark of the next (pacing sleeps, logging) are dropped.
+typedef enum {
+    DB_PERF_PHASE_RENDER = 0,
+    DB_PERF_PHASE_HASH = 1,
+    DB_PERF_PHASE_PRESENT = 2,
+    DB_PERF_PHASE_COUNT = 3,
+} db_perf_phase_t;
+
+typedef struct {
+    // Events that actually opened; the others read as zero.
+    uint32_t event_mask;
+    uint32_t thread_count;
+    uint64_t frames;
+    // Multiplexing-scaled counts summed over every counted thread.
+    uint64_t totals[DB_PERF_EVENT_COUNT];
+    uint64_t phase_totals[DB_PERF_PHASE_COUNT][DB_PERF_EVENT_COUNT];
+} db_perf_counters_summary_t;
+
+const char *db_perf_event_name(db_perf_event_t event);
+const char *db_perf_phase_name(db_perf_phase_t phase);
+// Parses "cycles,instructions,..." into a bit per db_perf_event_t.
+int db_perf_counters_parse(const char *text, uint32_t *out_mask);
+
+// Selects the events to count; 0 (the default) disables every call below.
+void db_perf_counters_configure(uint32_t event_mask);
+int db_perf_counters_enabled(void);
+
+// Opens a counter group for the calling thread. Slot 0 is the render thread;
+// worker threads use their worker pool index. Detach closes it again.
+void db_perf_counters_attach_thread(uint32_t slot);
+void db_perf_counters_detach_thread(uint32_t slot);
+
+// Resets the totals and opens the render thread group (slot 0).
+void db_perf_counters_begin(void);
+// Charges everything counted since the previous mark to the phase that was
+// active and makes `phase` the active one.
+void db_perf_counters_phase(db_perf_phase_t phase);
+// Closes the current frame; its counts join the totals only when keep != 0
+// (i.e. the frame was measured, not warmup).
+void db_perf_counters_frame_end(int keep);
+// Returns NULL while counters are disabled.
+const db_perf_counters_summary_t *db_perf_counters_summary(void);
+// The phase split is reported for cycles, or for the first counted event
+// when cycles are unavailable.
+db_perf_event_t
+db_perf_counters_split_event(const db_perf_counters_summary_t *summary);
+// Logs totals, IPC, misses per megapixel of the current grid and the
+// per-phase split, then closes the render thread group.
+void db_perf_counters_log_final(const char *api_name);
+
+#endif
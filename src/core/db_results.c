@@ -0,0 +1,528 @@
+#include "db_results.h"
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#ifndef _WIN32
+#include <sys/utsname.h>
+#endif
+
+#include "db_core.h"
+
+#define DB_RESULTS_BACKEND "db_results"
+#define DB_RESULTS_LINE_BYTES 4096U
+#define DB_RESULTS_TEXT_BYTES 256U
+#define DB_RESULTS_HASH_KEY_BYTES 64U
+
+typedef struct {
+    char text[DB_RESULTS_LINE_BYTES];
+    size_t len;
+} db_results_line_t;
+
+static struct {
+    FILE *file;
+    const char *path;
+    db_results_format_t format;
+    char host[DB_RESULTS_TEXT_BYTES];
+    char mode[DB_RESULTS_TEXT_BYTES];
+    uint32_t seed;
+    uint32_t speed_step;
+    int benchmark_set;
+    char runtime_api[DB_RESULTS_TEXT_BYTES];
+    char runtime_version[DB_RESULTS_TEXT_BYTES];
+    char runtime_renderer[DB_RESULTS_TEXT_BYTES];
+    // CPU renderer selection; cpu_renderer is empty for the other APIs.
+    char cpu_renderer[DB_RESULTS_TEXT_BYTES];
+    uint32_t cpu_threads;
+    char cpu_layout[DB_RESULTS_TEXT_BYTES];
+    char cpu_kernel[DB_RESULTS_TEXT_BYTES];
+    // Empty unless output hashing is on.
+    char hash_algo[DB_RESULTS_TEXT_BYTES];
+    // Identity of the last final record, for the repeat summary.
+    char last_api[DB_RESULTS_TEXT_BYTES];
+    char last_renderer[DB_RESULTS_TEXT_BYTES];
+    char last_backend[DB_RESULTS_TEXT_BYTES];
+    char last_capability_mode[DB_RESULTS_TEXT_BYTES];
+    // Final record without its hashes, waiting for db_results_set_hash.
+    db_results_line_t pending;
+    int pending_set;
+    char hash_keys[DB_RESULTS_HASHES_MAX][DB_RESULTS_HASH_KEY_BYTES];
+    uint64_t hash_values[DB_RESULTS_HASHES_MAX];
+    uint32_t hash_count;
+} g_results = {0};
+
+static const char *const g_results_csv_columns =
+    "record,api,renderer,backend,capability_mode,cpu_renderer,cpu_threads,"
+    "cpu_layout,cpu_kernel,mode,seed,speed,frames,"
+    "work_units,grid_width,grid_height,total_ms,ms_per_frame,fps,mpix_per_s,"
+    "repeat_runs,fps_ci95,ms_per_frame_ci95,"
+    "min_ms,p50_ms,p90_ms,p99_ms,p99_9_ms,max_ms,budget_ms,over_budget,"
+    "perf_cycles,perf_instructions,perf_ipc,perf_cache_misses,"
+    "perf_cache_misses_per_mpix,perf_branch_misses,perf_page_faults,"
+    "perf_split_event,perf_render_pct,perf_hash_pct,perf_present_pct,"
+    "runtime_api,runtime_version,runtime_renderer,host,hash_algo,hashes";
+
+int db_results_format_parse(const char *text, db_results_format_t *out_format) {
+    if ((text == NULL) || (out_format == NULL)) {
+        return 0;
+    }
+    if (strcmp(text, DB_RESULTS_FORMAT_NAME_JSONL) == 0) {
+        *out_format = DB_RESULTS_FORMAT_JSONL;
+        return 1;
+    }
+    if (strcmp(text, DB_RESULTS_FORMAT_NAME_CSV) == 0) {
+        *out_format = DB_RESULTS_FORMAT_CSV;
+        return 1;
+    }
+    return 0;
+}
+
+const char *db_results_format_name(db_results_format_t format) {
+    return (format == DB_RESULTS_FORMAT_CSV) ? DB_RESULTS_FORMAT_NAME_CSV
+                                             : DB_RESULTS_FORMAT_NAME_JSONL;
+}
+
+static void db_results_copy_text(char *dst, size_t dst_size, const char *src) {
+    (void)db_snprintf(dst, dst_size, "%s", (src != NULL) ? src : "");
+}
+
+__attribute__((format(printf, 2, 3))) static void
+db_results_appendf(db_results_line_t *line, const char *fmt, ...) {
+    if (line->len >= sizeof(line->text)) {
+        return;
+    }
+    va_list ap;
+    va_start(ap, fmt);
+    const int written = db_vsnprintf(&line->text[line->len],
+                                     sizeof(line->text) - line->len, fmt, ap);
+    va_end(ap);
+    if (written > 0) {
+        line->len += (size_t)written;
+        if (line->len >= sizeof(line->text)) {
+            line->len = sizeof(line->text) - 1U;
+        }
+    }
+}
+
+static void db_results_append_char(db_results_line_t *line, char c) {
+    if ((line->len + 1U) < sizeof(line->text)) {
+        line->text[line->len++] = c;
+        line->text[line->len] = '\0';
+    }
+}
+
+static void db_results_append_separator(db_results_line_t *line,
+                                        const char *key) {
+    if (g_results.format == DB_RESULTS_FORMAT_CSV) {
+        if (line->len > 0U) {
+            db_results_append_char(line, ',');
+        }
+        return;
+    }
+    db_results_appendf(line, "%s\"%s\":", (line->len > 1U) ? "," : "", key);
+}
+
+// JSON strings escape quotes, backslashes and control bytes; CSV fields are
+// quoted (with doubled quotes) only when they need it.
+static void db_results_append_text(db_results_line_t *line, const char *key,
+                                   const char *value) {
+    db_results_append_separator(line, key);
+    if (g_results.format == DB_RESULTS_FORMAT_CSV) {
+        if ((value == NULL) || (strpbrk(value, ",\"\r\n") == NULL)) {
+            db_results_appendf(line, "%s", (value != NULL) ? value : "");
+            return;
+        }
+        db_results_append_char(line, '"');
+        for (const char *c = value; *c != '\0'; c++) {
+            if (*c == '"') {
+                db_results_append_char(line, '"');
+            }
+            db_results_append_char(line, *c);
+        }
+        db_results_append_char(line, '"');
+        return;
+    }
+    if (value == NULL) {
+        db_results_appendf(line, "null");
+        return;
+    }
+    db_results_append_char(line, '"');
+    for (const unsigned char *c = (const unsigned char *)value; *c != '\0';
+         c++) {
+        if ((*c == '"') || (*c == '\\')) {
+            db_results_append_char(line, '\\');
+            db_results_append_char(line, (char)*c);
+        } else if (*c < 0x20U) {
+            db_results_appendf(line, "\\u%04x", (unsigned int)*c);
+        } else {
+            db_results_append_char(line, (char)*c);
+        }
+    }
+    db_results_append_char(line, '"');
+}
+
+static void db_results_append_nonempty_text(db_results_line_t *line,
+                                            const char *key,
+                                            const char *value) {
+    db_results_append_text(line, key, (value[0] != '\0') ? value : NULL);
+}
+
+static void db_results_append_u64(db_results_line_t *line, const char *key,
+                                  uint64_t value) {
+    db_results_append_separator(line, key);
+    db_results_appendf(line, "%llu", (unsigned long long)value);
+}
+
+static void db_results_append_double(db_results_line_t *line, const char *key,
+                                     double value) {
+    db_results_append_separator(line, key);
+    db_results_appendf(line, "%.6f", value);
+}
+
+static void db_results_append_missing(db_results_line_t *line,
+                                      const char *key) {
+    db_results_append_separator(line, key);
+    if (g_results.format == DB_RESULTS_FORMAT_JSONL) {
+        db_results_appendf(line, "null");
+    }
+}
+
+static void db_results_append_perf_count(db_results_line_t *line,
+                                         const char *key,
+                                         const db_perf_counters_summary_t *perf,
+                                         db_perf_event_t event) {
+    if ((perf != NULL) && ((perf->event_mask & (1U << event)) != 0U)) {
+        db_results_append_u64(line, key, perf->totals[event]);
+    } else {
+        db_results_append_missing(line, key);
+    }
+}
+
+static void db_results_append_perf(db_results_line_t *line,
+                                   const db_perf_counters_summary_t *perf) {
+    const uint64_t cycles =
+        (perf != NULL) ? perf->totals[DB_PERF_EVENT_CYCLES] : 0U;
+    const uint32_t ipc_mask = (1U << DB_PERF_EVENT_CYCLES) |
+                              (1U << DB_PERF_EVENT_INSTRUCTIONS);
+    const double mpix = (perf != NULL)
+                            ? ((double)perf->frames * (double)db_grid_width() *
+                               (double)db_grid_height()) /
+                                  1.0e6
+                            : 0.0;
+    db_results_append_perf_count(line, "perf_cycles", perf,
+                                 DB_PERF_EVENT_CYCLES);
+    db_results_append_perf_count(line, "perf_instructions", perf,
+                                 DB_PERF_EVENT_INSTRUCTIONS);
+    if ((perf != NULL) && ((perf->event_mask & ipc_mask) == ipc_mask) &&
+        (cycles > 0U)) {
+        db_results_append_double(
+            line, "perf_ipc",
+            (double)perf->totals[DB_PERF_EVENT_INSTRUCTIONS] /
+                (double)cycles);
+    } else {
+        db_results_append_missing(line, "perf_ipc");
+    }
+    db_results_append_perf_count(line, "perf_cache_misses", perf,
+                                 DB_PERF_EVENT_CACHE_MISSES);
+    if ((perf != NULL) &&
+        ((perf->event_mask & (1U << DB_PERF_EVENT_CACHE_MISSES)) != 0U) &&
+        (mpix > 0.0)) {
+        db_results_append_double(
+            line, "perf_cache_misses_per_mpix",
+            (double)perf->totals[DB_PERF_EVENT_CACHE_MISSES] / mpix);
+    } else {
+        db_results_append_missing(line, "perf_cache_misses_per_mpix");
+    }
+    db_results_append_perf_count(line, "perf_branch_misses", perf,
+                                 DB_PERF_EVENT_BRANCH_MISSES);
+    db_results_append_perf_count(line, "perf_page_faults", perf,
+                                 DB_PERF_EVENT_PAGE_FAULTS);
+    static const char *const phase_keys[DB_PERF_PHASE_COUNT] = {
+        "perf_render_pct",
+        "perf_hash_pct",
+        "perf_present_pct",
+    };
+    if (perf == NULL) {
+        db_results_append_missing(line, "perf_split_event");
+        for (uint32_t phase = 0U; phase < DB_PERF_PHASE_COUNT; phase++) {
+            db_results_append_missing(line, phase_keys[phase]);
+        }
+        return;
+    }
+    const db_perf_event_t split = db_perf_counters_split_event(perf);
+    db_results_append_text(line, "perf_split_event",
+                           db_perf_event_name(split));
+    for (uint32_t phase = 0U; phase < DB_PERF_PHASE_COUNT; phase++) {
+        const uint64_t total = perf->totals[split];
+        db_results_append_double(
+            line, phase_keys[phase],
+            (total > 0U) ? (100.0 * (double)perf->phase_totals[phase][split] /
+                            (double)total)
+                         : 0.0);
+    }
+}
+
+static void db_results_format_record(db_results_line_t *line,
+                                     const db_results_record_t *record) {
+    line->len = 0U;
+    line->text[0] = '\0';
+    if (g_results.format == DB_RESULTS_FORMAT_JSONL) {
+        db_results_append_char(line, '{');
+    }
+    db_results_append_text(line, "record", record->record);
+    db_results_append_text(line, "api", record->api);
+    db_results_append_text(line, "renderer", record->renderer);
+    db_results_append_text(line, "backend", record->backend);
+    db_results_append_text(line, "capability_mode", record->capability_mode);
+    if (g_results.cpu_renderer[0] != '\0') {
+        db_results_append_text(line, "cpu_renderer", g_results.cpu_renderer);
+        db_results_append_u64(line, "cpu_threads", g_results.cpu_threads);
+        db_results_append_text(line, "cpu_layout", g_results.cpu_layout);
+        db_results_append_text(line, "cpu_kernel", g_results.cpu_kernel);
+    } else {
+        db_results_append_missing(line, "cpu_renderer");
+        db_results_append_missing(line, "cpu_threads");
+        db_results_append_missing(line, "cpu_layout");
+        db_results_append_missing(line, "cpu_kernel");
+    }
+    if (g_results.benchmark_set != 0) {
+        db_results_append_text(line, "mode", g_results.mode);
+        db_results_append_u64(line, "seed", g_results.seed);
+        db_results_append_u64(line, "speed", g_results.speed_step);
+    } else {
+        db_results_append_missing(line, "mode");
+        db_results_append_missing(line, "seed");
+        db_results_append_missing(line, "speed");
+    }
+    const db_results_repeat_summary_t *repeat = record->repeat;
+    if (repeat == NULL) {
+        db_results_append_u64(line, "frames", record->frames);
+        db_results_append_u64(line, "work_units", record->work_units);
+    } else {
+        db_results_append_missing(line, "frames");
+        db_results_append_missing(line, "work_units");
+    }
+    db_results_append_u64(line, "grid_width", db_grid_width());
+    db_results_append_u64(line, "grid_height", db_grid_height());
+    if (repeat == NULL) {
+        db_results_append_double(line, "total_ms", record->total_ms);
+    } else {
+        db_results_append_missing(line, "total_ms");
+    }
+    db_results_append_double(line, "ms_per_frame", record->ms_per_frame);
+    db_results_append_double(line, "fps", record->fps);
+    db_results_append_double(line, "mpix_per_s",
+                             (record->fps * (double)db_grid_width() *
+                              (double)db_grid_height()) /
+                                 1.0e6);
+    if (repeat != NULL) {
+        db_results_append_u64(line, "repeat_runs", repeat->runs);
+        db_results_append_double(line, "fps_ci95", repeat->fps_ci95);
+        db_results_append_double(line, "ms_per_frame_ci95",
+                                 repeat->ms_per_frame_ci95);
+    } else {
+        db_results_append_missing(line, "repeat_runs");
+        db_results_append_missing(line, "fps_ci95");
+        db_results_append_missing(line, "ms_per_frame_ci95");
+    }
+    if (record->frame_time_count > 0U) {
+        db_results_append_double(line, "min_ms", record->min_ms);
+        db_results_append_double(line, "p50_ms", record->p50_ms);
+        db_results_append_double(line, "p90_ms", record->p90_ms);
+        db_results_append_double(line, "p99_ms", record->p99_ms);
+        db_results_append_double(line, "p99_9_ms", record->p99_9_ms);
+        db_results_append_double(line, "max_ms", record->max_ms);
+    } else {
+        db_results_append_missing(line, "min_ms");
+        db_results_append_missing(line, "p50_ms");
+        db_results_append_missing(line, "p90_ms");
+        db_results_append_missing(line, "p99_ms");
+        db_results_append_missing(line, "p99_9_ms");
+        db_results_append_missing(line, "max_ms");
+    }
+    if (record->budget_ms > 0.0) {
+        db_results_append_double(line, "budget_ms", record->budget_ms);
+        db_results_append_u64(line, "over_budget", record->over_budget);
+    } else {
+        db_results_append_missing(line, "budget_ms");
+        db_results_append_missing(line, "over_budget");
+    }
+    db_results_append_perf(line, record->perf);
+    db_results_append_nonempty_text(line, "runtime_api", g_results.runtime_api);
+    db_results_append_nonempty_text(line, "runtime_version",
+                                    g_results.runtime_version);
+    db_results_append_nonempty_text(line, "runtime_renderer",
+                                    g_results.runtime_renderer);
+    db_results_append_nonempty_text(line, "host", g_results.host);
+    db_results_append_nonempty_text(line, "hash_algo", g_results.hash_algo);
+}
+
+static void db_results_write_line(db_results_line_t *line, int with_hashes) {
+    db_results_append_separator(line, "hashes");
+    if (g_results.format == DB_RESULTS_FORMAT_JSONL) {
+        db_results_append_char(line, '{');
+    }
+    const uint32_t hash_count = (with_hashes != 0) ? g_results.hash_count : 0U;
+    for (uint32_t i = 0U; i < hash_count; i++) {
+        if (g_results.format == DB_RESULTS_FORMAT_JSONL) {
+            db_results_appendf(line, "%s\"%s\":\"0x%016llx\"",
+                               (i > 0U) ? "," : "", g_results.hash_keys[i],
+                               (unsigned long long)g_results.hash_values[i]);
+        } else {
+            db_results_appendf(line, "%s%s=0x%016llx", (i > 0U) ? ";" : "",
+                               g_results.hash_keys[i],
+                               (unsigned long long)g_results.hash_values[i]);
+        }
+    }
+    if (g_results.format == DB_RESULTS_FORMAT_JSONL) {
+        db_results_appendf(line, "}}");
+    }
+    if ((fprintf(g_results.file, "%s\n", line->text) < 0) ||
+        (fflush(g_results.file) != 0)) {
+        db_failf(DB_RESULTS_BACKEND, "failed to write results file: %s",
+                 g_results.path);
+    }
+}
+
+static void db_results_flush_pending(void) {
+    if (g_results.pending_set == 0) {
+        return;
+    }
+    db_results_write_line(&g_results.pending, 1);
+    g_results.pending_set = 0;
+    g_results.hash_count = 0U;
+}
+
+void db_results_open_or_fail(const char *path, db_results_format_t format) {
+    g_results.file = fopen(path, "w");
+    if (g_results.file == NULL) {
+        db_failf(DB_RESULTS_BACKEND, "failed to open results file: %s", path);
+    }
+    g_results.path = path;
+    g_results.format = format;
+#ifndef _WIN32
+    struct utsname host = {0};
+    if (uname(&host) == 0) {
+        (void)db_snprintf(g_results.host, sizeof(g_results.host), "%s %s %s",
+                          host.sysname, host.release, host.machine);
+    }
+#endif
+    if (format == DB_RESULTS_FORMAT_CSV) {
+        (void)fprintf(g_results.file, "%s\n", g_results_csv_columns);
+    }
+}
+
+void db_results_record(const db_results_record_t *record) {
+    if (g_results.file == NULL) {
+        return;
+    }
+    if (strcmp(record->record, "final") != 0) {
+        db_results_line_t line;
+        db_results_format_record(&line, record);
+        db_results_write_line(&line, 0);
+        return;
+    }
+    db_results_flush_pending();
+    db_results_format_record(&g_results.pending, record);
+    g_results.pending_set = 1;
+    db_results_copy_text(g_results.last_api, sizeof(g_results.last_api),
+                         record->api);
+    db_results_copy_text(g_results.last_renderer,
+                         sizeof(g_results.last_renderer), record->renderer);
+    db_results_copy_text(g_results.last_backend,
+                         sizeof(g_results.last_backend), record->backend);
+    db_results_copy_text(g_results.last_capability_mode,
+                         sizeof(g_results.last_capability_mode),
+                         record->capability_mode);
+}
+
+void db_results_record_repeat_summary(
+    const db_results_repeat_summary_t *summary) {
+    if (g_results.file == NULL) {
+        return;
+    }
+    // The last run's final record keeps its hashes.
+    db_results_flush_pending();
+    const db_results_record_t record = {
+        .api = g_results.last_api,
+        .renderer = g_results.last_renderer,
+        .backend = g_results.last_backend,
+        .capability_mode = g_results.last_capability_mode,
+        .record = "repeat_summary",
+        .ms_per_frame = summary->ms_per_frame_mean,
+        .fps = summary->fps_mean,
+        .repeat = summary,
+    };
+    db_results_line_t line;
+    db_results_format_record(&line, &record);
+    db_results_write_line(&line, 0);
+}
+
+void db_results_set_benchmark(const char *mode, uint32_t seed,
+                              uint32_t speed_step) {
+    db_results_copy_text(g_results.mode, sizeof(g_results.mode), mode);
+    g_results.seed = seed;
+    g_results.speed_step = speed_step;
+    g_results.benchmark_set = 1;
+}
+
+void db_results_begin_run(void) {
+    g_results.runtime_api[0] = '\0';
+    g_results.runtime_version[0] = '\0';
+    g_results.runtime_renderer[0] = '\0';
+    g_results.cpu_renderer[0] = '\0';
+    g_results.cpu_threads = 0U;
+    g_results.cpu_layout[0] = '\0';
+    g_results.cpu_kernel[0] = '\0';
+    g_results.hash_algo[0] = '\0';
+}
+
+void db_results_set_cpu_renderer(const char *renderer, uint32_t threads,
+                                 const char *layout, const char *kernel) {
+    db_results_copy_text(g_results.cpu_renderer,
+                         sizeof(g_results.cpu_renderer), renderer);
+    g_results.cpu_threads = threads;
+    db_results_copy_text(g_results.cpu_layout, sizeof(g_results.cpu_layout),
+                         layout);
+    db_results_copy_text(g_results.cpu_kernel, sizeof(g_results.cpu_kernel),
+                         kernel);
+}
+
+void db_results_set_hash_algo(const char *name) {
+    db_results_copy_text(g_results.hash_algo, sizeof(g_results.hash_algo),
+                         name);
+}
+
+void db_results_set_runtime_api(const char *api_name, const char *version,
+                                const char *renderer) {
+    db_results_copy_text(g_results.runtime_api, sizeof(g_results.runtime_api),
+                         api_name);
+    db_results_copy_text(g_results.runtime_version,
+                         sizeof(g_results.runtime_version), version);
+    db_results_copy_text(g_results.runtime_renderer,
+                         sizeof(g_results.runtime_renderer), renderer);
+}
+
+void db_results_set_hash(const char *key, uint64_t value) {
+    if ((g_results.pending_set == 0) ||
+        (g_results.hash_count >= DB_RESULTS_HASHES_MAX)) {
+        return;
+    }
+    db_results_copy_text(g_results.hash_keys[g_results.hash_count],
+                         DB_RESULTS_HASH_KEY_BYTES, key);
+    g_results.hash_values[g_results.hash_count] = value;
+    g_results.hash_count++;
+}
+
+void db_results_close(void) {
+    if (g_results.file == NULL) {
+        return;
+    }
+    db_results_flush_pending();
+    if (fclose(g_results.file) != 0) {
+        db_failf(DB_RESULTS_BACKEND, "failed to close results file: %s",
+                 g_results.path);
+    }
+    g_results.file = NULL;
+}
@@ -0,0 +1,84 @@
+#ifndef DRIVERBENCH_DB_RESULTS_H
+#define DRIVERBENCH_DB_RESULTS_H
+
+#include <stdint.h>
+
+#include "db_perf_counters.h"
+
+#define DB_RESULTS_FORMAT_NAME_CSV "csv"
+#define DB_RESULTS_FORMAT_NAME_JSONL "jsonl"
+#define DB_RESULTS_HASHES_MAX 4U
+
+typedef enum {
+    // One JSON object per line.
+    DB_RESULTS_FORMAT_JSONL = 0,
+    // Header row, then one row per record; hashes share one column.
+    DB_RESULTS_FORMAT_CSV = 1,
+} db_results_format_t;
+
+// Across-run figures of one --repeat sequence.
+typedef struct {
+    uint32_t runs;
+    double fps_mean;
+    double fps_ci95;
+    double ms_per_frame_mean;
+    double ms_per_frame_ci95;
+} db_results_repeat_summary_t;
+
+typedef struct {
+    const char *api;
+    const char *renderer;
+    const char *backend;
+    const char *capability_mode;
+    // "progress", "final" or "repeat_summary".
+    const char *record;
+    uint64_t frames;
+    uint32_t work_units;
+    double total_ms;
+    double ms_per_frame;
+    double fps;
+    // Frame-time percentiles are only valid when frame_time_count > 0;
+    // over_budget is only valid when budget_ms > 0.
+    uint64_t frame_time_count;
+    double min_ms;
+    double p50_ms;
+    double p90_ms;
+    double p99_ms;
+    double p99_9_ms;
+    double max_ms;
+    double budget_ms;
+    uint64_t over_budget;
+    // NULL unless --perf-counters is active.
+    const db_perf_counters_summary_t *perf;
+    // Only set on repeat_summary records, whose fps and ms_per_frame are the
+    // across-run means.
+    const db_results_repeat_summary_t *repeat;
+} db_results_record_t;
+
+int db_results_format_parse(const char *text, db_results_format_t *out_format);
+const char *db_results_format_name(db_results_format_t format);
+
+// Opens the --results-file sink; every later record is appended to it until
+// db_results_close. Without a sink all other calls are no-ops.
+void db_results_open_or_fail(const char *path, db_results_format_t format);
+// Progress records are written immediately. A final record is held until
+// the next final record or db_results_close so the hashes logged after it
+// can be attached.
+void db_results_record(const db_results_record_t *record);
+// Writes a repeat_summary record labelled like the last final record.
+void db_results_record_repeat_summary(
+    const db_results_repeat_summary_t *summary);
+void db_results_set_benchmark(const char *mode, uint32_t seed,
+                              uint32_t speed_step);
+// Clears the per-run fields below so a --repeat or --sweep run never
+// inherits the previous run's values.
+void db_results_begin_run(void);
+void db_results_set_cpu_renderer(const char *renderer, uint32_t threads,
+                                 const char *layout, const char *kernel);
+void db_results_set_hash_algo(const char *name);
+void db_results_set_runtime_api(const char *api_name, const char *version,
+                                const char *renderer);
+void db_results_set_hash(const char *key, uint64_t value);
+void db_results_close(void);
+
+#endif
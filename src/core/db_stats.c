@@ -0,0 +1,143 @@
+#include "db_stats.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "db_core.h"
+
+typedef struct {
+    double value;
+    int in_b;
+} db_stats_ranked_t;
+
+// t(0.975, df) for df = 1..40; larger df use coarse steps that take the
+// value at the lowest df of each range, so the interval is never too narrow.
+static const double g_stats_t_critical_95[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+    2.040,  2.037, 2.035, 2.032, 2.030, 2.028, 2.026, 2.024, 2.023, 2.021,
+};
+
+double db_stats_t_critical_95(size_t degrees_of_freedom) {
+    const size_t table_size =
+        sizeof(g_stats_t_critical_95) / sizeof(g_stats_t_critical_95[0]);
+    if (degrees_of_freedom == 0U) {
+        return 0.0;
+    }
+    if (degrees_of_freedom <= table_size) {
+        return g_stats_t_critical_95[degrees_of_freedom - 1U];
+    }
+    if (degrees_of_freedom <= 60U) {
+        return 2.020;
+    }
+    if (degrees_of_freedom <= 120U) {
+        return 2.000;
+    }
+    return 1.980;
+}
+
+db_stats_summary_t db_stats_summarize(const double *values, size_t count) {
+    db_stats_summary_t summary = {0};
+    summary.count = count;
+    if (count == 0U) {
+        return summary;
+    }
+    double sum = 0.0;
+    for (size_t i = 0U; i < count; i++) {
+        sum += values[i];
+    }
+    summary.mean = sum / (double)count;
+    if (count < 2U) {
+        return summary;
+    }
+    double sum_sq = 0.0;
+    for (size_t i = 0U; i < count; i++) {
+        const double delta = values[i] - summary.mean;
+        sum_sq += delta * delta;
+    }
+    summary.stddev = sqrt(sum_sq / (double)(count - 1U));
+    summary.ci95_half_width = db_stats_t_critical_95(count - 1U) *
+                              summary.stddev / sqrt((double)count);
+    return summary;
+}
+
+static int db_stats_compare_double(const void *lhs, const void *rhs) {
+    const double a = *(const double *)lhs;
+    const double b = *(const double *)rhs;
+    return (a > b) - (a < b);
+}
+
+static int db_stats_compare_ranked(const void *lhs, const void *rhs) {
+    return db_stats_compare_double(&((const db_stats_ranked_t *)lhs)->value,
+                                   &((const db_stats_ranked_t *)rhs)->value);
+}
+
+double db_stats_median(const double *values, size_t count) {
+    if (count == 0U) {
+        return 0.0;
+    }
+    double *sorted = (double *)db_alloc_array_or_fail(
+        "db_stats", "median", count, sizeof(double));
+    for (size_t i = 0U; i < count; i++) {
+        sorted[i] = values[i];
+    }
+    qsort(sorted, count, sizeof(double), db_stats_compare_double);
+    const double median =
+        ((count % 2U) != 0U)
+            ? sorted[count / 2U]
+            : 0.5 * (sorted[(count / 2U) - 1U] + sorted[count / 2U]);
+    free(sorted);
+    return median;
+}
+
+double db_stats_mann_whitney_p_greater(const double *a, size_t a_count,
+                                       const double *b, size_t b_count) {
+    if ((a_count == 0U) || (b_count == 0U)) {
+        return 1.0;
+    }
+    const size_t n = a_count + b_count;
+    db_stats_ranked_t *ranked = (db_stats_ranked_t *)db_alloc_array_or_fail(
+        "db_stats", "mann_whitney", n, sizeof(db_stats_ranked_t));
+    for (size_t i = 0U; i < a_count; i++) {
+        ranked[i] = (db_stats_ranked_t){a[i], 0};
+    }
+    for (size_t i = 0U; i < b_count; i++) {
+        ranked[a_count + i] = (db_stats_ranked_t){b[i], 1};
+    }
+    qsort(ranked, n, sizeof(db_stats_ranked_t), db_stats_compare_ranked);
+
+    // Tied values share the average of the ranks they span.
+    double b_rank_sum = 0.0;
+    double tie_term = 0.0;
+    for (size_t start = 0U; start < n;) {
+        size_t end = start + 1U;
+        while ((end < n) && (ranked[end].value == ranked[start].value)) {
+            end++;
+        }
+        const double tie_count = (double)(end - start);
+        const double average_rank = 0.5 * (double)(start + 1U + end);
+        for (size_t i = start; i < end; i++) {
+            if (ranked[i].in_b != 0) {
+                b_rank_sum += average_rank;
+            }
+        }
+        tie_term += (tie_count * tie_count * tie_count) - tie_count;
+        start = end;
+    }
+    free(ranked);
+
+    const double na = (double)a_count;
+    const double nb = (double)b_count;
+    const double nn = (double)n;
+    const double u_b = b_rank_sum - (nb * (nb + 1.0) / 2.0);
+    const double mean = na * nb / 2.0;
+    const double variance =
+        (na * nb / 12.0) * ((nn + 1.0) - (tie_term / (nn * (nn - 1.0))));
+    if (variance <= 0.0) {
+        return 1.0;
+    }
+    const double z = (u_b - mean - 0.5) / sqrt(variance);
+    return 0.5 * erfc(z / sqrt(2.0));
+}
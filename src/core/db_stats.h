@@ -0,0 +1,26 @@
+#ifndef DRIVERBENCH_DB_STATS_H
+#define DRIVERBENCH_DB_STATS_H
+
+#include <stddef.h>
+
+typedef struct {
+    size_t count;
+    double mean;
+    // Sample (n - 1) standard deviation; 0 for fewer than two samples.
+    double stddev;
+    // Half-width of the two-sided 95% Student-t confidence interval of the
+    // mean; 0 for fewer than two samples.
+    double ci95_half_width;
+} db_stats_summary_t;
+
+db_stats_summary_t db_stats_summarize(const double *values, size_t count);
+// Two-sided 95% Student-t critical value for the given degrees of freedom.
+double db_stats_t_critical_95(size_t degrees_of_freedom);
+double db_stats_median(const double *values, size_t count);
+// One-sided Mann-Whitney U test (normal approximation with tie and
+// continuity correction): p-value for "samples in b tend to be larger than
+// samples in a". Returns 1 when either side is empty or all values tie.
+double db_stats_mann_whitney_p_greater(const double *a, size_t a_count,
+                                       const double *b, size_t b_count);
+
+#endif
@@ -0,0 +1,215 @@
+#include "db_trace.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "db_core.h"
+
+#define BACKEND_NAME "db_trace"
+#define DB_TRACE_THREAD_NAME_BYTES 32U
+
+typedef struct {
+    const char *name;
+    uint64_t start_ns;
+    uint64_t duration_ns;
+} db_trace_event_t;
+
+// Written only by its owning thread; the reader (db_trace_close) runs after
+// the traced threads have gone quiet and trusts `head` for what is complete.
+typedef struct {
+    db_trace_event_t *events;
+    _Atomic uint64_t head;
+    const char *open_names[DB_TRACE_MAX_DEPTH];
+    uint64_t open_start_ns[DB_TRACE_MAX_DEPTH];
+    uint32_t depth;
+    // Opens past DB_TRACE_MAX_DEPTH are counted so their ENDs still match.
+    uint32_t overflow_depth;
+    uint32_t tid;
+    char thread_name[DB_TRACE_THREAD_NAME_BYTES];
+} db_trace_ring_t;
+
+static struct {
+    atomic_int enabled;
+    FILE *file;
+    const char *path;
+    uint64_t origin_ns;
+    _Atomic(db_trace_ring_t *) rings[DB_TRACE_MAX_THREADS];
+    atomic_uint ring_count;
+} g_trace = {0};
+
+static _Thread_local db_trace_ring_t *t_trace_ring = NULL;
+
+static db_trace_ring_t *db_trace_thread_ring(void) {
+    if (t_trace_ring != NULL) {
+        return t_trace_ring;
+    }
+    const uint32_t tid = atomic_fetch_add(&g_trace.ring_count, 1U);
+    if (tid >= DB_TRACE_MAX_THREADS) {
+        // Threads beyond the limit go untraced.
+        return NULL;
+    }
+    db_trace_ring_t *ring = (db_trace_ring_t *)db_alloc_array_or_fail(
+        BACKEND_NAME, "trace_ring", 1U, sizeof(*ring));
+    memset(ring, 0, sizeof(*ring));
+    ring->events = (db_trace_event_t *)db_alloc_array_or_fail(
+        BACKEND_NAME, "trace_events", DB_TRACE_RING_EVENTS,
+        sizeof(ring->events[0]));
+    ring->tid = tid;
+    (void)db_snprintf(ring->thread_name, sizeof(ring->thread_name),
+                      "thread %u", tid);
+    atomic_store_explicit(&g_trace.rings[tid], ring, memory_order_release);
+    t_trace_ring = ring;
+    return ring;
+}
+
+void db_trace_open_or_fail(const char *path) {
+    g_trace.file = fopen(path, "w");
+    if (g_trace.file == NULL) {
+        db_failf(BACKEND_NAME, "failed to open trace file: %s", path);
+    }
+    g_trace.path = path;
+    g_trace.origin_ns = db_now_ns_monotonic();
+    atomic_store(&g_trace.enabled, 1);
+    db_trace_thread_name("main");
+}
+
+void db_trace_thread_name(const char *name) {
+    if (atomic_load_explicit(&g_trace.enabled, memory_order_relaxed) == 0) {
+        return;
+    }
+    db_trace_ring_t *ring = db_trace_thread_ring();
+    if (ring != NULL) {
+        (void)db_snprintf(ring->thread_name, sizeof(ring->thread_name), "%s",
+                          name);
+    }
+}
+
+void db_trace_begin(const char *name) {
+    if (atomic_load_explicit(&g_trace.enabled, memory_order_relaxed) == 0) {
+        return;
+    }
+    db_trace_ring_t *ring = db_trace_thread_ring();
+    if (ring == NULL) {
+        return;
+    }
+    if (ring->depth >= DB_TRACE_MAX_DEPTH) {
+        ring->overflow_depth++;
+        return;
+    }
+    ring->open_names[ring->depth] = name;
+    ring->open_start_ns[ring->depth] = db_now_ns_monotonic();
+    ring->depth++;
+}
+
+void db_trace_end(const char *name) {
+    if (atomic_load_explicit(&g_trace.enabled, memory_order_relaxed) == 0) {
+        return;
+    }
+    db_trace_ring_t *ring = t_trace_ring;
+    if (ring == NULL) {
+        return;
+    }
+    if (ring->overflow_depth > 0U) {
+        ring->overflow_depth--;
+        return;
+    }
+    if ((ring->depth == 0U) ||
+        (strcmp(ring->open_names[ring->depth - 1U], name) != 0)) {
+        // Unbalanced marker (e.g. tracing enabled mid-scope); drop it.
+        return;
+    }
+    ring->depth--;
+    const uint64_t head =
+        atomic_load_explicit(&ring->head, memory_order_relaxed);
+    db_trace_event_t *event = &ring->events[head % DB_TRACE_RING_EVENTS];
+    event->name = name;
+    event->start_ns = ring->open_start_ns[ring->depth];
+    event->duration_ns = db_now_ns_monotonic() - event->start_ns;
+    atomic_store_explicit(&ring->head, head + 1U, memory_order_release);
+}
+
+static void db_trace_write_escaped(FILE *file, const char *text) {
+    for (const unsigned char *c = (const unsigned char *)text; *c != '\0';
+         c++) {
+        if ((*c == '"') || (*c == '\\')) {
+            (void)fputc('\\', file);
+            (void)fputc(*c, file);
+        } else if (*c < 0x20U) {
+            (void)fprintf(file, "\\u%04x", (unsigned int)*c);
+        } else {
+            (void)fputc(*c, file);
+        }
+    }
+}
+
+void db_trace_close(void) {
+    if (g_trace.file == NULL) {
+        return;
+    }
+    atomic_store(&g_trace.enabled, 0);
+    FILE *file = g_trace.file;
+    uint32_t ring_count = atomic_load(&g_trace.ring_count);
+    if (ring_count > DB_TRACE_MAX_THREADS) {
+        db_infof(BACKEND_NAME, "%u threads were not traced (max %u)",
+                 ring_count - DB_TRACE_MAX_THREADS, DB_TRACE_MAX_THREADS);
+        ring_count = DB_TRACE_MAX_THREADS;
+    }
+
+    uint64_t written = 0U;
+    (void)fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+    for (uint32_t tid = 0U; tid < ring_count; tid++) {
+        db_trace_ring_t *ring =
+            atomic_load_explicit(&g_trace.rings[tid], memory_order_acquire);
+        if (ring == NULL) {
+            continue;
+        }
+        (void)fprintf(file,
+                      "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                      "\"tid\":%u,\"args\":{\"name\":\"",
+                      (written > 0U) ? "," : "", tid);
+        db_trace_write_escaped(file, ring->thread_name);
+        (void)fputs("\"}}", file);
+        written++;
+
+        const uint64_t head =
+            atomic_load_explicit(&ring->head, memory_order_acquire);
+        const uint64_t first = (head > DB_TRACE_RING_EVENTS)
+                                   ? (head - DB_TRACE_RING_EVENTS)
+                                   : 0U;
+        if (first > 0U) {
+            db_infof(BACKEND_NAME,
+                     "%s: ring wrapped, kept the last %u of %llu events",
+                     ring->thread_name, DB_TRACE_RING_EVENTS,
+                     (unsigned long long)head);
+        }
+        for (uint64_t i = first; i < head; i++) {
+            const db_trace_event_t *event =
+                &ring->events[i % DB_TRACE_RING_EVENTS];
+            const uint64_t start_ns =
+                (event->start_ns > g_trace.origin_ns)
+                    ? (event->start_ns - g_trace.origin_ns)
+                    : 0U;
+            (void)fprintf(file,
+                          ",\n{\"name\":\"%s\",\"cat\":\"driverbench\","
+                          "\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,"
+                          "\"dur\":%.3f}",
+                          event->name, tid, (double)start_ns / 1000.0,
+                          (double)event->duration_ns / 1000.0);
+            written++;
+        }
+        free(ring->events);
+        free(ring);
+        atomic_store(&g_trace.rings[tid], NULL);
+    }
+    (void)fputs("\n]}\n", file);
+    if (fclose(file) != 0) {
+        db_failf(BACKEND_NAME, "failed to write trace file: %s", g_trace.path);
+    }
+    g_trace.file = NULL;
+    t_trace_ring = NULL;
+    db_infof(BACKEND_NAME, "wrote %llu trace events to %s",
+             (unsigned long long)written, g_trace.path);
+}
@@ -0,0 +1,24 @@
+#ifndef DRIVERBENCH_DB_TRACE_H
+#define DRIVERBENCH_DB_TRACE_H
+
+#define DB_TRACE_MAX_THREADS 512U
+// Per-thread ring capacity; the oldest events are overwritten once full.
+#define DB_TRACE_RING_EVENTS 16384U
+#define DB_TRACE_MAX_DEPTH 16U
+
+// Scoped trace markers. `name` must be a string literal (only the pointer is
+// stored) and every BEGIN needs the matching END on the same thread. Both are
+// a single flag check while --trace-file is off.
+#define DB_TRACE_BEGIN(name) db_trace_begin(name)
+#define DB_TRACE_END(name) db_trace_end(name)
+
+// Enables tracing and creates the --trace-file up front so a bad path fails
+// before the run. Events are written as Chrome trace-event JSON on close.
+void db_trace_open_or_fail(const char *path);
+void db_trace_close(void);
+// Labels the calling thread in the trace viewer; name is copied.
+void db_trace_thread_name(const char *name);
+void db_trace_begin(const char *name);
+void db_trace_end(const char *name);
+
+#endif
@@ -0,0 +1,207 @@
+#define _GNU_SOURCE // NOLINT(bugprone-reserved-identifier)
+
+#include "db_worker_pool.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+
+#include "db_core.h"
+#include "db_perf_counters.h"
+#include "db_trace.h"
+
+#define BACKEND_NAME "db_worker_pool"
+
+typedef struct {
+    pthread_t threads[DB_WORKER_POOL_MAX_THREADS];
+    uint32_t worker_indices[DB_WORKER_POOL_MAX_THREADS];
+    pthread_mutex_t mutex;
+    pthread_cond_t work_cond;
+    pthread_cond_t done_cond;
+    db_worker_pool_task_fn task;
+    void *task_ctx;
+    uint64_t generation;
+    uint32_t thread_count;
+    uint32_t pending;
+    int stopping;
+    int started;
+#ifdef __linux__
+    // Affinity of the calling thread before db_worker_pool_pin_cpus, put
+    // back by db_worker_pool_stop.
+    cpu_set_t caller_affinity;
+    int caller_affinity_saved;
+#endif
+} db_worker_pool_t;
+
+static db_worker_pool_t g_pool = {0};
+
+static void *db_worker_pool_thread_main(void *arg) {
+    const uint32_t worker_index = *(const uint32_t *)arg;
+    // Workers are created before the first dispatch, so generation 0 is
+    // always the "nothing to do yet" state.
+    uint64_t seen_generation = 0U;
+
+    db_perf_counters_attach_thread(worker_index);
+    char trace_name[32];
+    (void)db_snprintf(trace_name, sizeof(trace_name), "render worker %u",
+                      worker_index);
+    db_trace_thread_name(trace_name);
+    (void)pthread_mutex_lock(&g_pool.mutex);
+    for (;;) {
+        while ((g_pool.stopping == 0) &&
+               (g_pool.generation == seen_generation)) {
+            (void)pthread_cond_wait(&g_pool.work_cond, &g_pool.mutex);
+        }
+        if (g_pool.stopping != 0) {
+            break;
+        }
+        seen_generation = g_pool.generation;
+        const db_worker_pool_task_fn task = g_pool.task;
+        void *task_ctx = g_pool.task_ctx;
+        const uint32_t worker_count = g_pool.thread_count;
+        (void)pthread_mutex_unlock(&g_pool.mutex);
+
+        DB_TRACE_BEGIN("worker_task");
+        task(task_ctx, worker_index, worker_count);
+        DB_TRACE_END("worker_task");
+
+        (void)pthread_mutex_lock(&g_pool.mutex);
+        g_pool.pending--;
+        if (g_pool.pending == 0U) {
+            (void)pthread_cond_signal(&g_pool.done_cond);
+        }
+    }
+    (void)pthread_mutex_unlock(&g_pool.mutex);
+    db_perf_counters_detach_thread(worker_index);
+    return NULL;
+}
+
+void db_worker_pool_start(const char *backend, uint32_t thread_count) {
+    if (g_pool.started != 0) {
+        db_failf(backend, "worker pool already started");
+    }
+    if ((thread_count == 0U) || (thread_count > DB_WORKER_POOL_MAX_THREADS)) {
+        db_failf(backend, "invalid worker thread count: %u (max: %u)",
+                 thread_count, DB_WORKER_POOL_MAX_THREADS);
+    }
+
+    g_pool.generation = 0U;
+    g_pool.pending = 0U;
+    g_pool.stopping = 0;
+    g_pool.task = NULL;
+    g_pool.task_ctx = NULL;
+    g_pool.thread_count = thread_count;
+    if (thread_count == 1U) {
+        g_pool.started = 1;
+        return;
+    }
+
+    if ((pthread_mutex_init(&g_pool.mutex, NULL) != 0) ||
+        (pthread_cond_init(&g_pool.work_cond, NULL) != 0) ||
+        (pthread_cond_init(&g_pool.done_cond, NULL) != 0)) {
+        db_failf(backend, "failed to initialize worker pool sync primitives");
+    }
+    for (uint32_t i = 1U; i < thread_count; i++) {
+        g_pool.worker_indices[i] = i;
+        if (pthread_create(&g_pool.threads[i], NULL,
+                           db_worker_pool_thread_main,
+                           &g_pool.worker_indices[i]) != 0) {
+            db_failf(backend, "failed to create worker thread %u", i);
+        }
+    }
+    g_pool.started = 1;
+    db_infof(BACKEND_NAME, "started %u render threads", thread_count);
+}
+
+void db_worker_pool_run(db_worker_pool_task_fn task, void *ctx) {
+    if (task == NULL) {
+        return;
+    }
+    if ((g_pool.started == 0) || (g_pool.thread_count <= 1U)) {
+        task(ctx, 0U, 1U);
+        return;
+    }
+
+    (void)pthread_mutex_lock(&g_pool.mutex);
+    g_pool.task = task;
+    g_pool.task_ctx = ctx;
+    g_pool.pending = g_pool.thread_count - 1U;
+    g_pool.generation++;
+    (void)pthread_cond_broadcast(&g_pool.work_cond);
+    (void)pthread_mutex_unlock(&g_pool.mutex);
+
+    DB_TRACE_BEGIN("worker_task");
+    task(ctx, 0U, g_pool.thread_count);
+    DB_TRACE_END("worker_task");
+
+    (void)pthread_mutex_lock(&g_pool.mutex);
+    while (g_pool.pending != 0U) {
+        (void)pthread_cond_wait(&g_pool.done_cond, &g_pool.mutex);
+    }
+    (void)pthread_mutex_unlock(&g_pool.mutex);
+}
+
+void db_worker_pool_stop(void) {
+#ifdef __linux__
+    if (g_pool.caller_affinity_saved != 0) {
+        (void)pthread_setaffinity_np(pthread_self(),
+                                     sizeof(g_pool.caller_affinity),
+                                     &g_pool.caller_affinity);
+        g_pool.caller_affinity_saved = 0;
+    }
+#endif
+    if (g_pool.started == 0) {
+        return;
+    }
+    if (g_pool.thread_count > 1U) {
+        (void)pthread_mutex_lock(&g_pool.mutex);
+        g_pool.stopping = 1;
+        (void)pthread_cond_broadcast(&g_pool.work_cond);
+        (void)pthread_mutex_unlock(&g_pool.mutex);
+        for (uint32_t i = 1U; i < g_pool.thread_count; i++) {
+            (void)pthread_join(g_pool.threads[i], NULL);
+        }
+        (void)pthread_cond_destroy(&g_pool.done_cond);
+        (void)pthread_cond_destroy(&g_pool.work_cond);
+        (void)pthread_mutex_destroy(&g_pool.mutex);
+    }
+    g_pool.started = 0;
+    g_pool.thread_count = 0U;
+}
+
+void db_worker_pool_pin_cpus(const char *backend, const uint32_t *cpus,
+                             size_t cpu_count) {
+    if ((cpus == NULL) || (cpu_count == 0U)) {
+        return;
+    }
+#ifdef __linux__
+    if ((g_pool.caller_affinity_saved == 0) &&
+        (pthread_getaffinity_np(pthread_self(), sizeof(g_pool.caller_affinity),
+                                &g_pool.caller_affinity) == 0)) {
+        g_pool.caller_affinity_saved = 1;
+    }
+    const uint32_t thread_count = db_worker_pool_thread_count();
+    for (uint32_t i = 0U; i < thread_count; i++) {
+        const uint32_t cpu = cpus[i % cpu_count];
+        if (cpu >= CPU_SETSIZE) {
+            db_failf(backend, "cpu %u exceeds CPU_SETSIZE", cpu);
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        const pthread_t thread = (i == 0U) ? pthread_self() : g_pool.threads[i];
+        if (pthread_setaffinity_np(thread, sizeof(set), &set) != 0) {
+            db_failf(backend, "failed to pin render thread %u to cpu %u", i,
+                     cpu);
+        }
+    }
+    db_infof(BACKEND_NAME, "pinned %u render threads across %zu cpus",
+             thread_count, cpu_count);
+#else
+    db_failf(backend, "thread pinning is only supported on Linux");
+#endif
+}
+
+uint32_t db_worker_pool_thread_count(void) {
+    return (g_pool.started != 0) ? g_pool.thread_count : 1U;
+}
@@ -0,0 +1,39 @@
+#ifndef DRIVERBENCH_DB_WORKER_POOL_H
+#define DRIVERBENCH_DB_WORKER_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DB_WORKER_POOL_MAX_THREADS 256U
+
+// Invoked once per participating thread for every db_worker_pool_run call.
+// worker_index 0 is always the calling (render) thread.
+typedef void (*db_worker_pool_task_fn)(void *ctx, uint32_t worker_index,
+                                       uint32_t worker_count);
+
+void db_worker_pool_start(const char *backend, uint32_t thread_count);
+void db_worker_pool_run(db_worker_pool_task_fn task, void *ctx);
+void db_worker_pool_stop(void);
+uint32_t db_worker_pool_thread_count(void);
+// Pins worker i (0 = caller) to cpus[i % cpu_count]. Linux only. The
+// caller's previous affinity is restored by db_worker_pool_stop.
+void db_worker_pool_pin_cpus(const char *backend, const uint32_t *cpus,
+                             size_t cpu_count);
+
+static inline void db_worker_pool_split_rows(uint32_t rows,
+                                             uint32_t worker_index,
+                                             uint32_t worker_count,
+                                             uint32_t *out_row_start,
+                                             uint32_t *out_row_end) {
+    if (worker_count == 0U) {
+        *out_row_start = 0U;
+        *out_row_end = rows;
+        return;
+    }
+    *out_row_start =
+        (uint32_t)(((uint64_t)rows * worker_index) / (uint64_t)worker_count);
+    *out_row_end = (uint32_t)(((uint64_t)rows * (worker_index + 1U)) /
+                              (uint64_t)worker_count);
+}
+
+#endif
@@ -1,7 +1,31 @@
 #include "display_dispatch.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
 #include "../core/db_core.h"
+#include "../core/db_results.h"
+#include "../core/db_stats.h"
 #include "../driverbench_cli.h"
 
+typedef struct {
+    const char *label;
+    uint32_t width;
+    uint32_t height;
+} db_resolution_sweep_step_t;
+
+static const db_resolution_sweep_step_t db_resolution_sweep_steps[] = {
+    {"720p", 1280U, 720U},   {"1080p", 1920U, 1080U},
+    {"1440p", 2560U, 1440U}, {"4k", 3840U, 2160U},
+    {"8k", 7680U, 4320U},
+};
+
+static int db_run_display_once(db_display_t display, db_api_t api,
+                               db_gl_renderer_t renderer,
+                               const char *kms_card_path,
+                               const db_cli_config_t *cfg);
+
 int db_run_display_auto(db_display_t display, db_gl_renderer_t renderer,
                         const char *kms_card_path, const db_cli_config_t *cfg) {
     if (db_dispatch_display_is_compiled(display) == 0) {
@@ -29,9 +53,250 @@ int db_run_display_auto(db_display_t display, db_gl_renderer_t renderer,
     return db_run_display(display, DB_API_CPU, renderer, kms_card_path, cfg);
 }
 
+// Re-runs the whole display/renderer lifecycle once per resolution so each
+// step gets freshly sized buffers, then reports throughput per step.
+static int db_run_resolution_sweep(db_display_t display, db_api_t api,
+                                   db_gl_renderer_t renderer,
+                                   const char *kms_card_path,
+                                   const db_cli_config_t *cfg) {
+    const size_t step_count = sizeof(db_resolution_sweep_steps) /
+                              sizeof(db_resolution_sweep_steps[0]);
+    double mpix_per_s[sizeof(db_resolution_sweep_steps) /
+                      sizeof(db_resolution_sweep_steps[0])] = {0.0};
+    const uint32_t base_width = db_grid_width();
+    const uint32_t base_height = db_grid_height();
+
+    for (size_t i = 0U; i < step_count; i++) {
+        const db_resolution_sweep_step_t *step = &db_resolution_sweep_steps[i];
+        db_grid_size_set(step->width, step->height);
+        db_infof("display_dispatch", "resolution sweep step %zu/%zu: %s (%ux%u)",
+                 i + 1U, step_count, step->label, step->width, step->height);
+        const int result =
+            db_run_display_once(display, api, renderer, kms_card_path, cfg);
+        if (result != EXIT_SUCCESS) {
+            db_grid_size_set(base_width, base_height);
+            return result;
+        }
+
+        uint64_t frames = 0U;
+        double elapsed_ms = 0.0;
+        db_benchmark_last_final(&frames, &elapsed_ms);
+        if (elapsed_ms > 0.0) {
+            const double pixels =
+                (double)frames * (double)step->width * (double)step->height;
+            mpix_per_s[i] = pixels / (elapsed_ms * DB_MS_PER_SECOND_D);
+        }
+        if (db_should_stop() != 0) {
+            break;
+        }
+    }
+    db_grid_size_set(base_width, base_height);
+
+    for (size_t i = 0U; i < step_count; i++) {
+        const db_resolution_sweep_step_t *step = &db_resolution_sweep_steps[i];
+        const double pixel_count =
+            (double)step->width * (double)step->height;
+        const double scaling =
+            (mpix_per_s[0] > 0.0) ? (mpix_per_s[i] / mpix_per_s[0]) : 0.0;
+        db_infof("display_dispatch",
+                 "resolution sweep result: %s %ux%u mpix=%.3f "
+                 "mpix_per_s=%.2f scaling_vs_%s=%.3f",
+                 step->label, step->width, step->height, pixel_count / 1.0e6,
+                 mpix_per_s[i], db_resolution_sweep_steps[0].label, scaling);
+    }
+    return EXIT_SUCCESS;
+}
+
+// Re-runs the whole display/renderer lifecycle --repeat times (each with
+// its own warmup) and reports the mean and 95% confidence interval of the
+// per-run throughput.
+static int db_run_repeat(db_display_t display, db_api_t api,
+                         db_gl_renderer_t renderer, const char *kms_card_path,
+                         const db_cli_config_t *cfg) {
+    double fps[DB_REPEAT_COUNT_MAX] = {0.0};
+    double ms_per_frame[DB_REPEAT_COUNT_MAX] = {0.0};
+    size_t run_count = 0U;
+    for (uint32_t i = 0U; i < cfg->repeat_count; i++) {
+        db_infof("display_dispatch", "repeat %u/%u", i + 1U,
+                 cfg->repeat_count);
+        const int result =
+            db_run_display_once(display, api, renderer, kms_card_path, cfg);
+        if (result != EXIT_SUCCESS) {
+            return result;
+        }
+        uint64_t frames = 0U;
+        double elapsed_ms = 0.0;
+        db_benchmark_last_final(&frames, &elapsed_ms);
+        if ((frames > 0U) && (elapsed_ms > 0.0)) {
+            ms_per_frame[run_count] = elapsed_ms / (double)frames;
+            fps[run_count] = DB_MS_PER_SECOND_D / ms_per_frame[run_count];
+            run_count++;
+        }
+        if (db_should_stop() != 0) {
+            break;
+        }
+    }
+
+    const db_stats_summary_t fps_stats = db_stats_summarize(fps, run_count);
+    const db_stats_summary_t ms_stats =
+        db_stats_summarize(ms_per_frame, run_count);
+    db_infof("display_dispatch",
+             "repeat summary: runs=%zu fps_mean=%.2f fps_ci95=+/-%.2f "
+             "fps_stddev=%.2f ms_per_frame_mean=%.4f "
+             "ms_per_frame_ci95=+/-%.4f",
+             run_count, fps_stats.mean, fps_stats.ci95_half_width,
+             fps_stats.stddev, ms_stats.mean, ms_stats.ci95_half_width);
+    const db_results_repeat_summary_t summary = {
+        .runs = (uint32_t)run_count,
+        .fps_mean = fps_stats.mean,
+        .fps_ci95 = fps_stats.ci95_half_width,
+        .ms_per_frame_mean = ms_stats.mean,
+        .ms_per_frame_ci95 = ms_stats.ci95_half_width,
+    };
+    db_results_record_repeat_summary(&summary);
+    return EXIT_SUCCESS;
+}
+
+static int db_sweep_renderer_fits_api(const db_cli_sweep_renderer_t *renderer,
+                                      db_api_t api) {
+    if (renderer->is_auto != 0) {
+        return 1;
+    }
+    if (renderer->is_cpu != 0) {
+        return api == DB_API_CPU;
+    }
+    return api == DB_API_OPENGL;
+}
+
+// Runs every mode x speed x renderer cell of the --sweep product, API by
+// API, in this process. Each cell re-creates its renderer; the glfw_window
+// display keeps its window and context between cells that ask for the same
+// context. Axes left out of --sweep keep the other flags.
+static int db_run_sweep_cells(db_display_t display, db_api_t api,
+                              db_gl_renderer_t renderer,
+                              const char *kms_card_path,
+                              const db_cli_config_t *cfg) {
+    const db_cli_sweep_t *sweep = &cfg->sweep;
+    const db_cli_sweep_renderer_t base_renderer = {
+        .name = "(default)",
+        .is_auto = (cfg->cpu_renderer_is_set == 0),
+        .is_cpu = cfg->cpu_renderer_is_set,
+        .cpu_renderer = cfg->cpu_renderer,
+        .gl_renderer = renderer,
+    };
+    const uint32_t api_count = db_u32_max(sweep->api_count, 1U);
+    const uint32_t renderer_count = db_u32_max(sweep->renderer_count, 1U);
+    const uint32_t mode_count = db_u32_max(sweep->mode_count, 1U);
+    const uint32_t speed_count = db_u32_max(sweep->speed_count, 1U);
+    uint32_t cell = 0U;
+    for (uint32_t a = 0U; a < api_count; a++) {
+        const db_api_t cell_api = (sweep->api_count > 0U) ? sweep->apis[a]
+                                                           : api;
+        if (db_dispatch_display_supports_api(display, cell_api) == 0) {
+            db_infof("display_dispatch",
+                     "sweep: skipping api=%s (unavailable for this display)",
+                     db_dispatch_api_name(cell_api));
+            continue;
+        }
+        for (uint32_t r = 0U; r < renderer_count; r++) {
+            const db_cli_sweep_renderer_t *cell_renderer =
+                (sweep->renderer_count > 0U) ? &sweep->renderers[r]
+                                             : &base_renderer;
+            if (db_sweep_renderer_fits_api(cell_renderer, cell_api) == 0) {
+                db_infof("display_dispatch",
+                         "sweep: skipping api=%s renderer=%s",
+                         db_dispatch_api_name(cell_api), cell_renderer->name);
+                continue;
+            }
+            db_cli_config_t cell_cfg = *cfg;
+            cell_cfg.sweep_enabled = 0;
+            cell_cfg.api = cell_api;
+            cell_cfg.api_is_auto = 0;
+            cell_cfg.cpu_renderer = (cell_renderer->is_cpu != 0)
+                                        ? cell_renderer->cpu_renderer
+                                        : DB_CPU_RENDERER_AUTO;
+            cell_cfg.cpu_renderer_is_set = cell_renderer->is_cpu;
+            db_gl_renderer_t cell_gl_renderer =
+                ((cell_renderer->is_auto == 0) && (cell_renderer->is_cpu == 0))
+                    ? cell_renderer->gl_renderer
+                    : renderer;
+            if (cell_api != DB_API_OPENGL) {
+                cell_gl_renderer = DB_GL_RENDERER_GL3_3;
+            }
+            cell_cfg.renderer = cell_gl_renderer;
+            for (uint32_t m = 0U; m < mode_count; m++) {
+                if (sweep->mode_count > 0U) {
+                    db_runtime_option_set(DB_RUNTIME_OPT_BENCHMARK_MODE,
+                                          sweep->modes[m]);
+                }
+                for (uint32_t s = 0U; s < speed_count; s++) {
+                    if (sweep->speed_count > 0U) {
+                        db_runtime_option_set(DB_RUNTIME_OPT_BENCH_SPEED,
+                                              sweep->speeds[s]);
+                    }
+                    const char *mode =
+                        db_runtime_option_get(DB_RUNTIME_OPT_BENCHMARK_MODE);
+                    const char *speed =
+                        db_runtime_option_get(DB_RUNTIME_OPT_BENCH_SPEED);
+                    cell++;
+                    db_infof("display_dispatch",
+                             "sweep cell %u: api=%s renderer=%s mode=%s "
+                             "speed=%s",
+                             cell, db_dispatch_api_name(cell_api),
+                             cell_renderer->name,
+                             (mode != NULL) ? mode : "(default)",
+                             (speed != NULL) ? speed : "1");
+                    const int result =
+                        db_run_display(display, cell_api, cell_gl_renderer,
+                                       kms_card_path, &cell_cfg);
+                    if (result != EXIT_SUCCESS) {
+                        return result;
+                    }
+                    if (db_should_stop() != 0) {
+                        return EXIT_SUCCESS;
+                    }
+                }
+            }
+        }
+    }
+    db_infof("display_dispatch", "sweep done: %u cells", cell);
+    return EXIT_SUCCESS;
+}
+
+static int db_run_sweep(db_display_t display, db_api_t api,
+                        db_gl_renderer_t renderer, const char *kms_card_path,
+                        const db_cli_config_t *cfg) {
+#ifdef DB_HAS_GLFW
+    db_glfw_window_reuse_set(display == DB_DISPLAY_GLFW_WINDOW);
+#endif
+    const int result =
+        db_run_sweep_cells(display, api, renderer, kms_card_path, cfg);
+#ifdef DB_HAS_GLFW
+    db_glfw_window_reuse_set(0);
+#endif
+    return result;
+}
+
 int db_run_display(db_display_t display, db_api_t api,
                    db_gl_renderer_t renderer, const char *kms_card_path,
                    const db_cli_config_t *cfg) {
+    if ((cfg != NULL) && (cfg->sweep_enabled != 0)) {
+        return db_run_sweep(display, api, renderer, kms_card_path, cfg);
+    }
+    if ((cfg != NULL) && (cfg->resolution_sweep != 0)) {
+        return db_run_resolution_sweep(display, api, renderer, kms_card_path,
+                                       cfg);
+    }
+    if ((cfg != NULL) && (cfg->repeat_count > 1U)) {
+        return db_run_repeat(display, api, renderer, kms_card_path, cfg);
+    }
+    return db_run_display_once(display, api, renderer, kms_card_path, cfg);
+}
+
+static int db_run_display_once(db_display_t display, db_api_t api,
+                               db_gl_renderer_t renderer,
+                               const char *kms_card_path,
+                               const db_cli_config_t *cfg) {
     if (db_dispatch_display_is_compiled(display) == 0) {
         db_failf("display_dispatch",
                  "requested display is unavailable in this build "
@@ -46,6 +311,7 @@ int db_run_display(db_display_t display, db_api_t api,
                  (int)display, (int)api);
     }
 
+    db_results_begin_run();
     if (display == DB_DISPLAY_OFFSCREEN) {
         return db_run_offscreen(api, renderer, cfg);
     }
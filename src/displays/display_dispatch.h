@@ -1,6 +1,8 @@
 #ifndef DRIVERBENCH_DISPLAY_DISPATCH_H
 #define DRIVERBENCH_DISPLAY_DISPATCH_H
 
+#define DB_REPEAT_COUNT_MAX 100U
+
 typedef struct db_cli_config db_cli_config_t;
 
 typedef enum {
@@ -149,6 +151,10 @@ int db_run_display_auto(db_display_t display, db_gl_renderer_t renderer,
                         const char *kms_card_path, const db_cli_config_t *cfg);
 int db_run_glfw_window(db_api_t api, db_gl_renderer_t renderer,
                        const db_cli_config_t *cfg);
+// While enabled, a glfw_window run parks its window and context on exit and
+// the next run asking for the same kind of context reuses it (--sweep).
+// Disabling destroys the parked window.
+void db_glfw_window_reuse_set(int enabled);
 int db_run_linux_kms_atomic(db_api_t api, db_gl_renderer_t renderer,
                             const char *card_path, const db_cli_config_t *cfg);
 int db_run_offscreen(db_api_t api, db_gl_renderer_t renderer,
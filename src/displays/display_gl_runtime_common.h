@@ -4,6 +4,7 @@
 #include <stdint.h>
 
 #include "../core/db_core.h"
+#include "../core/db_results.h"
 #include "../renderers/renderer_gl_common.h"
 
 #define DB_DISPLAY_GLES_RUNTIME_PARSE_ERROR_FMT                                \
@@ -33,6 +34,7 @@ static inline void db_display_log_runtime_api(const char *backend,
                                               const char *version_value,
                                               const char *renderer_label,
                                               const char *renderer_value) {
+    db_results_set_runtime_api(api_name, version_value, renderer_value);
     db_infof(backend, "runtime API: %s, %s: %s, %s: %s",
              (api_name != NULL) ? api_name : "(null)",
              (version_label != NULL) ? version_label : "version",
@@ -6,13 +6,22 @@
 
 #include "../core/db_core.h"
 #include "../core/db_hash.h"
+#include "../core/db_results.h"
+#include "../core/db_trace.h"
+#include "../renderers/renderer_benchmark_common.h"
 
 typedef struct {
     uint64_t aggregate_hash;
+    // Sum of db_hash_combine_term over the recorded frames.
+    uint64_t combined_hash;
+    // Absolute index of the next recorded frame; a run entered with
+    // --start-frame starts counting there.
+    uint64_t next_frame;
     int enabled;
     uint64_t final_hash;
     const char *hash_key;
     int report_aggregate;
+    int report_combined;
     int report_final;
 } db_display_hash_tracker_t;
 
@@ -55,6 +64,45 @@ db_display_resolve_hash_settings(int default_state_hash_enabled,
     };
 }
 
+static inline void db_display_log_output_hash_algo(const char *backend,
+                                                   int output_hash_enabled,
+                                                   db_hash_algo_t algo) {
+    if (output_hash_enabled == 0) {
+        return;
+    }
+    db_infof(backend, "output hash algorithm: %s (%s)",
+             db_hash_algo_name(algo), db_hash_algo_isa_name(algo));
+    db_results_set_hash_algo(db_hash_algo_name(algo));
+}
+
+// Folds the renderer's damage into the row-hash tree and returns the frame
+// digest; in validate mode every row is rehashed to catch missing damage.
+static inline uint64_t db_display_row_hash_update(
+    const char *backend, db_row_hash_tree_t *tree, db_hash_incremental_t mode,
+    const uint32_t *pixels, uint32_t width, uint32_t height,
+    const db_dirty_row_range_t *damage_rows, size_t damage_row_count) {
+    DB_TRACE_BEGIN("row_hash_update");
+    const uint8_t *bytes = (const uint8_t *)pixels;
+    const size_t stride_bytes = (size_t)width * 4U;
+    db_row_hash_tree_refresh(tree, bytes, width, height, stride_bytes, 0U, 0U);
+    for (size_t i = 0U; i < damage_row_count; i++) {
+        db_row_hash_tree_refresh(tree, bytes, width, height, stride_bytes,
+                                 damage_rows[i].row_start,
+                                 damage_rows[i].row_count);
+    }
+    if (mode == DB_HASH_INCREMENTAL_VALIDATE) {
+        const uint32_t stale_row =
+            db_row_hash_tree_find_stale_row(tree, bytes, stride_bytes);
+        if (stale_row != UINT32_MAX) {
+            db_failf(backend, "row %u changed outside the reported damage",
+                     stale_row);
+        }
+    }
+    const uint64_t digest = db_row_hash_tree_digest(tree);
+    DB_TRACE_END("row_hash_update");
+    return digest;
+}
+
 static inline db_display_hash_tracker_t
 db_display_hash_tracker_create(const char *backend, int enabled,
                                const char *hash_key,
@@ -80,10 +128,15 @@ db_display_hash_tracker_create(const char *backend, int enabled,
         tracker.report_final = 0;
         return tracker;
     }
+    if (strcmp(report_mode, "combined") == 0) {
+        tracker.report_aggregate = 0;
+        tracker.report_combined = 1;
+        return tracker;
+    }
     if (backend != NULL) {
         db_infof(backend,
                  "Invalid %s='%s'; using hash report mode 'both' "
-                 "(expected: final|aggregate|both)",
+                 "(expected: final|aggregate|combined|both)",
                  DB_RUNTIME_OPT_HASH_REPORT, report_mode);
     }
     return tracker;
@@ -98,6 +151,9 @@ db_display_hash_tracker_record(db_display_hash_tracker_t *tracker,
     tracker->final_hash = state_hash;
     tracker->aggregate_hash =
         db_fnv1a64_mix_u64(tracker->aggregate_hash, state_hash);
+    tracker->combined_hash +=
+        db_hash_combine_term(tracker->next_frame, state_hash);
+    tracker->next_frame++;
 }
 
 static inline void
@@ -107,6 +163,23 @@ db_display_hash_tracker_log_final(const char *backend,
         return;
     }
     const char *key = (tracker->hash_key != NULL) ? tracker->hash_key : "hash";
+    char result_key[64];
+    if (tracker->report_final != 0) {
+        (void)db_snprintf(result_key, sizeof(result_key), "%s_final", key);
+        db_results_set_hash(result_key, tracker->final_hash);
+    }
+    if (tracker->report_aggregate != 0) {
+        (void)db_snprintf(result_key, sizeof(result_key), "%s_aggregate", key);
+        db_results_set_hash(result_key, tracker->aggregate_hash);
+    }
+    if (tracker->report_combined != 0) {
+        (void)db_snprintf(result_key, sizeof(result_key), "%s_combined", key);
+        db_results_set_hash(result_key, tracker->combined_hash);
+        db_infof(backend, "%s_final=0x%016llx %s_combined=0x%016llx", key,
+                 (unsigned long long)tracker->final_hash, key,
+                 (unsigned long long)tracker->combined_hash);
+        return;
+    }
     if ((tracker->report_final != 0) && (tracker->report_aggregate != 0)) {
         db_infof(backend, "%s_final=0x%016llx %s_aggregate=0x%016llx", key,
                  (unsigned long long)tracker->final_hash, key,
@@ -0,0 +1,452 @@
+#include "display_hash_trace.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../core/db_core.h"
+#include "../core/db_trace.h"
+#include "../core/db_worker_pool.h"
+
+#define DB_HASH_TRACE_HEADER_BYTES (DB_HASH_TRACE_MAGIC_BYTES + 16U)
+// frame_index, render_width, render_height, runtime fields, then state,
+// output and band hashes.
+#define DB_HASH_TRACE_RECORD_U32S (3U + DB_HASH_TRACE_RUNTIME_FIELDS)
+#define DB_HASH_TRACE_RECORD_U64S (2U + DB_HASH_TRACE_ROW_BANDS)
+#define DB_HASH_TRACE_RECORD_BYTES                                             \
+    ((DB_HASH_TRACE_RECORD_U32S * 4U) + (DB_HASH_TRACE_RECORD_U64S * 8U))
+
+typedef struct {
+    uint32_t frame_index;
+    uint32_t render_width;
+    uint32_t render_height;
+    uint32_t runtime[DB_HASH_TRACE_RUNTIME_FIELDS];
+    uint64_t state_hash;
+    uint64_t output_hash;
+    uint64_t band_hashes[DB_HASH_TRACE_ROW_BANDS];
+} db_hash_trace_record_t;
+
+// db_benchmark_runtime_init_t fields in declaration order, except
+// gradient_planner: it picks how the gradient state is computed, not what it
+// is, so traces recorded with different planners must still compare equal.
+static const char *const g_hash_trace_runtime_names[] = {
+    "pattern",
+    "work_unit_count",
+    "draw_vertex_count",
+    "snake_shape_index",
+    "snake_cursor",
+    "snake_prev_start",
+    "snake_prev_count",
+    "snake_batch_size",
+    "snake_phase_completed",
+    "mode_phase_flag",
+    "gradient_head_row",
+    "gradient_cycle",
+    "bench_speed_step",
+    "random_seed",
+    "pattern_seed",
+};
+
+static void
+db_hash_trace_runtime_fields(const db_benchmark_runtime_init_t *runtime,
+                             uint32_t out[DB_HASH_TRACE_RUNTIME_FIELDS]) {
+    out[0] = (uint32_t)runtime->pattern;
+    out[1] = runtime->work_unit_count;
+    out[2] = runtime->draw_vertex_count;
+    out[3] = runtime->snake_shape_index;
+    out[4] = runtime->snake_cursor;
+    out[5] = runtime->snake_prev_start;
+    out[6] = runtime->snake_prev_count;
+    out[7] = runtime->snake_batch_size;
+    out[8] = (uint32_t)runtime->snake_phase_completed;
+    out[9] = (uint32_t)runtime->mode_phase_flag;
+    out[10] = runtime->gradient_head_row;
+    out[11] = runtime->gradient_cycle;
+    out[12] = runtime->bench_speed_step;
+    out[13] = runtime->random_seed;
+    out[14] = runtime->pattern_seed;
+}
+
+static void db_hash_trace_put_u32(uint8_t **cursor, uint32_t value) {
+    for (uint32_t i = 0U; i < 4U; i++) {
+        (*cursor)[i] = (uint8_t)(value >> (i * 8U));
+    }
+    *cursor += 4U;
+}
+
+static void db_hash_trace_put_u64(uint8_t **cursor, uint64_t value) {
+    for (uint32_t i = 0U; i < 8U; i++) {
+        (*cursor)[i] = (uint8_t)(value >> (i * 8U));
+    }
+    *cursor += 8U;
+}
+
+static uint32_t db_hash_trace_get_u32(const uint8_t **cursor) {
+    uint32_t value = 0U;
+    for (uint32_t i = 0U; i < 4U; i++) {
+        value |= (uint32_t)(*cursor)[i] << (i * 8U);
+    }
+    *cursor += 4U;
+    return value;
+}
+
+static uint64_t db_hash_trace_get_u64(const uint8_t **cursor) {
+    uint64_t value = 0U;
+    for (uint32_t i = 0U; i < 8U; i++) {
+        value |= (uint64_t)(*cursor)[i] << (i * 8U);
+    }
+    *cursor += 8U;
+    return value;
+}
+
+static void
+db_hash_trace_encode_record(const db_hash_trace_record_t *record,
+                            uint8_t bytes[DB_HASH_TRACE_RECORD_BYTES]) {
+    uint8_t *cursor = bytes;
+    db_hash_trace_put_u32(&cursor, record->frame_index);
+    db_hash_trace_put_u32(&cursor, record->render_width);
+    db_hash_trace_put_u32(&cursor, record->render_height);
+    for (uint32_t i = 0U; i < DB_HASH_TRACE_RUNTIME_FIELDS; i++) {
+        db_hash_trace_put_u32(&cursor, record->runtime[i]);
+    }
+    db_hash_trace_put_u64(&cursor, record->state_hash);
+    db_hash_trace_put_u64(&cursor, record->output_hash);
+    for (uint32_t i = 0U; i < DB_HASH_TRACE_ROW_BANDS; i++) {
+        db_hash_trace_put_u64(&cursor, record->band_hashes[i]);
+    }
+}
+
+static void
+db_hash_trace_decode_record(const uint8_t bytes[DB_HASH_TRACE_RECORD_BYTES],
+                            db_hash_trace_record_t *record) {
+    const uint8_t *cursor = bytes;
+    record->frame_index = db_hash_trace_get_u32(&cursor);
+    record->render_width = db_hash_trace_get_u32(&cursor);
+    record->render_height = db_hash_trace_get_u32(&cursor);
+    for (uint32_t i = 0U; i < DB_HASH_TRACE_RUNTIME_FIELDS; i++) {
+        record->runtime[i] = db_hash_trace_get_u32(&cursor);
+    }
+    record->state_hash = db_hash_trace_get_u64(&cursor);
+    record->output_hash = db_hash_trace_get_u64(&cursor);
+    for (uint32_t i = 0U; i < DB_HASH_TRACE_ROW_BANDS; i++) {
+        record->band_hashes[i] = db_hash_trace_get_u64(&cursor);
+    }
+}
+
+static void db_hash_trace_write_header(const db_display_hash_trace_t *trace,
+                                       const char *path) {
+    uint8_t header[DB_HASH_TRACE_HEADER_BYTES];
+    memcpy(header, DB_HASH_TRACE_MAGIC, DB_HASH_TRACE_MAGIC_BYTES);
+    uint8_t *cursor = header + DB_HASH_TRACE_MAGIC_BYTES;
+    db_hash_trace_put_u32(&cursor, DB_HASH_TRACE_VERSION);
+    db_hash_trace_put_u32(&cursor, DB_HASH_TRACE_RECORD_BYTES);
+    db_hash_trace_put_u32(&cursor, (uint32_t)trace->algo);
+    db_hash_trace_put_u32(&cursor, DB_HASH_TRACE_ROW_BANDS);
+    if (fwrite(header, sizeof(header), 1U, trace->write_file) != 1U) {
+        db_failf(trace->backend, "failed to write hash trace header: %s",
+                 path);
+    }
+}
+
+static void db_hash_trace_read_header(const db_display_hash_trace_t *trace) {
+    uint8_t header[DB_HASH_TRACE_HEADER_BYTES];
+    if ((fread(header, sizeof(header), 1U, trace->verify_file) != 1U) ||
+        (memcmp(header, DB_HASH_TRACE_MAGIC, DB_HASH_TRACE_MAGIC_BYTES) !=
+         0)) {
+        db_failf(trace->backend, "not a hash trace file: %s",
+                 trace->verify_path);
+    }
+    const uint8_t *cursor = header + DB_HASH_TRACE_MAGIC_BYTES;
+    const uint32_t version = db_hash_trace_get_u32(&cursor);
+    const uint32_t record_bytes = db_hash_trace_get_u32(&cursor);
+    const uint32_t algo = db_hash_trace_get_u32(&cursor);
+    const uint32_t bands = db_hash_trace_get_u32(&cursor);
+    if ((version != DB_HASH_TRACE_VERSION) ||
+        (record_bytes != DB_HASH_TRACE_RECORD_BYTES) ||
+        (bands != DB_HASH_TRACE_ROW_BANDS)) {
+        db_failf(trace->backend,
+                 "unsupported hash trace %s (version=%u record_bytes=%u "
+                 "bands=%u)",
+                 trace->verify_path, version, record_bytes, bands);
+    }
+    if (algo != (uint32_t)trace->algo) {
+        db_failf(trace->backend,
+                 "hash trace %s was recorded with --hash-algo %s (this run: "
+                 "%s)",
+                 trace->verify_path,
+                 db_hash_algo_name((db_hash_algo_t)algo),
+                 db_hash_algo_name(trace->algo));
+    }
+}
+
+int db_display_hash_trace_open(db_display_hash_trace_t *trace,
+                               const char *backend, const char *write_path,
+                               const char *verify_path, db_hash_algo_t algo) {
+    *trace = (db_display_hash_trace_t){0};
+    trace->backend = backend;
+    trace->algo = algo;
+    trace->verify_path = verify_path;
+    if (write_path != NULL) {
+        trace->write_file = fopen(write_path, "wb");
+        if (trace->write_file == NULL) {
+            db_failf(backend, "failed to open hash trace for writing: %s",
+                     write_path);
+        }
+        db_hash_trace_write_header(trace, write_path);
+        db_infof(backend, "writing hash trace: %s", write_path);
+    }
+    if (verify_path != NULL) {
+        trace->verify_file = fopen(verify_path, "rb");
+        if (trace->verify_file == NULL) {
+            db_failf(backend, "failed to open hash trace for verify: %s",
+                     verify_path);
+        }
+        db_hash_trace_read_header(trace);
+        db_infof(backend, "verifying against hash trace: %s", verify_path);
+    }
+    return (trace->write_file != NULL) || (trace->verify_file != NULL);
+}
+
+static void db_hash_trace_build_record(const db_display_hash_trace_t *trace,
+                                       uint32_t frame_index,
+                                       const db_benchmark_runtime_init_t *rt,
+                                       uint64_t state_hash,
+                                       const uint32_t *pixels, uint32_t width,
+                                       uint32_t height,
+                                       db_hash_trace_record_t *record) {
+    *record = (db_hash_trace_record_t){0};
+    record->frame_index = frame_index;
+    record->render_width = width;
+    record->render_height = height;
+    if (rt != NULL) {
+        db_hash_trace_runtime_fields(rt, record->runtime);
+    }
+    record->state_hash = state_hash;
+    const uint8_t *bytes = (const uint8_t *)pixels;
+    const size_t stride_bytes = (size_t)width * 4U;
+    // The pixels are read once: the output hash folds the band hashes
+    // rather than rehashing the frame the display already hashed.
+    DB_TRACE_BEGIN("hash_pixels");
+    uint64_t output_hash = DB_FNV1A64_OFFSET;
+    for (uint32_t band = 0U; band < DB_HASH_TRACE_ROW_BANDS; band++) {
+        uint32_t row_start = 0U;
+        uint32_t row_end = 0U;
+        db_worker_pool_split_rows(height, band, DB_HASH_TRACE_ROW_BANDS,
+                                  &row_start, &row_end);
+        if ((bytes != NULL) && (row_end > row_start)) {
+            record->band_hashes[band] = db_hash_rgba8_pixels(
+                trace->algo, bytes + ((size_t)row_start * stride_bytes),
+                width, row_end - row_start, stride_bytes, 0);
+        }
+        output_hash =
+            db_fnv1a64_mix_u64(output_hash, record->band_hashes[band]);
+    }
+    record->output_hash = output_hash;
+    DB_TRACE_END("hash_pixels");
+}
+
+static int db_hash_trace_records_match(const db_hash_trace_record_t *lhs,
+                                       const db_hash_trace_record_t *rhs) {
+    if ((lhs->frame_index != rhs->frame_index) ||
+        (lhs->render_width != rhs->render_width) ||
+        (lhs->render_height != rhs->render_height) ||
+        (lhs->state_hash != rhs->state_hash) ||
+        (lhs->output_hash != rhs->output_hash)) {
+        return 0;
+    }
+    for (uint32_t i = 0U; i < DB_HASH_TRACE_RUNTIME_FIELDS; i++) {
+        if (lhs->runtime[i] != rhs->runtime[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void db_hash_trace_log_u32_field(const char *backend, const char *name,
+                                        uint32_t expected, uint32_t actual) {
+    db_infof(backend, "  %-22s expected=%-10u actual=%u%s", name,
+             expected, actual, (expected != actual) ? " <-- differs" : "");
+}
+
+static void db_hash_trace_report_divergence(
+    const db_display_hash_trace_t *trace,
+    const db_hash_trace_record_t *expected,
+    const db_hash_trace_record_t *actual) {
+    const char *backend = trace->backend;
+    db_infof(backend, "hash verify: first divergence at frame %u (%s)",
+             actual->frame_index, trace->verify_path);
+    db_infof(backend, "  state_hash  expected=0x%016llx actual=0x%016llx",
+             (unsigned long long)expected->state_hash,
+             (unsigned long long)actual->state_hash);
+    db_infof(backend, "  output_hash expected=0x%016llx actual=0x%016llx",
+             (unsigned long long)expected->output_hash,
+             (unsigned long long)actual->output_hash);
+    db_hash_trace_log_u32_field(backend, "frame_index",
+                                expected->frame_index, actual->frame_index);
+    db_hash_trace_log_u32_field(backend, "render_width",
+                                expected->render_width, actual->render_width);
+    db_hash_trace_log_u32_field(backend, "render_height",
+                                expected->render_height,
+                                actual->render_height);
+    for (uint32_t i = 0U; i < DB_HASH_TRACE_RUNTIME_FIELDS; i++) {
+        db_hash_trace_log_u32_field(backend, g_hash_trace_runtime_names[i],
+                                    expected->runtime[i], actual->runtime[i]);
+    }
+
+    if ((expected->render_width != actual->render_width) ||
+        (expected->render_height != actual->render_height)) {
+        db_infof(backend, "  pixel diff skipped: frame sizes differ");
+        return;
+    }
+    // Merge adjacent differing bands into row ranges.
+    uint32_t band = 0U;
+    while (band < DB_HASH_TRACE_ROW_BANDS) {
+        if (expected->band_hashes[band] == actual->band_hashes[band]) {
+            band++;
+            continue;
+        }
+        const uint32_t first_band = band;
+        while ((band < DB_HASH_TRACE_ROW_BANDS) &&
+               (expected->band_hashes[band] != actual->band_hashes[band])) {
+            band++;
+        }
+        uint32_t row_start = 0U;
+        uint32_t row_end = 0U;
+        uint32_t unused = 0U;
+        db_worker_pool_split_rows(actual->render_height, first_band,
+                                  DB_HASH_TRACE_ROW_BANDS, &row_start,
+                                  &unused);
+        db_worker_pool_split_rows(actual->render_height, band - 1U,
+                                  DB_HASH_TRACE_ROW_BANDS, &unused, &row_end);
+        db_infof(backend, "  pixel rows differ: [%u, %u)", row_start, row_end);
+    }
+}
+
+void db_display_hash_trace_frame(db_display_hash_trace_t *trace,
+                                 uint32_t frame_index,
+                                 const db_benchmark_runtime_init_t *runtime,
+                                 uint64_t state_hash, const uint32_t *pixels,
+                                 uint32_t width, uint32_t height) {
+    if ((trace->write_file == NULL) && (trace->verify_file == NULL)) {
+        return;
+    }
+    db_hash_trace_record_t record;
+    db_hash_trace_build_record(trace, frame_index, runtime, state_hash, pixels,
+                               width, height, &record);
+    uint8_t bytes[DB_HASH_TRACE_RECORD_BYTES];
+
+    if (trace->write_file != NULL) {
+        db_hash_trace_encode_record(&record, bytes);
+        if (fwrite(bytes, sizeof(bytes), 1U, trace->write_file) != 1U) {
+            db_failf(trace->backend, "failed to write hash trace frame %u",
+                     frame_index);
+        }
+        trace->frames_written++;
+    }
+
+    if ((trace->verify_file == NULL) || (trace->verify_exhausted != 0)) {
+        return;
+    }
+    if (fread(bytes, sizeof(bytes), 1U, trace->verify_file) != 1U) {
+        trace->verify_exhausted = 1;
+        db_infof(trace->backend,
+                 "hash verify: trace ended after %llu frames; later frames "
+                 "are unchecked",
+                 (unsigned long long)trace->frames_verified);
+        return;
+    }
+    db_hash_trace_record_t expected;
+    db_hash_trace_decode_record(bytes, &expected);
+    if (db_hash_trace_records_match(&expected, &record) == 0) {
+        db_hash_trace_report_divergence(trace, &expected, &record);
+        db_failf(trace->backend, "hash verify failed at frame %u",
+                 frame_index);
+    }
+    trace->frames_verified++;
+}
+
+// Reads the frame index of the record at `offset`; 0 past the end.
+static int db_hash_trace_frame_at(FILE *file, long offset,
+                                  uint32_t *out_frame) {
+    uint8_t bytes[DB_HASH_TRACE_RECORD_BYTES];
+    if ((fseek(file, offset, SEEK_SET) != 0) ||
+        (fread(bytes, sizeof(bytes), 1U, file) != 1U)) {
+        return 0;
+    }
+    db_hash_trace_record_t record;
+    db_hash_trace_decode_record(bytes, &record);
+    *out_frame = record.frame_index;
+    return 1;
+}
+
+int db_display_hash_trace_skip_verify(db_display_hash_trace_t *trace,
+                                      uint32_t first_frame) {
+    if ((trace->verify_file == NULL) || (trace->verify_exhausted != 0)) {
+        return 0;
+    }
+    const long base = ftell(trace->verify_file);
+    const long record_bytes = (long)DB_HASH_TRACE_RECORD_BYTES;
+    uint32_t frame = 0U;
+    long offset = base;
+    int found = db_hash_trace_frame_at(trace->verify_file, offset, &frame);
+    if ((found != 0) && (frame < first_frame)) {
+        // A trace of consecutive frames holds first_frame at a fixed offset.
+        const long direct = base + ((long)(first_frame - frame) * record_bytes);
+        uint32_t direct_frame = 0U;
+        if ((db_hash_trace_frame_at(trace->verify_file, direct,
+                                    &direct_frame) != 0) &&
+            (direct_frame == first_frame)) {
+            offset = direct;
+            frame = direct_frame;
+        } else {
+            while ((found != 0) && (frame < first_frame)) {
+                offset += record_bytes;
+                found = db_hash_trace_frame_at(trace->verify_file, offset,
+                                               &frame);
+            }
+        }
+    }
+    if ((found == 0) ||
+        (fseek(trace->verify_file, offset, SEEK_SET) != 0)) {
+        trace->verify_exhausted = 1;
+        db_infof(trace->backend,
+                 "hash verify: %s has no frame at or after %u; frames are "
+                 "unchecked",
+                 trace->verify_path, first_frame);
+        return 0;
+    }
+    return 1;
+}
+
+int db_display_hash_trace_next_verify_frame(db_display_hash_trace_t *trace,
+                                            uint32_t *out_frame) {
+    if ((trace->verify_file == NULL) || (trace->verify_exhausted != 0)) {
+        return 0;
+    }
+    const long offset = ftell(trace->verify_file);
+    const int found =
+        db_hash_trace_frame_at(trace->verify_file, offset, out_frame);
+    if ((offset < 0L) ||
+        (fseek(trace->verify_file, offset, SEEK_SET) != 0)) {
+        trace->verify_exhausted = 1;
+        return 0;
+    }
+    return found;
+}
+
+void db_display_hash_trace_close(db_display_hash_trace_t *trace) {
+    if (trace->write_file != NULL) {
+        if (fclose(trace->write_file) != 0) {
+            db_failf(trace->backend, "failed to close hash trace");
+        }
+        db_infof(trace->backend, "hash trace: %llu frames written",
+                 (unsigned long long)trace->frames_written);
+    }
+    if (trace->verify_file != NULL) {
+        (void)fclose(trace->verify_file);
+        db_infof(trace->backend, "hash verify: %llu frames matched",
+                 (unsigned long long)trace->frames_verified);
+    }
+    *trace = (db_display_hash_trace_t){0};
+}
@@ -0,0 +1,56 @@
+#ifndef DRIVERBENCH_DISPLAY_HASH_TRACE_H
+#define DRIVERBENCH_DISPLAY_HASH_TRACE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "../core/db_hash.h"
+#include "../renderers/renderer_benchmark_common.h"
+
+#define DB_HASH_TRACE_MAGIC "DBHTRACE"
+#define DB_HASH_TRACE_MAGIC_BYTES 8U
+#define DB_HASH_TRACE_VERSION 2U
+#define DB_HASH_TRACE_RUNTIME_FIELDS 15U
+// --checkpoint-interval default: one hash trace record per 65536 frames.
+#define DB_HASH_TRACE_CHECKPOINT_INTERVAL 65536U
+// Output rows are hashed in this many horizontal bands per frame so a
+// verify mismatch can be narrowed to row ranges without storing pixels.
+#define DB_HASH_TRACE_ROW_BANDS 32U
+
+typedef struct {
+    const char *backend;
+    FILE *write_file;
+    FILE *verify_file;
+    const char *verify_path;
+    db_hash_algo_t algo;
+    uint64_t frames_written;
+    uint64_t frames_verified;
+    int verify_exhausted;
+} db_display_hash_trace_t;
+
+// Opens --hash-trace (write) and/or --hash-verify (read) files; either path
+// may be NULL. Returns 0 when neither is requested.
+int db_display_hash_trace_open(db_display_hash_trace_t *trace,
+                               const char *backend, const char *write_path,
+                               const char *verify_path, db_hash_algo_t algo);
+// Records (and/or checks) one presented frame. On the first frame that
+// differs from the verify trace, logs both runtime structs and the row
+// ranges whose band hashes differ, then fails.
+void db_display_hash_trace_frame(db_display_hash_trace_t *trace,
+                                 uint32_t frame_index,
+                                 const db_benchmark_runtime_init_t *runtime,
+                                 uint64_t state_hash, const uint32_t *pixels,
+                                 uint32_t width, uint32_t height);
+// Positions the verify stream on the first record of frame `first_frame` or
+// later, so a run entered with --start-frame is checked against a trace of a
+// run from frame 0. Returns 0 and stops verifying when there is none.
+int db_display_hash_trace_skip_verify(db_display_hash_trace_t *trace,
+                                      uint32_t first_frame);
+// Frame index of the record the verify stream compares next, so a sparse
+// trace such as --checkpoint-file is only checked on the frames it holds.
+// Returns 0 when verification is off or the trace is exhausted.
+int db_display_hash_trace_next_verify_frame(db_display_hash_trace_t *trace,
+                                            uint32_t *out_frame);
+void db_display_hash_trace_close(db_display_hash_trace_t *trace);
+
+#endif
@@ -0,0 +1,208 @@
+#include "display_hash_worker.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../core/db_core.h"
+#include "../core/db_trace.h"
+
+#define DB_HASH_WORKER_SLOT_DAMAGE_MAX 2U
+
+typedef struct {
+    uint32_t *pixels;
+    size_t pixel_capacity;
+    uint32_t width;
+    uint32_t height;
+    db_dirty_row_range_t damage_rows[DB_HASH_WORKER_SLOT_DAMAGE_MAX];
+    size_t damage_row_count;
+} db_hash_worker_slot_t;
+
+struct db_display_hash_worker {
+    const char *backend;
+    db_display_hash_tracker_t *tracker;
+    db_row_hash_tree_t *row_hash_tree;
+    db_hash_algo_t algo;
+    db_hash_incremental_t incremental;
+    db_hash_worker_slot_t *slots;
+    uint32_t queue_depth;
+    // Slots [head, head + count) are queued; slots[head] may be in use by
+    // the worker until count is decremented.
+    uint32_t head;
+    uint32_t count;
+    int stopping;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty_cond;
+    pthread_cond_t not_full_cond;
+    db_display_hash_worker_stats_t stats;
+};
+
+static void db_hash_worker_hash_slot(db_display_hash_worker_t *worker,
+                                     const db_hash_worker_slot_t *slot) {
+    uint64_t hash = 0U;
+    if (worker->incremental != DB_HASH_INCREMENTAL_OFF) {
+        hash = db_display_row_hash_update(
+            worker->backend, worker->row_hash_tree, worker->incremental,
+            slot->pixels, slot->width, slot->height, slot->damage_rows,
+            slot->damage_row_count);
+    } else {
+        DB_TRACE_BEGIN("hash_pixels");
+        hash = db_hash_rgba8_pixels(worker->algo,
+                                    (const uint8_t *)slot->pixels,
+                                    slot->width, slot->height,
+                                    (size_t)slot->width * 4U, 0);
+        DB_TRACE_END("hash_pixels");
+    }
+    db_display_hash_tracker_record(worker->tracker, hash);
+}
+
+static void *db_hash_worker_thread_main(void *arg) {
+    db_display_hash_worker_t *worker = (db_display_hash_worker_t *)arg;
+    db_trace_thread_name("hash worker");
+    (void)pthread_mutex_lock(&worker->mutex);
+    for (;;) {
+        while ((worker->count == 0U) && (worker->stopping == 0)) {
+            (void)pthread_cond_wait(&worker->not_empty_cond, &worker->mutex);
+        }
+        if (worker->count == 0U) {
+            break;
+        }
+        const db_hash_worker_slot_t *slot = &worker->slots[worker->head];
+        (void)pthread_mutex_unlock(&worker->mutex);
+
+        db_hash_worker_hash_slot(worker, slot);
+
+        (void)pthread_mutex_lock(&worker->mutex);
+        worker->head = (worker->head + 1U) % worker->queue_depth;
+        worker->count--;
+        worker->stats.frames_hashed++;
+        (void)pthread_cond_signal(&worker->not_full_cond);
+    }
+    (void)pthread_mutex_unlock(&worker->mutex);
+    return NULL;
+}
+
+db_display_hash_worker_t *db_display_hash_worker_create(
+    const char *backend, uint32_t queue_depth,
+    db_display_hash_tracker_t *tracker, db_hash_algo_t algo,
+    db_hash_incremental_t incremental, db_row_hash_tree_t *row_hash_tree) {
+    if ((queue_depth == 0U) || (queue_depth > DB_HASH_QUEUE_DEPTH_MAX)) {
+        db_failf(backend, "invalid hash queue depth: %u (max: %u)",
+                 queue_depth, DB_HASH_QUEUE_DEPTH_MAX);
+    }
+    db_display_hash_worker_t *worker =
+        (db_display_hash_worker_t *)db_alloc_array_or_fail(
+            backend, "hash_worker", 1U, sizeof(db_display_hash_worker_t));
+    *worker = (db_display_hash_worker_t){0};
+    worker->backend = backend;
+    worker->tracker = tracker;
+    worker->row_hash_tree = row_hash_tree;
+    worker->algo = algo;
+    worker->incremental = incremental;
+    worker->queue_depth = queue_depth;
+    worker->slots = (db_hash_worker_slot_t *)db_alloc_array_or_fail(
+        backend, "hash_worker.slots", queue_depth,
+        sizeof(db_hash_worker_slot_t));
+    memset(worker->slots, 0, queue_depth * sizeof(db_hash_worker_slot_t));
+
+    if ((pthread_mutex_init(&worker->mutex, NULL) != 0) ||
+        (pthread_cond_init(&worker->not_empty_cond, NULL) != 0) ||
+        (pthread_cond_init(&worker->not_full_cond, NULL) != 0)) {
+        db_failf(backend, "failed to initialize hash worker sync primitives");
+    }
+    if (pthread_create(&worker->thread, NULL, db_hash_worker_thread_main,
+                       worker) != 0) {
+        db_failf(backend, "failed to create hash worker thread");
+    }
+    db_infof(backend, "hash worker started (queue depth: %u)", queue_depth);
+    return worker;
+}
+
+void db_display_hash_worker_submit(db_display_hash_worker_t *worker,
+                                   const uint32_t *pixels, uint32_t width,
+                                   uint32_t height,
+                                   const db_dirty_row_range_t *damage_rows,
+                                   size_t damage_row_count) {
+    (void)pthread_mutex_lock(&worker->mutex);
+    if (worker->count == worker->queue_depth) {
+        const uint64_t stall_start_ns = db_now_ns_monotonic();
+        DB_TRACE_BEGIN("hash_queue_stall");
+        while (worker->count == worker->queue_depth) {
+            (void)pthread_cond_wait(&worker->not_full_cond, &worker->mutex);
+        }
+        DB_TRACE_END("hash_queue_stall");
+        worker->stats.stall_ns += db_now_ns_monotonic() - stall_start_ns;
+    }
+    const uint32_t lag_frames = worker->count;
+    worker->stats.lag_frames_total += lag_frames;
+    worker->stats.lag_frames_max =
+        db_u32_max(worker->stats.lag_frames_max, lag_frames);
+    db_hash_worker_slot_t *slot =
+        &worker->slots[(worker->head + worker->count) % worker->queue_depth];
+    (void)pthread_mutex_unlock(&worker->mutex);
+
+    // The worker does not look at this slot until count covers it.
+    const size_t pixel_count = (size_t)width * (size_t)height;
+    if (pixel_count > slot->pixel_capacity) {
+        free(slot->pixels);
+        slot->pixels = (uint32_t *)db_alloc_array_or_fail(
+            worker->backend, "hash_worker.snapshot", pixel_count,
+            sizeof(uint32_t));
+        slot->pixel_capacity = pixel_count;
+    }
+    if ((pixels != NULL) && (pixel_count > 0U)) {
+        memcpy(slot->pixels, pixels, pixel_count * sizeof(uint32_t));
+    }
+    slot->width = width;
+    slot->height = height;
+    if (damage_row_count <= DB_HASH_WORKER_SLOT_DAMAGE_MAX) {
+        for (size_t i = 0U; i < damage_row_count; i++) {
+            slot->damage_rows[i] = damage_rows[i];
+        }
+        slot->damage_row_count = damage_row_count;
+    } else {
+        slot->damage_rows[0] = (db_dirty_row_range_t){0U, height};
+        slot->damage_row_count = 1U;
+    }
+
+    (void)pthread_mutex_lock(&worker->mutex);
+    worker->count++;
+    (void)pthread_cond_signal(&worker->not_empty_cond);
+    (void)pthread_mutex_unlock(&worker->mutex);
+}
+
+void db_display_hash_worker_finish(db_display_hash_worker_t *worker,
+                                   db_display_hash_worker_stats_t *out_stats) {
+    if (worker == NULL) {
+        return;
+    }
+    (void)pthread_mutex_lock(&worker->mutex);
+    worker->stopping = 1;
+    (void)pthread_cond_signal(&worker->not_empty_cond);
+    (void)pthread_mutex_unlock(&worker->mutex);
+    (void)pthread_join(worker->thread, NULL);
+
+    const db_display_hash_worker_stats_t stats = worker->stats;
+    const double lag_avg =
+        (stats.frames_hashed > 0U)
+            ? ((double)stats.lag_frames_total / (double)stats.frames_hashed)
+            : 0.0;
+    db_infof(worker->backend,
+             "hash worker: frames=%llu lag_avg=%.2f lag_max=%u stall_ms=%.3f",
+             (unsigned long long)stats.frames_hashed, lag_avg,
+             stats.lag_frames_max, (double)stats.stall_ns / DB_NS_PER_MS_D);
+    if (out_stats != NULL) {
+        *out_stats = stats;
+    }
+
+    (void)pthread_cond_destroy(&worker->not_full_cond);
+    (void)pthread_cond_destroy(&worker->not_empty_cond);
+    (void)pthread_mutex_destroy(&worker->mutex);
+    for (uint32_t i = 0U; i < worker->queue_depth; i++) {
+        free(worker->slots[i].pixels);
+    }
+    free(worker->slots);
+    free(worker);
+}
@@ -0,0 +1,43 @@
+#ifndef DRIVERBENCH_DISPLAY_HASH_WORKER_H
+#define DRIVERBENCH_DISPLAY_HASH_WORKER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../core/db_hash.h"
+#include "../renderers/renderer_benchmark_common.h"
+#include "display_hash_common.h"
+
+#define DB_HASH_QUEUE_DEPTH_MAX 64U
+
+typedef struct db_display_hash_worker db_display_hash_worker_t;
+
+typedef struct {
+    uint64_t frames_hashed;
+    uint64_t stall_ns;
+    uint64_t lag_frames_total;
+    uint32_t lag_frames_max;
+} db_display_hash_worker_stats_t;
+
+// Hashes output frames on a background thread. Each submitted frame is
+// copied into one of queue_depth snapshot slots (the CPU renderer reuses
+// its BOs, so the pixels cannot be referenced), letting the render loop run
+// up to queue_depth frames ahead. Results are folded into tracker in frame
+// order; tracker and row_hash_tree (used when incremental is not OFF)
+// belong to the worker until db_display_hash_worker_finish returns.
+db_display_hash_worker_t *db_display_hash_worker_create(
+    const char *backend, uint32_t queue_depth,
+    db_display_hash_tracker_t *tracker, db_hash_algo_t algo,
+    db_hash_incremental_t incremental, db_row_hash_tree_t *row_hash_tree);
+// Blocks only while every snapshot slot is still waiting to be hashed.
+void db_display_hash_worker_submit(db_display_hash_worker_t *worker,
+                                   const uint32_t *pixels, uint32_t width,
+                                   uint32_t height,
+                                   const db_dirty_row_range_t *damage_rows,
+                                   size_t damage_row_count);
+// Drains the queue, joins the thread, logs lag/stall stats and frees the
+// worker. out_stats may be NULL.
+void db_display_hash_worker_finish(db_display_hash_worker_t *worker,
+                                   db_display_hash_worker_stats_t *out_stats);
+
+#endif
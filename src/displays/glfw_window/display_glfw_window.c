@@ -9,6 +9,8 @@
 
 #include "../../core/db_core.h"
 #include "../../core/db_hash.h"
+#include "../../core/db_perf_counters.h"
+#include "../../core/db_trace.h"
 #include "../../driverbench_cli.h"
 #ifdef DB_HAS_OPENGL_API
 #include "../../renderers/cpu_renderer/renderer_cpu_renderer.h"
@@ -27,6 +29,8 @@
 #include "../display_dispatch.h"
 #include "../display_gl_runtime_common.h"
 #include "../display_hash_common.h"
+#include "../display_hash_trace.h"
+#include "../display_hash_worker.h"
 #include "display_glfw_window_common.h"
 #ifdef DB_HAS_OPENGL_API
 #include "../display_gl_hash_readback_common.h"
@@ -82,18 +86,25 @@ typedef struct {
 
 static uint64_t db_glfw_run_loop(const db_glfw_loop_t *loop) {
     uint64_t frames = 0U;
+    db_benchmark_frame_times_begin(loop->fps_cap);
     while (!glfwWindowShouldClose(loop->window) && !db_should_stop()) {
         if ((loop->frame_limit > 0U) && (frames >= loop->frame_limit)) {
             break;
         }
         const double frame_start_s = db_glfw_time_seconds();
+        const uint64_t frame_start_ns = db_now_ns_monotonic();
         db_glfw_poll_events();
         const db_glfw_loop_result_t frame_result =
             loop->frame_fn(loop->user_data, frames);
         if (frame_result == DB_GLFW_LOOP_STOP) {
             break;
         }
-        db_glfw_sleep_to_fps_cap(loop->backend, frame_start_s, loop->fps_cap);
+        if (frame_result != DB_GLFW_LOOP_RETRY) {
+            db_benchmark_frame_time_record_ns(
+                (uint64_t)((db_glfw_time_seconds() - frame_start_s) *
+                           DB_NS_PER_SECOND_D));
+        }
+        db_sleep_to_fps_cap(loop->backend, frame_start_ns, loop->fps_cap);
         if (frame_result != DB_GLFW_LOOP_RETRY) {
             frames++;
         }
@@ -136,7 +147,14 @@ typedef struct {
     db_display_hash_tracker_t *bo_hash_tracker;
     int state_hash_enabled;
     int output_hash_enabled;
+    db_hash_algo_t output_hash_algo;
+    db_hash_incremental_t output_hash_incremental;
+    db_row_hash_tree_t *row_hash_tree;
+    db_display_hash_worker_t *hash_worker;
+    db_display_hash_trace_t *hash_trace;
+    int hash_trace_enabled;
     db_cpu_present_gl_state_t *present;
+    const db_cpu_renderer_vtable_t *renderer;
     uint32_t work_unit_count;
     GLFWwindow *window;
 } db_glfw_cpu_loop_ctx_t;
@@ -153,6 +171,7 @@ typedef struct {
     db_gl_renderer_t renderer;
     int state_hash_enabled;
     int output_hash_enabled;
+    db_hash_algo_t output_hash_algo;
     uint32_t work_unit_count;
     GLFWwindow *window;
 } db_glfw_opengl_loop_ctx_t;
@@ -350,12 +369,13 @@ static void db_present_cpu_upload_spans(db_cpu_present_gl_state_t *state,
 
 static void db_present_cpu_framebuffer(GLFWwindow *window,
                                        db_cpu_present_gl_state_t *state,
+                                       const db_cpu_renderer_vtable_t *renderer,
                                        const db_dirty_row_range_t *ranges,
                                        size_t range_count) {
     uint32_t pixel_width = 0U;
     uint32_t pixel_height = 0U;
     const uint32_t *pixels =
-        db_renderer_cpu_renderer_pixels_rgba8(&pixel_width, &pixel_height);
+        renderer->pixels_rgba8(&pixel_width, &pixel_height);
     if ((pixels == NULL) || (pixel_width == 0U) || (pixel_height == 0U)) {
         db_failf(BACKEND_NAME_CPU, "cpu renderer returned invalid framebuffer");
     }
@@ -430,33 +450,72 @@ static void db_present_cpu_framebuffer(GLFWwindow *window,
 static db_glfw_loop_result_t db_glfw_cpu_frame(void *user_data,
                                                uint32_t frame_index) {
     db_glfw_cpu_loop_ctx_t *ctx = (db_glfw_cpu_loop_ctx_t *)user_data;
-    db_renderer_cpu_renderer_render_frame(frame_index);
+    db_perf_counters_phase(DB_PERF_PHASE_RENDER);
+    ctx->renderer->render_frame(frame_index);
     size_t damage_count = 0U;
     const db_dirty_row_range_t *damage_ranges =
-        db_renderer_cpu_renderer_damage_rows(&damage_count);
-    db_present_cpu_framebuffer(ctx->window, ctx->present, damage_ranges,
-                               damage_count);
+        ctx->renderer->damage_rows(&damage_count);
+    db_perf_counters_phase(DB_PERF_PHASE_PRESENT);
+    db_present_cpu_framebuffer(ctx->window, ctx->present, ctx->renderer,
+                               damage_ranges, damage_count);
+
+    db_perf_counters_phase(DB_PERF_PHASE_HASH);
 
     if (ctx->state_hash_enabled != 0) {
-        const uint64_t state_hash = db_renderer_cpu_renderer_state_hash();
+        const uint64_t state_hash = ctx->renderer->state_hash();
         db_display_hash_tracker_record(ctx->state_hash_tracker, state_hash);
     }
-    if (ctx->output_hash_enabled != 0) {
+    if (ctx->hash_trace_enabled != 0) {
+        uint32_t pixel_width = 0U;
+        uint32_t pixel_height = 0U;
+        const uint32_t *pixels =
+            ctx->renderer->pixels_rgba8(&pixel_width, &pixel_height);
+        db_display_hash_trace_frame(ctx->hash_trace, frame_index,
+                                    ctx->renderer->runtime_state(),
+                                    ctx->renderer->state_hash(), pixels,
+                                    pixel_width, pixel_height);
+    }
+    if (ctx->hash_worker != NULL) {
+        uint32_t pixel_width = 0U;
+        uint32_t pixel_height = 0U;
+        const uint32_t *pixels =
+            ctx->renderer->pixels_rgba8(&pixel_width, &pixel_height);
+        if (pixels == NULL) {
+            db_failf(BACKEND_NAME_CPU,
+                     "cpu renderer returned invalid framebuffer");
+        }
+        db_display_hash_worker_submit(ctx->hash_worker, pixels, pixel_width,
+                                      pixel_height, damage_ranges,
+                                      damage_count);
+    } else if (ctx->output_hash_enabled != 0) {
         uint32_t pixel_width = 0U;
         uint32_t pixel_height = 0U;
         const uint32_t *pixels =
-            db_renderer_cpu_renderer_pixels_rgba8(&pixel_width, &pixel_height);
+            ctx->renderer->pixels_rgba8(&pixel_width, &pixel_height);
         if (pixels == NULL) {
             db_failf(BACKEND_NAME_CPU,
                      "cpu renderer returned invalid framebuffer");
         }
-        const uint64_t bo_hash = db_hash_rgba8_pixels_canonical(
-            (const uint8_t *)pixels, pixel_width, pixel_height,
-            (size_t)pixel_width * 4U, 0);
+        uint64_t bo_hash = 0U;
+        if (ctx->output_hash_incremental != DB_HASH_INCREMENTAL_OFF) {
+            bo_hash = db_display_row_hash_update(
+                BACKEND_NAME_CPU, ctx->row_hash_tree,
+                ctx->output_hash_incremental, pixels, pixel_width,
+                pixel_height, damage_ranges, damage_count);
+        } else {
+            DB_TRACE_BEGIN("hash_pixels");
+            bo_hash = db_hash_rgba8_pixels(
+                ctx->output_hash_algo, (const uint8_t *)pixels, pixel_width,
+                pixel_height, (size_t)pixel_width * 4U, 0);
+            DB_TRACE_END("hash_pixels");
+        }
         db_display_hash_tracker_record(ctx->bo_hash_tracker, bo_hash);
     }
 
+    db_perf_counters_phase(DB_PERF_PHASE_PRESENT);
+    DB_TRACE_BEGIN("swap_buffers");
     glfwSwapBuffers(ctx->window);
+    DB_TRACE_END("swap_buffers");
     const uint64_t logged_frames = frame_index + 1U;
     const double bench_ms =
         (db_glfw_time_seconds() - ctx->bench_start) * DB_MS_PER_SECOND_D;
@@ -479,13 +538,19 @@ static int db_run_glfw_window_cpu(const db_cli_config_t *cfg) {
     const uint32_t frame_limit = (cfg != NULL) ? cfg->frame_limit : 0U;
     const db_display_hash_settings_t hash_settings =
         db_glfw_hash_settings_for_backend(cfg);
+    const db_hash_algo_t output_hash_algo =
+        (cfg != NULL) ? cfg->hash_algo : DB_HASH_ALGO_FNV1A;
+    const db_hash_incremental_t output_hash_incremental =
+        (cfg != NULL) ? cfg->hash_incremental : DB_HASH_INCREMENTAL_OFF;
+    db_row_hash_tree_t row_hash_tree;
+    db_row_hash_tree_init(&row_hash_tree, output_hash_algo);
 
     const int gl_legacy_context_major = 2;
     const int gl_legacy_context_minor = 1;
     int is_gles = 0;
     GLFWwindow *window = db_glfw_create_gl1_5_or_gles1_1_window(
         BACKEND_NAME_CPU, "CPU Renderer GLFW DriverBench",
-        BENCH_WINDOW_WIDTH_PX, BENCH_WINDOW_HEIGHT_PX, gl_legacy_context_major,
+        (int)db_grid_width(), (int)db_grid_height(), gl_legacy_context_major,
         gl_legacy_context_minor, swap_interval, &is_gles,
         (cfg != NULL) ? cfg->offscreen_enabled : 0);
 
@@ -507,7 +572,9 @@ static int db_run_glfw_window_cpu(const db_cli_config_t *cfg) {
                                    "but runtime API is OpenGL");
     }
 
-    db_renderer_cpu_renderer_init();
+    const db_cpu_renderer_vtable_t *renderer = db_cpu_renderer_vtable(
+        (cfg != NULL) ? cfg->cpu_renderer : DB_CPU_RENDERER_AUTO);
+    renderer->init();
     db_cpu_present_gl_state_t present = {
         .has_pbo = 0,
         .initialized = 0,
@@ -524,15 +591,31 @@ static int db_run_glfw_window_cpu(const db_cli_config_t *cfg) {
             ? DB_CAP_MODE_CPU_GLFW_PBO
             : DB_CAP_MODE_CPU_GLFW_TEX_SUB_IMAGE;
 
-    const uint32_t work_unit_count = db_renderer_cpu_renderer_work_unit_count();
+    const uint32_t work_unit_count = renderer->work_unit_count();
+    db_display_log_output_hash_algo(
+        BACKEND_NAME_CPU, hash_settings.output_hash_enabled, output_hash_algo);
     const double bench_start = db_glfw_time_seconds();
     db_display_hash_tracker_t state_hash_tracker =
         db_display_hash_tracker_create(
             BACKEND_NAME_CPU, hash_settings.state_hash_enabled, "state_hash",
             (cfg != NULL) ? cfg->hash_report : "both");
     db_display_hash_tracker_t bo_hash_tracker = db_display_hash_tracker_create(
-        BACKEND_NAME_CPU, hash_settings.output_hash_enabled, "bo_hash",
+        BACKEND_NAME_CPU, hash_settings.output_hash_enabled,
+        (output_hash_incremental != DB_HASH_INCREMENTAL_OFF) ? "bo_row_hash"
+                                                             : "bo_hash",
         (cfg != NULL) ? cfg->hash_report : "both");
+    db_display_hash_trace_t hash_trace;
+    const int hash_trace_enabled = db_display_hash_trace_open(
+        &hash_trace, BACKEND_NAME_CPU,
+        (cfg != NULL) ? cfg->hash_trace_path : NULL,
+        (cfg != NULL) ? cfg->hash_verify_path : NULL, output_hash_algo);
+    db_display_hash_worker_t *hash_worker = NULL;
+    if ((hash_settings.output_hash_enabled != 0) && (cfg != NULL) &&
+        (cfg->hash_queue_depth > 0U)) {
+        hash_worker = db_display_hash_worker_create(
+            BACKEND_NAME_CPU, cfg->hash_queue_depth, &bo_hash_tracker,
+            output_hash_algo, output_hash_incremental, &row_hash_tree);
+    }
     db_glfw_cpu_loop_ctx_t loop_ctx = {
         .bench_start = bench_start,
         .capability_mode = capability_mode,
@@ -541,7 +624,14 @@ static int db_run_glfw_window_cpu(const db_cli_config_t *cfg) {
         .bo_hash_tracker = &bo_hash_tracker,
         .state_hash_enabled = hash_settings.state_hash_enabled,
         .output_hash_enabled = hash_settings.output_hash_enabled,
+        .output_hash_algo = output_hash_algo,
+        .output_hash_incremental = output_hash_incremental,
+        .row_hash_tree = &row_hash_tree,
+        .hash_worker = hash_worker,
+        .hash_trace = &hash_trace,
+        .hash_trace_enabled = hash_trace_enabled,
         .present = &present,
+        .renderer = renderer,
         .work_unit_count = work_unit_count,
         .window = window,
     };
@@ -554,6 +644,7 @@ static int db_run_glfw_window_cpu(const db_cli_config_t *cfg) {
         .window = window,
     };
     const uint64_t frames = db_glfw_run_loop(&loop);
+    db_display_hash_worker_finish(hash_worker, NULL);
 
     const double bench_ms =
         (db_glfw_time_seconds() - bench_start) * DB_MS_PER_SECOND_D;
@@ -563,7 +654,9 @@ static int db_run_glfw_window_cpu(const db_cli_config_t *cfg) {
     db_display_hash_tracker_log_final(BACKEND_NAME_CPU, &state_hash_tracker);
     db_display_hash_tracker_log_final(BACKEND_NAME_CPU, &bo_hash_tracker);
 
-    db_renderer_cpu_renderer_shutdown();
+    db_display_hash_trace_close(&hash_trace);
+    db_row_hash_tree_free(&row_hash_tree);
+    renderer->shutdown();
     if (present.pbo != 0U) {
         db_gl_pbo_delete_if_valid((unsigned int)present.pbo);
     }
@@ -683,8 +776,10 @@ static db_glfw_loop_result_t db_glfw_opengl_frame(void *user_data,
                  BENCH_CLEAR_COLOR_B_F, BENCH_CLEAR_COLOR_A_F);
     glClear(GL_COLOR_BUFFER_BIT);
 
+    db_perf_counters_phase(DB_PERF_PHASE_RENDER);
     db_gl_renderer_render_frame(ctx->renderer, frame_index);
 
+    db_perf_counters_phase(DB_PERF_PHASE_HASH);
     if (ctx->state_hash_enabled != 0) {
         const uint64_t state_hash = db_gl_renderer_state_hash(ctx->renderer);
         db_display_hash_tracker_record(ctx->state_hash_tracker, state_hash);
@@ -694,8 +789,9 @@ static db_glfw_loop_result_t db_glfw_opengl_frame(void *user_data,
             db_gl_read_framebuffer_rgba8_or_fail(
                 ctx->backend_name, framebuffer_width_px, framebuffer_height_px,
                 ctx->hash_scratch);
-        const uint64_t framebuffer_hash = db_hash_rgba8_pixels_canonical(
-            framebuffer_pixels,
+        DB_TRACE_BEGIN("hash_pixels");
+        const uint64_t framebuffer_hash = db_hash_rgba8_pixels(
+            ctx->output_hash_algo, framebuffer_pixels,
             db_checked_int_to_u32(ctx->backend_name, "fb_w",
                                   framebuffer_width_px),
             db_checked_int_to_u32(ctx->backend_name, "fb_h",
@@ -704,11 +800,15 @@ static db_glfw_loop_result_t db_glfw_opengl_frame(void *user_data,
                                           framebuffer_width_px) *
                 4U,
             1);
+        DB_TRACE_END("hash_pixels");
         db_display_hash_tracker_record(ctx->framebuffer_hash_tracker,
                                        framebuffer_hash);
     }
 
+    db_perf_counters_phase(DB_PERF_PHASE_PRESENT);
+    DB_TRACE_BEGIN("swap_buffers");
     glfwSwapBuffers(ctx->window);
+    DB_TRACE_END("swap_buffers");
     const uint64_t logged_frames = frame_index + 1U;
     const double bench_ms =
         (db_glfw_time_seconds() - ctx->bench_start) * DB_MS_PER_SECOND_D;
@@ -733,6 +833,8 @@ static int db_run_glfw_window_opengl(db_gl_renderer_t renderer,
     const uint32_t frame_limit = (cfg != NULL) ? cfg->frame_limit : 0U;
     const db_display_hash_settings_t hash_settings =
         db_glfw_hash_settings_for_backend(cfg);
+    const db_hash_algo_t output_hash_algo =
+        (cfg != NULL) ? cfg->hash_algo : DB_HASH_ALGO_FNV1A;
 
     GLFWwindow *window = NULL;
     if (renderer == DB_GL_RENDERER_GL1_5_GLES1_1) {
@@ -741,7 +843,7 @@ static int db_run_glfw_window_opengl(db_gl_renderer_t renderer,
         int is_gles = 0;
         window = db_glfw_create_gl1_5_or_gles1_1_window(
             backend_name, "OpenGL 1.5/GLES1.1 GLFW DriverBench",
-            BENCH_WINDOW_WIDTH_PX, BENCH_WINDOW_HEIGHT_PX,
+            (int)db_grid_width(), (int)db_grid_height(),
             gl_legacy_context_major, gl_legacy_context_minor, swap_interval,
             &is_gles, (cfg != NULL) ? cfg->offscreen_enabled : 0);
         const char *runtime_version = (const char *)glGetString(GL_VERSION);
@@ -763,7 +865,7 @@ static int db_run_glfw_window_opengl(db_gl_renderer_t renderer,
         const int gl3_context_minor = 3;
         window = db_glfw_create_opengl_window(
             backend_name, "OpenGL 3.3 Shader GLFW DriverBench",
-            BENCH_WINDOW_WIDTH_PX, BENCH_WINDOW_HEIGHT_PX, gl3_context_major,
+            (int)db_grid_width(), (int)db_grid_height(), gl3_context_major,
             gl3_context_minor, 1, swap_interval,
             (cfg != NULL) ? cfg->offscreen_enabled : 0);
         const char *runtime_version = (const char *)glGetString(GL_VERSION);
@@ -782,6 +884,8 @@ static int db_run_glfw_window_opengl(db_gl_renderer_t renderer,
     db_gl_renderer_init(renderer);
     const char *capability_mode = db_gl_renderer_capability_mode(renderer);
     const uint32_t work_unit_count = db_gl_renderer_work_unit_count(renderer);
+    db_display_log_output_hash_algo(
+        backend_name, hash_settings.output_hash_enabled, output_hash_algo);
     const double bench_start = db_glfw_time_seconds();
     db_display_hash_tracker_t state_hash_tracker =
         db_display_hash_tracker_create(
@@ -804,6 +908,7 @@ static int db_run_glfw_window_opengl(db_gl_renderer_t renderer,
         .next_progress_log_due_ms = 0.0,
         .state_hash_enabled = hash_settings.state_hash_enabled,
         .output_hash_enabled = hash_settings.output_hash_enabled,
+        .output_hash_algo = output_hash_algo,
         .work_unit_count = work_unit_count,
         .window = window,
     };
@@ -859,8 +964,10 @@ static db_glfw_loop_result_t db_glfw_vulkan_frame(void *user_data,
                                                   uint32_t frame_index) {
     const db_glfw_vulkan_loop_ctx_t *ctx =
         (const db_glfw_vulkan_loop_ctx_t *)user_data;
+    db_perf_counters_phase(DB_PERF_PHASE_RENDER);
     const db_vk_frame_result_t frame_result =
         db_renderer_vulkan_1_2_multi_gpu_render_frame();
+    db_perf_counters_phase(DB_PERF_PHASE_HASH);
     if ((ctx->state_hash_enabled != 0) && (frame_result == DB_VK_FRAME_OK)) {
         const uint64_t state_hash =
             db_renderer_vulkan_1_2_multi_gpu_state_hash();
@@ -888,7 +995,7 @@ static int db_run_glfw_window_vulkan(const db_cli_config_t *cfg) {
 
     GLFWwindow *window = db_glfw_create_no_api_window(
         BACKEND_NAME_VK, "Vulkan 1.2 opportunistic multi-GPU (device groups)",
-        BENCH_WINDOW_WIDTH_PX, BENCH_WINDOW_HEIGHT_PX,
+        (int)db_grid_width(), (int)db_grid_height(),
         (cfg != NULL) ? cfg->offscreen_enabled : 0);
     uint32_t runtime_api_version = VK_API_VERSION_1_0;
     const VkResult version_result =
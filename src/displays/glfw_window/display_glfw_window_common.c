@@ -2,16 +2,89 @@
 #include "display_glfw_window_common.h"
 #include <GLFW/glfw3.h>
 
-#include <errno.h>
 #include <stdint.h>
-#ifndef __APPLE__
-#include <sys/errno.h>
-#endif
-#include <time.h>
 
 #include "../../core/db_core.h"
 
-#define MAX_SLEEP_NS_D 100000000.0
+typedef enum {
+    DB_GLFW_WINDOW_NO_API = 0,
+    DB_GLFW_WINDOW_OPENGL = 1,
+    DB_GLFW_WINDOW_LEGACY = 2,
+} db_glfw_window_kind_t;
+
+// Everything a window's context was created from except the swap interval,
+// which is re-applied on reuse.
+typedef struct {
+    db_glfw_window_kind_t kind;
+    int width_px;
+    int height_px;
+    int context_major;
+    int context_minor;
+    int core_profile;
+    int offscreen_enabled;
+} db_glfw_window_key_t;
+
+static struct {
+    int enabled;
+    GLFWwindow *live_window;
+    db_glfw_window_key_t live_key;
+    int live_is_gles;
+    GLFWwindow *parked_window;
+    db_glfw_window_key_t parked_key;
+    int parked_is_gles;
+} g_glfw_reuse = {0};
+
+static int db_glfw_window_key_equal(const db_glfw_window_key_t *a,
+                                    const db_glfw_window_key_t *b) {
+    return (a->kind == b->kind) && (a->width_px == b->width_px) &&
+           (a->height_px == b->height_px) &&
+           (a->context_major == b->context_major) &&
+           (a->context_minor == b->context_minor) &&
+           (a->core_profile == b->core_profile) &&
+           (a->offscreen_enabled == b->offscreen_enabled);
+}
+
+// Returns the parked window when it was created from `key`; a parked window
+// of another kind is destroyed so it does not outlive its sweep cells.
+static GLFWwindow *db_glfw_window_unpark(const db_glfw_window_key_t *key,
+                                         int swap_interval,
+                                         int *out_is_gles) {
+    GLFWwindow *window = g_glfw_reuse.parked_window;
+    if (window == NULL) {
+        return NULL;
+    }
+    g_glfw_reuse.parked_window = NULL;
+    if (db_glfw_window_key_equal(&g_glfw_reuse.parked_key, key) == 0) {
+        glfwDestroyWindow(window);
+        return NULL;
+    }
+    if (key->kind != DB_GLFW_WINDOW_NO_API) {
+        glfwMakeContextCurrent(window);
+        glfwSwapInterval(swap_interval);
+    }
+    if (out_is_gles != NULL) {
+        *out_is_gles = g_glfw_reuse.parked_is_gles;
+    }
+    return window;
+}
+
+static GLFWwindow *db_glfw_window_track(GLFWwindow *window,
+                                        const db_glfw_window_key_t *key,
+                                        int is_gles) {
+    g_glfw_reuse.live_window = window;
+    g_glfw_reuse.live_key = *key;
+    g_glfw_reuse.live_is_gles = is_gles;
+    return window;
+}
+
+void db_glfw_window_reuse_set(int enabled) {
+    g_glfw_reuse.enabled = enabled;
+    if ((enabled == 0) && (g_glfw_reuse.parked_window != NULL)) {
+        glfwDestroyWindow(g_glfw_reuse.parked_window);
+        g_glfw_reuse.parked_window = NULL;
+        glfwTerminate();
+    }
+}
 
 static void db_glfw_init_or_fail(const char *backend) {
     if (!glfwInit()) {
@@ -73,10 +146,21 @@ GLFWwindow *db_glfw_create_no_api_window(const char *backend, const char *title,
                                          int width_px, int height_px,
                                          int offscreen_enabled) {
     db_glfw_init_or_fail(backend);
-    db_glfw_apply_default_hints(offscreen_enabled);
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-    return db_glfw_create_window_or_fail(backend, title, width_px, height_px,
-                                         "glfwCreateWindow failed");
+    const db_glfw_window_key_t key = {
+        .kind = DB_GLFW_WINDOW_NO_API,
+        .width_px = width_px,
+        .height_px = height_px,
+        .offscreen_enabled = offscreen_enabled,
+    };
+    GLFWwindow *window = db_glfw_window_unpark(&key, 0, NULL);
+    if (window == NULL) {
+        db_glfw_apply_default_hints(offscreen_enabled);
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+        window = db_glfw_create_window_or_fail(backend, title, width_px,
+                                               height_px,
+                                               "glfwCreateWindow failed");
+    }
+    return db_glfw_window_track(window, &key, 0);
 }
 
 GLFWwindow *db_glfw_create_opengl_window(const char *backend, const char *title,
@@ -85,14 +169,26 @@ GLFWwindow *db_glfw_create_opengl_window(const char *backend, const char *title,
                                          int core_profile, int swap_interval,
                                          int offscreen_enabled) {
     db_glfw_init_or_fail(backend);
-    GLFWwindow *window = db_glfw_try_context_window(
-        title, width_px, height_px, GLFW_OPENGL_API, context_major,
-        context_minor, core_profile, swap_interval, offscreen_enabled);
+    const db_glfw_window_key_t key = {
+        .kind = DB_GLFW_WINDOW_OPENGL,
+        .width_px = width_px,
+        .height_px = height_px,
+        .context_major = context_major,
+        .context_minor = context_minor,
+        .core_profile = core_profile,
+        .offscreen_enabled = offscreen_enabled,
+    };
+    GLFWwindow *window = db_glfw_window_unpark(&key, swap_interval, NULL);
+    if (window == NULL) {
+        window = db_glfw_try_context_window(
+            title, width_px, height_px, GLFW_OPENGL_API, context_major,
+            context_minor, core_profile, swap_interval, offscreen_enabled);
+    }
     if (window == NULL) {
         glfwTerminate();
         db_failf(backend, "glfwCreateWindow failed");
     }
-    return window;
+    return db_glfw_window_track(window, &key, 0);
 }
 
 GLFWwindow *db_glfw_create_gl1_5_or_gles1_1_window(
@@ -103,13 +199,30 @@ GLFWwindow *db_glfw_create_gl1_5_or_gles1_1_window(
         *out_is_gles = 0;
     }
     db_glfw_init_or_fail(backend);
+    const db_glfw_window_key_t key = {
+        .kind = DB_GLFW_WINDOW_LEGACY,
+        .width_px = width_px,
+        .height_px = height_px,
+        .context_major = gl_context_major,
+        .context_minor = gl_context_minor,
+        .offscreen_enabled = offscreen_enabled,
+    };
+    int reused_is_gles = 0;
+    GLFWwindow *reused =
+        db_glfw_window_unpark(&key, swap_interval, &reused_is_gles);
+    if (reused != NULL) {
+        if (out_is_gles != NULL) {
+            *out_is_gles = reused_is_gles;
+        }
+        return db_glfw_window_track(reused, &key, reused_is_gles);
+    }
 
 #ifdef DB_HAS_OPENGL_DESKTOP
     GLFWwindow *window = db_glfw_try_context_window(
         title, width_px, height_px, GLFW_OPENGL_API, gl_context_major,
         gl_context_minor, 0, swap_interval, offscreen_enabled);
     if (window != NULL) {
-        return window;
+        return db_glfw_window_track(window, &key, 0);
     }
 
     window = db_glfw_try_context_window(title, width_px, height_px,
@@ -124,7 +237,7 @@ GLFWwindow *db_glfw_create_gl1_5_or_gles1_1_window(
         *out_is_gles = 1;
     }
     db_infof(backend, "OpenGL context creation failed; fell back to GLES 1.1");
-    return window;
+    return db_glfw_window_track(window, &key, 1);
 #else
     (void)gl_context_major;
     (void)gl_context_minor;
@@ -138,11 +251,23 @@ GLFWwindow *db_glfw_create_gl1_5_or_gles1_1_window(
     if (out_is_gles != NULL) {
         *out_is_gles = 1;
     }
-    return window;
+    return db_glfw_window_track(window, &key, 1);
 #endif
 }
 
 void db_glfw_destroy_window(GLFWwindow *window) {
+    if ((g_glfw_reuse.enabled != 0) &&
+        (window == g_glfw_reuse.live_window) &&
+        (glfwWindowShouldClose(window) == 0)) {
+        g_glfw_reuse.parked_window = window;
+        g_glfw_reuse.parked_key = g_glfw_reuse.live_key;
+        g_glfw_reuse.parked_is_gles = g_glfw_reuse.live_is_gles;
+        g_glfw_reuse.live_window = NULL;
+        return;
+    }
+    if (window == g_glfw_reuse.live_window) {
+        g_glfw_reuse.live_window = NULL;
+    }
     glfwDestroyWindow(window);
     glfwTerminate();
 }
@@ -150,32 +275,3 @@ void db_glfw_destroy_window(GLFWwindow *window) {
 void db_glfw_poll_events(void) { glfwPollEvents(); }
 
 double db_glfw_time_seconds(void) { return glfwGetTime(); }
-
-void db_glfw_sleep_to_fps_cap(const char *backend, double frame_start_s,
-                              double fps_cap) {
-    if (fps_cap <= 0.0) {
-        return;
-    }
-
-    const double frame_budget_s = 1.0 / fps_cap;
-    double remaining_s =
-        frame_budget_s - (db_glfw_time_seconds() - frame_start_s);
-    while (remaining_s > 0.0) {
-        const double remaining_ns_d = remaining_s * DB_NS_PER_SECOND_D;
-        const double sleep_ns_d =
-            (remaining_ns_d > MAX_SLEEP_NS_D) ? MAX_SLEEP_NS_D : remaining_ns_d;
-        const long sleep_ns =
-            db_checked_double_to_long(backend, "sleep_ns", sleep_ns_d);
-        if (sleep_ns <= 0L) {
-            break;
-        }
-
-        struct timespec request = {0};
-        request.tv_nsec = sleep_ns;
-        // NOLINTNEXTLINE(misc-include-cleaner)
-        if ((nanosleep(&request, NULL) != 0) && (errno != EINTR)) {
-            break;
-        }
-        remaining_s = frame_budget_s - (db_glfw_time_seconds() - frame_start_s);
-    }
-}
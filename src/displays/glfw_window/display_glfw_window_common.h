@@ -20,7 +20,5 @@ GLFWwindow *db_glfw_create_gl1_5_or_gles1_1_window(
 void db_glfw_destroy_window(GLFWwindow *window);
 void db_glfw_poll_events(void);
 double db_glfw_time_seconds(void);
-void db_glfw_sleep_to_fps_cap(const char *backend, double frame_start_s,
-                              double fps_cap);
 
 #endif
@@ -31,6 +31,8 @@
 #include "../../config/benchmark_config.h"
 #include "../../core/db_buffer_convert.h"
 #include "../../core/db_core.h"
+#include "../../core/db_perf_counters.h"
+#include "../../core/db_trace.h"
 #include "../../driverbench_cli.h"
 #include "../../renderers/cpu_renderer/renderer_cpu_renderer.h"
 #include "../../renderers/renderer_gl_common.h"
@@ -400,6 +402,7 @@ static void db_kms_atomic_commit_modeset(const struct kms_atomic *kms,
 
 static void db_kms_atomic_flip_to_fb(const struct kms_atomic *kms,
                                      uint32_t fb_id, drmEventContext *ev) {
+    DB_TRACE_BEGIN("kms_flip");
     drmModeAtomicReq *commit_req = drmModeAtomicAlloc();
     if (commit_req == NULL) {
         diex("drmModeAtomicAlloc");
@@ -427,6 +430,7 @@ static void db_kms_atomic_flip_to_fb(const struct kms_atomic *kms,
         }
         drmHandleEvent(kms->fd, ev);
     }
+    DB_TRACE_END("kms_flip");
 }
 
 typedef struct fb *(*db_kms_atomic_next_fb_fn_t)(void *user_ctx,
@@ -453,12 +457,15 @@ db_kms_atomic_run_frame_loop(const db_kms_atomic_frame_loop_t *loop,
     const uint64_t bench_start = db_now_ns_monotonic();
     uint64_t bench_frames = 0U;
     double next_progress_log_due_ms = 0.0;
+    db_benchmark_frame_times_begin(loop->fps_cap);
     while (!db_should_stop()) {
         if ((loop->frame_limit > 0U) && (bench_frames >= loop->frame_limit)) {
             break;
         }
         const uint64_t frame_start_ns = db_now_ns_monotonic();
+        db_perf_counters_phase(DB_PERF_PHASE_RENDER);
         struct fb *next = next_fb_fn(producer_ctx, bench_frames);
+        db_perf_counters_phase(DB_PERF_PHASE_PRESENT);
         db_kms_atomic_flip_to_fb(loop->kms, next->fb_id, loop->event_context);
         fb_release(loop->kms->fd, loop->release_surface, *loop->cur_fb);
         *loop->cur_fb = next;
@@ -471,6 +478,8 @@ db_kms_atomic_run_frame_loop(const db_kms_atomic_frame_loop_t *loop,
             bench_frames, loop->work_unit_count, bench_ms,
             loop->capability_mode, &next_progress_log_due_ms,
             BENCH_LOG_INTERVAL_MS_D);
+        db_benchmark_frame_time_record_ns(db_now_ns_monotonic() -
+                                          frame_start_ns);
         db_sleep_to_fps_cap(loop->backend, frame_start_ns, loop->fps_cap);
     }
     return bench_frames;
@@ -492,7 +501,9 @@ static struct fb *db_kms_atomic_next_gl_fb(void *user_ctx,
                  BENCH_CLEAR_COLOR_B_F, BENCH_CLEAR_COLOR_A_F);
     glClear(GL_COLOR_BUFFER_BIT);
     producer->renderer->render_frame(frame_index);
+    DB_TRACE_BEGIN("swap_buffers");
     eglSwapBuffers(producer->dpy, producer->surf);
+    DB_TRACE_END("swap_buffers");
 
     struct gbm_bo *next_bo = gbm_surface_lock_front_buffer(producer->gbm_surf);
     if (next_bo == NULL) {
@@ -749,8 +760,13 @@ int db_kms_atomic_run(const char *backend, const char *renderer_name,
     return 0;
 }
 
+// Copies the renderer's src_width x src_height frame into a mode-sized
+// scanout buffer: a larger --grid is clipped to the mode and a smaller one
+// is shown in the top-left corner on black.
 static struct fb *db_cpu_create_fb_from_rgba8(struct gbm_device *gbm, int fd,
                                               const uint32_t *pixels_rgba8,
+                                              uint32_t src_width,
+                                              uint32_t src_height,
                                               uint32_t width, uint32_t height) {
     uint32_t bo_flags = GBM_BO_USE_SCANOUT;
 #ifdef GBM_BO_USE_WRITE
@@ -776,9 +792,19 @@ static struct fb *db_cpu_create_fb_from_rgba8(struct gbm_device *gbm, int fd,
 
     const size_t dst_stride_pixels =
         (size_t)map_stride_bytes / sizeof(uint32_t);
-    db_convert_rgba8_to_xrgb8888_rows((uint32_t *)map_ptr, dst_stride_pixels,
-                                      pixels_rgba8, (size_t)width, width,
-                                      height);
+    const uint32_t copy_width = (src_width < width) ? src_width : width;
+    const uint32_t copy_height = (src_height < height) ? src_height : height;
+    uint32_t *dst = (uint32_t *)map_ptr;
+    db_convert_rgba8_to_xrgb8888_rows(dst, dst_stride_pixels, pixels_rgba8,
+                                      (size_t)src_width, copy_width,
+                                      copy_height);
+    for (uint32_t row = 0U; row < height; row++) {
+        const uint32_t first_blank = (row < copy_height) ? copy_width : 0U;
+        if (first_blank < width) {
+            memset(&dst[((size_t)row * dst_stride_pixels) + first_blank], 0,
+                   (size_t)(width - first_blank) * sizeof(uint32_t));
+        }
+    }
     gbm_bo_unmap(bo, map_data);
 
     return fb_from_bo(fd, bo, 0);
@@ -790,19 +816,24 @@ typedef struct {
     uint32_t width;
     uint32_t height;
     const char *backend;
+    const db_cpu_renderer_vtable_t *renderer;
 } db_kms_atomic_cpu_frame_producer_t;
 
 static struct fb *db_kms_atomic_next_cpu_fb(void *user_ctx,
                                             uint32_t frame_index) {
     db_kms_atomic_cpu_frame_producer_t *producer =
         (db_kms_atomic_cpu_frame_producer_t *)user_ctx;
-    db_renderer_cpu_renderer_render_frame(frame_index);
-    const uint32_t *pixels = db_renderer_cpu_renderer_pixels_rgba8(NULL, NULL);
+    producer->renderer->render_frame(frame_index);
+    uint32_t src_width = 0U;
+    uint32_t src_height = 0U;
+    const uint32_t *pixels =
+        producer->renderer->pixels_rgba8(&src_width, &src_height);
     if (pixels == NULL) {
         db_failf(producer->backend, "cpu renderer returned NULL framebuffer");
     }
     return db_cpu_create_fb_from_rgba8(producer->gbm, producer->kms_fd, pixels,
-                                       producer->width, producer->height);
+                                       src_width, src_height, producer->width,
+                                       producer->height);
 }
 
 int db_kms_atomic_run_cpu(const char *backend, const char *renderer_name,
@@ -830,20 +861,32 @@ int db_kms_atomic_run_cpu(const char *backend, const char *renderer_name,
         die("gbm_create_device");
     }
 
-    db_renderer_cpu_renderer_init();
-    const char *capability_mode = db_renderer_cpu_renderer_capability_mode();
+    const db_cpu_renderer_vtable_t *renderer = db_cpu_renderer_vtable(
+        (cfg != NULL) ? cfg->cpu_renderer : DB_CPU_RENDERER_AUTO);
+    renderer->init();
+    const char *capability_mode = renderer->capability_mode();
     const double fps_cap = (cfg != NULL) ? cfg->fps_cap : BENCH_FPS_CAP_D;
     const uint32_t frame_limit = (cfg != NULL) ? cfg->frame_limit : 0U;
-    const uint32_t work_unit_count = db_renderer_cpu_renderer_work_unit_count();
+    const uint32_t work_unit_count = renderer->work_unit_count();
 
-    db_renderer_cpu_renderer_render_frame(0);
+    renderer->render_frame(0);
+    uint32_t grid_width = 0U;
+    uint32_t grid_height = 0U;
     const uint32_t *initial_pixels =
-        db_renderer_cpu_renderer_pixels_rgba8(NULL, NULL);
+        renderer->pixels_rgba8(&grid_width, &grid_height);
     if (initial_pixels == NULL) {
         db_failf(backend, "cpu renderer returned NULL framebuffer");
     }
-    struct fb *cur =
-        db_cpu_create_fb_from_rgba8(gbm, kms.fd, initial_pixels, width, height);
+    if ((grid_width != width) || (grid_height != height)) {
+        db_infof(backend,
+                 "grid %ux%u differs from mode %ux%u; scanout is %s",
+                 grid_width, grid_height, width, height,
+                 ((grid_width > width) || (grid_height > height))
+                     ? "clipped"
+                     : "padded with black");
+    }
+    struct fb *cur = db_cpu_create_fb_from_rgba8(
+        gbm, kms.fd, initial_pixels, grid_width, grid_height, width, height);
 
     db_kms_atomic_commit_modeset(&kms, width, height, cur->fb_id);
 
@@ -870,6 +913,7 @@ int db_kms_atomic_run_cpu(const char *backend, const char *renderer_name,
         .width = width,
         .height = height,
         .backend = backend,
+        .renderer = renderer,
     };
     const uint64_t bench_start = db_now_ns_monotonic();
     const uint64_t bench_frames = db_kms_atomic_run_frame_loop(
@@ -880,7 +924,7 @@ int db_kms_atomic_run_cpu(const char *backend, const char *renderer_name,
                            backend, bench_frames, work_unit_count, bench_ms,
                            capability_mode);
 
-    db_renderer_cpu_renderer_shutdown();
+    renderer->shutdown();
     fb_release(kms.fd, NULL, cur);
 
     drmModeDestroyPropertyBlob(kms.fd, kms.mode_blob_id);
@@ -5,27 +5,51 @@
 #include "../../config/benchmark_config.h"
 #include "../../core/db_core.h"
 #include "../../core/db_hash.h"
+#include "../../core/db_perf_counters.h"
 #include "../../driverbench_cli.h"
 #include "../../renderers/cpu_renderer/renderer_cpu_renderer.h"
 #include "../../renderers/renderer_identity.h"
 #include "../display_dispatch.h"
 #include "../display_hash_common.h"
+#include "../display_hash_trace.h"
+#include "../display_hash_worker.h"
 
 #define BACKEND_NAME "display_offscreen"
 
+// Brings the renderer to the state before `start_frame` in closed form;
+// --checkpoint-file records are checked as the run reaches them.
+static void db_offscreen_seek_cpu(const db_cpu_renderer_vtable_t *renderer,
+                                  uint32_t start_frame) {
+    const uint64_t seek_start_ns = db_now_ns_monotonic();
+    renderer->seek(start_frame);
+    db_infof(BACKEND_NAME, "seeked to frame %u in %.3f ms", start_frame,
+             (double)(db_now_ns_monotonic() - seek_start_ns) /
+                 DB_NS_PER_MS_D);
+}
+
 static int db_run_offscreen_cpu(const db_cli_config_t *cfg) {
-    const uint64_t start_ns = db_now_ns_monotonic();
     db_install_signal_handlers();
 
     const uint32_t frame_limit = (cfg != NULL) ? cfg->frame_limit : 0U;
+    const uint32_t start_frame = (cfg != NULL) ? cfg->start_frame : 0U;
     const double fps_cap = (cfg != NULL) ? cfg->fps_cap : BENCH_FPS_CAP_D;
     const db_display_hash_settings_t hash_settings =
         db_display_resolve_hash_settings(
             0, 0, (cfg != NULL) ? cfg->hash_mode : "none");
-
-    db_renderer_cpu_renderer_init();
-    const char *capability_mode = db_renderer_cpu_renderer_capability_mode();
-    const uint32_t work_unit_count = db_renderer_cpu_renderer_work_unit_count();
+    const db_hash_algo_t hash_algo =
+        (cfg != NULL) ? cfg->hash_algo : DB_HASH_ALGO_FNV1A;
+    const db_hash_incremental_t hash_incremental =
+        (cfg != NULL) ? cfg->hash_incremental : DB_HASH_INCREMENTAL_OFF;
+    db_display_log_output_hash_algo(
+        BACKEND_NAME, hash_settings.output_hash_enabled, hash_algo);
+    db_row_hash_tree_t row_hash_tree;
+    db_row_hash_tree_init(&row_hash_tree, hash_algo);
+
+    const db_cpu_renderer_vtable_t *renderer = db_cpu_renderer_vtable(
+        (cfg != NULL) ? cfg->cpu_renderer : DB_CPU_RENDERER_AUTO);
+    renderer->init();
+    const char *capability_mode = renderer->capability_mode();
+    const uint32_t work_unit_count = renderer->work_unit_count();
 
     uint64_t frames = 0U;
     double next_progress_log_due_ms = 0.0;
@@ -34,67 +58,156 @@ static int db_run_offscreen_cpu(const db_cli_config_t *cfg) {
             BACKEND_NAME, hash_settings.state_hash_enabled, "state_hash",
             (cfg != NULL) ? cfg->hash_report : "both");
     db_display_hash_tracker_t bo_hash_tracker = db_display_hash_tracker_create(
-        BACKEND_NAME, hash_settings.output_hash_enabled, "bo_hash",
+        BACKEND_NAME, hash_settings.output_hash_enabled,
+        (hash_incremental != DB_HASH_INCREMENTAL_OFF) ? "bo_row_hash"
+                                                      : "bo_hash",
         (cfg != NULL) ? cfg->hash_report : "both");
+    state_hash_tracker.next_frame = start_frame;
+    bo_hash_tracker.next_frame = start_frame;
+    db_display_hash_trace_t hash_trace;
+    const int hash_trace_enabled = db_display_hash_trace_open(
+        &hash_trace, BACKEND_NAME, (cfg != NULL) ? cfg->hash_trace_path : NULL,
+        (cfg != NULL) ? cfg->hash_verify_path : NULL, hash_algo);
+    // A run from frame 0 writes --checkpoint-file; a run that starts later
+    // checks every checkpoint it renders against it.
+    const char *checkpoint_path = (cfg != NULL) ? cfg->checkpoint_path : NULL;
+    const uint32_t checkpoint_interval =
+        (cfg != NULL) ? cfg->checkpoint_interval
+                      : DB_HASH_TRACE_CHECKPOINT_INTERVAL;
+    db_display_hash_trace_t checkpoint;
+    (void)db_display_hash_trace_open(
+        &checkpoint, BACKEND_NAME,
+        (start_frame == 0U) ? checkpoint_path : NULL,
+        (start_frame > 0U) ? checkpoint_path : NULL, hash_algo);
+    if (start_frame > 0U) {
+        db_offscreen_seek_cpu(renderer, start_frame);
+        (void)db_display_hash_trace_skip_verify(&hash_trace, start_frame);
+        (void)db_display_hash_trace_skip_verify(&checkpoint, start_frame);
+    }
+    uint32_t next_checkpoint_frame = 0U;
+    int checkpoint_pending = db_display_hash_trace_next_verify_frame(
+        &checkpoint, &next_checkpoint_frame);
+    db_display_hash_worker_t *hash_worker = NULL;
+    if ((hash_settings.output_hash_enabled != 0) && (cfg != NULL) &&
+        (cfg->hash_queue_depth > 0U)) {
+        hash_worker = db_display_hash_worker_create(
+            BACKEND_NAME, cfg->hash_queue_depth, &bo_hash_tracker, hash_algo,
+            hash_incremental, &row_hash_tree);
+    }
 
-    for (uint32_t frame = 0U; !db_should_stop(); frame++) {
-        if ((frame_limit > 0U) && (frame >= frame_limit)) {
+    // Init, seek and checkpoint setup stay out of every reported figure.
+    const uint64_t start_ns = db_now_ns_monotonic();
+    db_benchmark_frame_times_begin(fps_cap);
+    for (uint32_t frame = start_frame; !db_should_stop(); frame++) {
+        if ((frame_limit > 0U) && ((frame - start_frame) >= frame_limit)) {
             break;
         }
         const uint64_t frame_start_ns = db_now_ns_monotonic();
-        db_renderer_cpu_renderer_render_frame(frame);
+        db_perf_counters_phase(DB_PERF_PHASE_RENDER);
+        renderer->render_frame(frame);
 
-        const uint64_t state_hash = db_renderer_cpu_renderer_state_hash();
+        db_perf_counters_phase(DB_PERF_PHASE_HASH);
+        const uint64_t state_hash = renderer->state_hash();
         db_display_hash_tracker_record(&state_hash_tracker, state_hash);
 
         uint32_t pixel_width = 0U;
         uint32_t pixel_height = 0U;
         const uint32_t *pixels =
-            db_renderer_cpu_renderer_pixels_rgba8(&pixel_width, &pixel_height);
+            renderer->pixels_rgba8(&pixel_width, &pixel_height);
         if (pixels == NULL) {
             db_failf(BACKEND_NAME, "cpu renderer returned NULL framebuffer");
         }
-        const uint64_t bo_hash = db_hash_rgba8_pixels_canonical(
-            (const uint8_t *)pixels, pixel_width, pixel_height,
-            (size_t)pixel_width * 4U, 0);
-        db_display_hash_tracker_record(&bo_hash_tracker, bo_hash);
+        if (hash_trace_enabled != 0) {
+            db_display_hash_trace_frame(&hash_trace, frame,
+                                        renderer->runtime_state(), state_hash,
+                                        pixels, pixel_width, pixel_height);
+        }
+        if ((checkpoint.write_file != NULL) &&
+            (((frame + 1U) % checkpoint_interval) == 0U)) {
+            db_display_hash_trace_frame(&checkpoint, frame,
+                                        renderer->runtime_state(), state_hash,
+                                        pixels, pixel_width, pixel_height);
+        }
+        if ((checkpoint_pending != 0) && (next_checkpoint_frame == frame)) {
+            db_display_hash_trace_frame(&checkpoint, frame,
+                                        renderer->runtime_state(), state_hash,
+                                        pixels, pixel_width, pixel_height);
+            db_infof(BACKEND_NAME, "checkpoint at frame %u matched", frame);
+            checkpoint_pending = db_display_hash_trace_next_verify_frame(
+                &checkpoint, &next_checkpoint_frame);
+        }
+        if (hash_worker != NULL) {
+            size_t damage_count = 0U;
+            const db_dirty_row_range_t *damage_rows =
+                renderer->damage_rows(&damage_count);
+            db_display_hash_worker_submit(hash_worker, pixels, pixel_width,
+                                          pixel_height, damage_rows,
+                                          damage_count);
+        } else if ((hash_settings.output_hash_enabled != 0) &&
+                   (hash_incremental != DB_HASH_INCREMENTAL_OFF)) {
+            size_t damage_count = 0U;
+            const db_dirty_row_range_t *damage_rows =
+                renderer->damage_rows(&damage_count);
+            const uint64_t bo_row_hash = db_display_row_hash_update(
+                BACKEND_NAME, &row_hash_tree, hash_incremental, pixels,
+                pixel_width, pixel_height, damage_rows, damage_count);
+            db_display_hash_tracker_record(&bo_hash_tracker, bo_row_hash);
+        } else if (hash_settings.output_hash_enabled != 0) {
+            DB_TRACE_BEGIN("hash_pixels");
+            const uint64_t bo_hash = db_hash_rgba8_pixels(
+                hash_algo, (const uint8_t *)pixels, pixel_width, pixel_height,
+                (size_t)pixel_width * 4U, 0);
+            DB_TRACE_END("hash_pixels");
+            db_display_hash_tracker_record(&bo_hash_tracker, bo_hash);
+        }
 
         frames++;
         const double elapsed_ms =
-            (double)(db_now_ns_monotonic() - frame_start_ns) / 1000.0F;
+            (double)(db_now_ns_monotonic() - start_ns) / DB_NS_PER_MS_D;
         db_benchmark_log_periodic(
             db_dispatch_api_name(DB_API_CPU), db_renderer_name_cpu(),
             BACKEND_NAME, frames, work_unit_count, elapsed_ms, capability_mode,
             &next_progress_log_due_ms, BENCH_LOG_INTERVAL_MS_D);
+        db_benchmark_frame_time_record_ns(db_now_ns_monotonic() -
+                                          frame_start_ns);
         db_sleep_to_fps_cap(BACKEND_NAME, frame_start_ns, fps_cap);
     }
 
+    db_display_hash_worker_finish(hash_worker, NULL);
     if (hash_settings.state_hash_enabled != 0) {
-        const uint64_t final_hash = db_renderer_cpu_renderer_state_hash();
+        const uint64_t final_hash = renderer->state_hash();
         state_hash_tracker.final_hash = final_hash;
     }
 
     uint32_t final_width = 0U;
     uint32_t final_height = 0U;
     const uint32_t *final_pixels =
-        db_renderer_cpu_renderer_pixels_rgba8(&final_width, &final_height);
+        renderer->pixels_rgba8(&final_width, &final_height);
     if (final_pixels == NULL) {
         db_failf(BACKEND_NAME, "cpu renderer returned NULL framebuffer");
     }
-    if (hash_settings.output_hash_enabled != 0) {
-        bo_hash_tracker.final_hash = db_hash_rgba8_pixels_canonical(
-            (const uint8_t *)final_pixels, final_width, final_height,
-            (size_t)final_width * 4U, 0);
+    if ((hash_settings.output_hash_enabled != 0) &&
+        (hash_incremental != DB_HASH_INCREMENTAL_OFF)) {
+        bo_hash_tracker.final_hash = db_display_row_hash_update(
+            BACKEND_NAME, &row_hash_tree, hash_incremental, final_pixels,
+            final_width, final_height, NULL, 0U);
+    } else if (hash_settings.output_hash_enabled != 0) {
+        bo_hash_tracker.final_hash = db_hash_rgba8_pixels(
+            hash_algo, (const uint8_t *)final_pixels, final_width,
+            final_height, (size_t)final_width * 4U, 0);
     }
 
     const double total_ms =
-        (double)(db_now_ns_monotonic() - start_ns) / 1000.0F;
+        (double)(db_now_ns_monotonic() - start_ns) / DB_NS_PER_MS_D;
     db_benchmark_log_final(db_dispatch_api_name(DB_API_CPU),
                            db_renderer_name_cpu(), BACKEND_NAME, frames,
                            work_unit_count, total_ms, capability_mode);
     db_display_hash_tracker_log_final(BACKEND_NAME, &state_hash_tracker);
     db_display_hash_tracker_log_final(BACKEND_NAME, &bo_hash_tracker);
-    db_renderer_cpu_renderer_shutdown();
+    db_display_hash_trace_close(&hash_trace);
+    db_display_hash_trace_close(&checkpoint);
+    db_row_hash_tree_free(&row_hash_tree);
+    renderer->shutdown();
     return EXIT_SUCCESS;
 }
 
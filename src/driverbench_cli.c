@@ -8,7 +8,16 @@
 
 #include "config/benchmark_config.h"
 #include "core/db_core.h"
+#include "core/db_hash.h"
+#include "core/db_mem.h"
+#include "core/db_perf_counters.h"
+#include "core/db_results.h"
+#include "core/db_worker_pool.h"
 #include "displays/display_dispatch.h"
+#include "displays/display_hash_trace.h"
+#include "displays/display_hash_worker.h"
+#include "renderers/cpu_renderer/renderer_cpu_kernels.h"
+#include "renderers/cpu_renderer/renderer_cpu_layout.h"
 #include "renderers/renderer_benchmark_common.h"
 
 static int db_string_is(const char *value, const char *expected) {
@@ -18,9 +27,10 @@ static int db_string_is(const char *value, const char *expected) {
 
 static void db_usage(void) {
 #ifdef DB_HAS_OPENGL_DESKTOP
-    const char *renderer_usage = "auto|gl1_5_gles1_1|gl3_3";
+    const char *renderer_usage =
+        "auto|gl1_5_gles1_1|gl3_3|scalar|simd|threaded";
 #else
-    const char *renderer_usage = "auto|gl1_5_gles1_1";
+    const char *renderer_usage = "auto|gl1_5_gles1_1|scalar|simd|threaded";
 #endif
     fputs("Usage: driverbench [dispatch options] [runtime options]\n"
           "\nDispatch options:\n"
@@ -37,13 +47,41 @@ static void db_usage(void) {
           "<gradient_sweep|bands|snake_grid|gradient_fill|snake_rect|snake_"
           "shapes>\n"
           "  --bench-speed <value>\n"
+          "  --checkpoint-file <file>\n"
+          "  --checkpoint-interval <value>\n"
+          "  --cpu-blend <fixed|float|validate>\n"
+          "  --cpu-kernel <auto|scalar|sse2|avx2|avx512>\n"
+          "  --cpu-layout <linear|tiled|morton>\n"
+          "  --cpu-mem <default|hugepage|numa=N>\n"
+          "  --cpu-threads <value>\n"
           "  --fps-cap <value>\n"
           "  --hash <none|state|pixel|both>\n"
           "  --frame-limit <value>\n"
-          "  --hash-report <final|aggregate|both>\n"
+          "  --gradient-planner <closed|iterative|validate>\n"
+          "  --grid <WxH>\n"
+          "  --hash-algo <fnv1a|xxh3|crc32c>\n"
+          "  --hash-incremental <0|1|validate>\n"
+          "  --hash-queue-depth <value>\n"
+          "  --hash-trace <file>\n"
+          "  --hash-verify <file>\n"
+          "  --hash-report <final|aggregate|combined|both>\n"
           "  --offscreen <0|1>\n"
+          "  --pacer-catchup <skip-ahead|drop>\n"
+          "  --pacer-spin-us <value>\n"
+          "  --perf-counters "
+          "<cycles,instructions,cache-misses,branch-misses,page-faults>\n"
           "  --random-seed <value>\n"
+          "  --repeat <value>\n"
+          "  --resolution-sweep <0|1>\n"
+          "  --results-file <file>\n"
+          "  --results-format <jsonl|csv>\n"
+          "  --start-frame <value>\n"
+          "  --sweep <\"mode=a,b;speed=1,4;api=cpu,opengl;renderer=...\">\n"
+          "  --trace-file <file>\n"
           "  --vsync <0|1|on|off|true|false>\n"
+          "  --warmup-cv <percent>\n"
+          "  --warmup-frames <value>\n"
+          "  --warmup-ms <value>\n"
           "  --help\n",
           stderr);
 }
@@ -87,10 +125,37 @@ enum {
     DB_CLI_RT_BENCH_SPEED = 7,
     DB_CLI_RT_OFFSCREEN = 8,
     DB_CLI_RT_VSYNC = 9,
+    DB_CLI_RT_CPU_THREADS = 10,
+    DB_CLI_RT_CPU_KERNEL = 11,
+    DB_CLI_RT_CPU_BLEND = 12,
+    DB_CLI_RT_GRID = 13,
+    DB_CLI_RT_RESOLUTION_SWEEP = 14,
+    DB_CLI_RT_CPU_LAYOUT = 15,
+    DB_CLI_RT_CPU_MEM = 16,
+    DB_CLI_RT_HASH_ALGO = 17,
+    DB_CLI_RT_HASH_INCREMENTAL = 18,
+    DB_CLI_RT_HASH_QUEUE_DEPTH = 19,
+    DB_CLI_RT_HASH_TRACE = 20,
+    DB_CLI_RT_HASH_VERIFY = 21,
+    DB_CLI_RT_RESULTS_FILE = 22,
+    DB_CLI_RT_RESULTS_FORMAT = 23,
+    DB_CLI_RT_REPEAT = 24,
+    DB_CLI_RT_WARMUP_CV = 25,
+    DB_CLI_RT_WARMUP_FRAMES = 26,
+    DB_CLI_RT_WARMUP_MS = 27,
+    DB_CLI_RT_SWEEP = 28,
+    DB_CLI_RT_PERF_COUNTERS = 29,
+    DB_CLI_RT_TRACE_FILE = 30,
+    DB_CLI_RT_PACER_CATCHUP = 31,
+    DB_CLI_RT_PACER_SPIN_US = 32,
+    DB_CLI_RT_GRADIENT_PLANNER = 33,
+    DB_CLI_RT_CHECKPOINT_FILE = 34,
+    DB_CLI_RT_CHECKPOINT_INTERVAL = 35,
+    DB_CLI_RT_START_FRAME = 36,
 };
 
 #define DB_CLI_RUNTIME_TEXT_LEN 64U
-#define DB_CLI_RUNTIME_TEXT_SLOTS 32U
+#define DB_CLI_RUNTIME_TEXT_SLOTS 64U
 
 static struct {
     char slots[DB_CLI_RUNTIME_TEXT_SLOTS][DB_CLI_RUNTIME_TEXT_LEN];
@@ -160,7 +225,31 @@ static double db_cli_parse_fps_cap_or_exit(const char *raw_value) {
     return parsed;
 }
 
-static void db_cli_set_runtime_bench_speed_or_exit(const char *raw_value) {
+static double db_cli_parse_non_negative_or_exit(const char *cli_option,
+                                                const char *raw_value) {
+    char *end = NULL;
+    const double parsed = strtod(raw_value, &end);
+    if ((end == raw_value) || (end == NULL) || (*end != '\0') ||
+        !isfinite(parsed) || (parsed < 0.0)) {
+        db_failf("driverbench_cli", "invalid value for %s: %s (expected >= 0)",
+                 cli_option, raw_value);
+    }
+    return parsed;
+}
+
+static uint32_t db_cli_parse_repeat_or_exit(const char *raw_value) {
+    char *end = NULL;
+    const unsigned long parsed = strtoul(raw_value, &end, 10);
+    if ((end == raw_value) || (end == NULL) || (*end != '\0') ||
+        (parsed == 0UL) || (parsed > DB_REPEAT_COUNT_MAX)) {
+        db_failf("driverbench_cli",
+                 "invalid value for --repeat: %s (expected: 1..%u)", raw_value,
+                 DB_REPEAT_COUNT_MAX);
+    }
+    return (uint32_t)parsed;
+}
+
+static const char *db_cli_normalize_bench_speed_or_exit(const char *raw_value) {
     char *end = NULL;
     const double parsed = strtod(raw_value, &end);
     if ((end == raw_value) || (end == NULL) || (*end != '\0') ||
@@ -176,7 +265,107 @@ static void db_cli_set_runtime_bench_speed_or_exit(const char *raw_value) {
 
     char normalized[32];
     (void)db_snprintf(normalized, sizeof(normalized), "%.9g", parsed);
+    return db_cli_store_runtime_text_or_exit(normalized);
+}
+
+static void db_cli_set_runtime_bench_speed_or_exit(const char *raw_value) {
     db_runtime_option_set(DB_RUNTIME_OPT_BENCH_SPEED,
+                          db_cli_normalize_bench_speed_or_exit(raw_value));
+}
+
+static void db_cli_set_runtime_cpu_threads_or_exit(const char *raw_value) {
+    char *end = NULL;
+    const unsigned long parsed = strtoul(raw_value, &end, 10);
+    if ((end == raw_value) || (end == NULL) || (*end != '\0') ||
+        (parsed == 0UL) || (parsed > DB_WORKER_POOL_MAX_THREADS)) {
+        db_failf("driverbench_cli",
+                 "invalid value for --cpu-threads: %s (expected: 1..%u)",
+                 raw_value, DB_WORKER_POOL_MAX_THREADS);
+    }
+
+    char normalized[32];
+    (void)db_snprintf(normalized, sizeof(normalized), "%lu", parsed);
+    db_runtime_option_set(DB_RUNTIME_OPT_CPU_THREADS,
+                          db_cli_store_runtime_text_or_exit(normalized));
+}
+
+static void db_cli_set_runtime_cpu_kernel_or_exit(const char *raw_value) {
+    if (db_cpu_kernel_name_is_valid(raw_value) == 0) {
+        db_failf("driverbench_cli",
+                 "invalid value for --cpu-kernel: %s "
+                 "(expected: auto|scalar|sse2|avx2|avx512)",
+                 raw_value);
+    }
+    db_runtime_option_set(DB_RUNTIME_OPT_CPU_KERNEL,
+                          db_cli_store_runtime_text_or_exit(raw_value));
+}
+
+static void db_cli_set_runtime_cpu_blend_or_exit(const char *raw_value) {
+    db_cpu_blend_mode_t mode = DB_CPU_BLEND_FIXED;
+    if ((raw_value[0] == '\0') ||
+        (db_cpu_blend_mode_parse(raw_value, &mode) == 0)) {
+        db_failf("driverbench_cli",
+                 "invalid value for --cpu-blend: %s "
+                 "(expected: fixed|float|validate)",
+                 raw_value);
+    }
+    db_runtime_option_set(DB_RUNTIME_OPT_CPU_BLEND,
+                          db_cpu_blend_mode_name(mode));
+}
+
+static void db_cli_set_runtime_gradient_planner_or_exit(const char *raw_value) {
+    db_gradient_planner_t planner = DB_GRADIENT_PLANNER_CLOSED;
+    if ((raw_value[0] == '\0') ||
+        (db_gradient_planner_parse(raw_value, &planner) == 0)) {
+        db_failf("driverbench_cli",
+                 "invalid value for --gradient-planner: %s "
+                 "(expected: closed|iterative|validate)",
+                 raw_value);
+    }
+    db_runtime_option_set(DB_RUNTIME_OPT_GRADIENT_PLANNER,
+                          db_gradient_planner_name(planner));
+}
+
+static void db_cli_set_runtime_cpu_layout_or_exit(const char *raw_value) {
+    db_cpu_layout_kind_t kind = DB_CPU_LAYOUT_LINEAR;
+    if ((raw_value[0] == '\0') ||
+        (db_cpu_layout_parse(raw_value, &kind) == 0)) {
+        db_failf("driverbench_cli",
+                 "invalid value for --cpu-layout: %s "
+                 "(expected: linear|tiled|morton)",
+                 raw_value);
+    }
+    db_runtime_option_set(DB_RUNTIME_OPT_CPU_LAYOUT, db_cpu_layout_name(kind));
+}
+
+static void db_cli_set_runtime_cpu_mem_or_exit(const char *raw_value) {
+    db_mem_policy_t policy = {0};
+    if ((raw_value[0] == '\0') ||
+        (db_mem_policy_parse(raw_value, &policy) == 0)) {
+        db_failf("driverbench_cli",
+                 "invalid value for --cpu-mem: %s "
+                 "(expected: default|hugepage|numa=N)",
+                 raw_value);
+    }
+    char policy_text[DB_CLI_RUNTIME_TEXT_LEN];
+    db_mem_policy_format(&policy, policy_text, sizeof(policy_text));
+    db_runtime_option_set(DB_RUNTIME_OPT_CPU_MEM,
+                          db_cli_store_runtime_text_or_exit(policy_text));
+}
+
+static void db_cli_set_runtime_grid_or_exit(const char *raw_value) {
+    uint32_t width = 0U;
+    uint32_t height = 0U;
+    if (db_parse_grid_size_text(raw_value, &width, &height) == 0) {
+        db_failf("driverbench_cli",
+                 "invalid value for --grid: %s (expected: WxH, max %ux%u)",
+                 raw_value, DB_GRID_MAX_WIDTH, DB_GRID_MAX_HEIGHT);
+    }
+    db_grid_size_set(width, height);
+
+    char normalized[32];
+    (void)db_snprintf(normalized, sizeof(normalized), "%ux%u", width, height);
+    db_runtime_option_set(DB_RUNTIME_OPT_GRID,
                           db_cli_store_runtime_text_or_exit(normalized));
 }
 
@@ -197,16 +386,110 @@ static void db_cli_set_runtime_mode_or_exit(const char *raw_value) {
 static const char *db_cli_parse_hash_report_or_exit(const char *raw_value) {
     if (db_string_is(raw_value, "final") ||
         db_string_is(raw_value, "aggregate") ||
+        db_string_is(raw_value, "combined") ||
         db_string_is(raw_value, "both")) {
         return raw_value;
     }
     db_failf("driverbench_cli",
              "invalid value for --hash-report: %s "
-             "(expected: final|aggregate|both)",
+             "(expected: final|aggregate|combined|both)",
              raw_value);
     return "both";
 }
 
+static db_hash_algo_t db_cli_parse_hash_algo_or_exit(const char *raw_value) {
+    db_hash_algo_t algo = DB_HASH_ALGO_FNV1A;
+    if ((raw_value[0] == '\0') ||
+        (db_hash_algo_parse(raw_value, &algo) == 0)) {
+        db_failf("driverbench_cli",
+                 "invalid value for --hash-algo: %s "
+                 "(expected: fnv1a|xxh3|crc32c)",
+                 raw_value);
+    }
+    return algo;
+}
+
+static db_hash_incremental_t
+db_cli_parse_hash_incremental_or_exit(const char *raw_value) {
+    db_hash_incremental_t mode = DB_HASH_INCREMENTAL_OFF;
+    if ((raw_value[0] == '\0') ||
+        (db_hash_incremental_parse(raw_value, &mode) == 0)) {
+        db_failf("driverbench_cli",
+                 "invalid value for --hash-incremental: %s "
+                 "(expected: 0|1|validate)",
+                 raw_value);
+    }
+    return mode;
+}
+
+static uint32_t db_cli_parse_hash_queue_depth_or_exit(const char *raw_value) {
+    char *end = NULL;
+    const unsigned long parsed = strtoul(raw_value, &end, 10);
+    if ((end == raw_value) || (end == NULL) || (*end != '\0') ||
+        (parsed > DB_HASH_QUEUE_DEPTH_MAX)) {
+        db_failf("driverbench_cli",
+                 "invalid value for --hash-queue-depth: %s (expected 0..%u)",
+                 raw_value, DB_HASH_QUEUE_DEPTH_MAX);
+    }
+    return (uint32_t)parsed;
+}
+
+static uint32_t db_cli_parse_pacer_spin_us_or_exit(const char *raw_value) {
+    char *end = NULL;
+    const unsigned long parsed = strtoul(raw_value, &end, 10);
+    if ((end == raw_value) || (end == NULL) || (*end != '\0') ||
+        (parsed > DB_PACER_MAX_SPIN_US)) {
+        db_failf("driverbench_cli",
+                 "invalid value for --pacer-spin-us: %s (expected 0..%u)",
+                 raw_value, DB_PACER_MAX_SPIN_US);
+    }
+    return (uint32_t)parsed;
+}
+
+static db_pacer_catchup_t
+db_cli_parse_pacer_catchup_or_exit(const char *raw_value) {
+    db_pacer_catchup_t catchup = DB_PACER_CATCHUP_SKIP_AHEAD;
+    if (db_pacer_catchup_parse(raw_value, &catchup) == 0) {
+        db_failf("driverbench_cli",
+                 "invalid value for --pacer-catchup: %s "
+                 "(expected: skip-ahead|drop)",
+                 raw_value);
+    }
+    return catchup;
+}
+
+static const char *db_cli_parse_path_or_exit(const char *cli_option,
+                                             const char *raw_value) {
+    if (raw_value[0] == '\0') {
+        db_failf("driverbench_cli", "%s requires a file path", cli_option);
+    }
+    return raw_value;
+}
+
+static db_results_format_t
+db_cli_parse_results_format_or_exit(const char *raw_value) {
+    db_results_format_t format = DB_RESULTS_FORMAT_JSONL;
+    if (db_results_format_parse(raw_value, &format) == 0) {
+        db_failf("driverbench_cli",
+                 "invalid value for --results-format: %s "
+                 "(expected: jsonl|csv)",
+                 raw_value);
+    }
+    return format;
+}
+
+static uint32_t db_cli_parse_perf_counters_or_exit(const char *raw_value) {
+    uint32_t mask = 0U;
+    if (db_perf_counters_parse(raw_value, &mask) == 0) {
+        db_failf("driverbench_cli",
+                 "invalid value for --perf-counters: %s "
+                 "(expected: comma-separated "
+                 "cycles|instructions|cache-misses|branch-misses|page-faults)",
+                 raw_value);
+    }
+    return mask;
+}
+
 static const char *db_cli_parse_hash_mode_or_exit(const char *raw_value) {
     if (db_string_is(raw_value, "none") || db_string_is(raw_value, "state") ||
         db_string_is(raw_value, "pixel") || db_string_is(raw_value, "both")) {
@@ -273,6 +556,12 @@ static void db_parse_renderer_or_exit(const char *value, db_cli_config_t *cfg) {
         cfg->renderer_is_auto = 1;
         return;
     }
+    db_cpu_renderer_t cpu_renderer = DB_CPU_RENDERER_AUTO;
+    if (db_cpu_renderer_parse(value, &cpu_renderer) != 0) {
+        cfg->cpu_renderer = cpu_renderer;
+        cfg->cpu_renderer_is_set = 1;
+        return;
+    }
     cfg->renderer_is_auto = 0;
     if (db_string_is(value, "gl1_5_gles1_1")) {
         cfg->renderer = DB_GL_RENDERER_GL1_5_GLES1_1;
@@ -289,6 +578,89 @@ static void db_parse_renderer_or_exit(const char *value, db_cli_config_t *cfg) {
     db_failf("driverbench_cli", "Unsupported renderer: %s", value);
 }
 
+static void db_cli_add_sweep_value_or_exit(db_cli_sweep_t *sweep,
+                                           const char *key,
+                                           const char *value) {
+    if (db_string_is(key, "mode")) {
+        if (sweep->mode_count >= DB_SWEEP_AXIS_MAX) {
+            db_failf("driverbench_cli", "--sweep: too many mode values");
+        }
+        const char *mode = db_cli_mode_normalized_or_null(value);
+        if (mode == NULL) {
+            db_failf("driverbench_cli", "--sweep: invalid mode: %s", value);
+        }
+        sweep->modes[sweep->mode_count++] = mode;
+        return;
+    }
+    if (db_string_is(key, "speed")) {
+        if (sweep->speed_count >= DB_SWEEP_AXIS_MAX) {
+            db_failf("driverbench_cli", "--sweep: too many speed values");
+        }
+        sweep->speeds[sweep->speed_count++] =
+            db_cli_normalize_bench_speed_or_exit(value);
+        return;
+    }
+    if (db_string_is(key, "api")) {
+        if (sweep->api_count >= DB_SWEEP_AXIS_MAX) {
+            db_failf("driverbench_cli", "--sweep: too many api values");
+        }
+        db_cli_config_t parsed = {0};
+        db_parse_api_or_exit(value, &parsed);
+        if (parsed.api_is_auto != 0) {
+            db_failf("driverbench_cli",
+                     "--sweep: api must be cpu, opengl or vulkan");
+        }
+        sweep->apis[sweep->api_count++] = parsed.api;
+        return;
+    }
+    if (db_string_is(key, "renderer")) {
+        if (sweep->renderer_count >= DB_SWEEP_AXIS_MAX) {
+            db_failf("driverbench_cli", "--sweep: too many renderer values");
+        }
+        db_cli_config_t parsed = {0};
+        db_parse_renderer_or_exit(value, &parsed);
+        sweep->renderers[sweep->renderer_count++] = (db_cli_sweep_renderer_t){
+            .name = db_cli_store_runtime_text_or_exit(value),
+            .is_auto = parsed.renderer_is_auto,
+            .is_cpu = parsed.cpu_renderer_is_set,
+            .cpu_renderer = parsed.cpu_renderer,
+            .gl_renderer = parsed.renderer,
+        };
+        return;
+    }
+    db_failf("driverbench_cli",
+             "--sweep: unknown axis '%s' (expected: mode|speed|api|renderer)",
+             key);
+}
+
+// Parses "key=v1,v2;key=v3" into per-axis value lists.
+static void db_cli_parse_sweep_or_exit(const char *raw_value,
+                                       db_cli_config_t *cfg) {
+    char spec[512];
+    const int written = db_snprintf(spec, sizeof(spec), "%s", raw_value);
+    if ((written <= 0) || ((size_t)written >= sizeof(spec))) {
+        db_failf("driverbench_cli", "invalid value for --sweep: %s",
+                 raw_value);
+    }
+    cfg->sweep = (db_cli_sweep_t){0};
+    char *axis_save = NULL;
+    for (char *axis = strtok_r(spec, ";", &axis_save); axis != NULL;
+         axis = strtok_r(NULL, ";", &axis_save)) {
+        char *eq = strchr(axis, '=');
+        if ((eq == NULL) || (eq == axis) || (eq[1] == '\0')) {
+            db_failf("driverbench_cli",
+                     "invalid --sweep axis '%s' (expected key=v1,v2)", axis);
+        }
+        *eq = '\0';
+        char *value_save = NULL;
+        for (char *value = strtok_r(eq + 1, ",", &value_save); value != NULL;
+             value = strtok_r(NULL, ",", &value_save)) {
+            db_cli_add_sweep_value_or_exit(&cfg->sweep, axis, value);
+        }
+    }
+    cfg->sweep_enabled = 1;
+}
+
 static int db_try_parse_runtime_override_option(const char *arg, int argc,
                                                 char **argv, int *index,
                                                 db_cli_config_t *cfg) {
@@ -297,13 +669,51 @@ static int db_try_parse_runtime_override_option(const char *arg, int argc,
          DB_CLI_RT_BOOL},
         {"--bench-speed", DB_RUNTIME_OPT_BENCH_SPEED, DB_CLI_RT_BENCH_SPEED},
         {"--benchmark-mode", DB_RUNTIME_OPT_BENCHMARK_MODE, DB_CLI_RT_MODE},
+        {"--checkpoint-file", DB_RUNTIME_OPT_CHECKPOINT_FILE,
+         DB_CLI_RT_CHECKPOINT_FILE},
+        {"--checkpoint-interval", DB_RUNTIME_OPT_CHECKPOINT_INTERVAL,
+         DB_CLI_RT_CHECKPOINT_INTERVAL},
+        {"--cpu-blend", DB_RUNTIME_OPT_CPU_BLEND, DB_CLI_RT_CPU_BLEND},
+        {"--cpu-kernel", DB_RUNTIME_OPT_CPU_KERNEL, DB_CLI_RT_CPU_KERNEL},
+        {"--cpu-layout", DB_RUNTIME_OPT_CPU_LAYOUT, DB_CLI_RT_CPU_LAYOUT},
+        {"--cpu-mem", DB_RUNTIME_OPT_CPU_MEM, DB_CLI_RT_CPU_MEM},
+        {"--cpu-threads", DB_RUNTIME_OPT_CPU_THREADS, DB_CLI_RT_CPU_THREADS},
         {"--fps-cap", DB_RUNTIME_OPT_FPS_CAP, DB_CLI_RT_FPS_CAP},
         {"--hash", DB_RUNTIME_OPT_HASH, DB_CLI_RT_HASH_MODE},
         {"--frame-limit", DB_RUNTIME_OPT_FRAME_LIMIT, DB_CLI_RT_FRAME_LIMIT},
+        {"--gradient-planner", DB_RUNTIME_OPT_GRADIENT_PLANNER,
+         DB_CLI_RT_GRADIENT_PLANNER},
+        {"--grid", DB_RUNTIME_OPT_GRID, DB_CLI_RT_GRID},
+        {"--hash-algo", DB_RUNTIME_OPT_HASH_ALGO, DB_CLI_RT_HASH_ALGO},
+        {"--hash-incremental", DB_RUNTIME_OPT_HASH_INCREMENTAL,
+         DB_CLI_RT_HASH_INCREMENTAL},
+        {"--hash-queue-depth", DB_RUNTIME_OPT_HASH_QUEUE_DEPTH,
+         DB_CLI_RT_HASH_QUEUE_DEPTH},
+        {"--hash-trace", DB_RUNTIME_OPT_HASH_TRACE, DB_CLI_RT_HASH_TRACE},
+        {"--hash-verify", DB_RUNTIME_OPT_HASH_VERIFY, DB_CLI_RT_HASH_VERIFY},
         {"--hash-report", DB_RUNTIME_OPT_HASH_REPORT, DB_CLI_RT_HASH_REPORT},
         {"--offscreen", DB_RUNTIME_OPT_OFFSCREEN, DB_CLI_RT_OFFSCREEN},
+        {"--pacer-catchup", DB_RUNTIME_OPT_PACER_CATCHUP,
+         DB_CLI_RT_PACER_CATCHUP},
+        {"--pacer-spin-us", DB_RUNTIME_OPT_PACER_SPIN_US,
+         DB_CLI_RT_PACER_SPIN_US},
+        {"--perf-counters", DB_RUNTIME_OPT_PERF_COUNTERS,
+         DB_CLI_RT_PERF_COUNTERS},
         {"--random-seed", DB_RUNTIME_OPT_RANDOM_SEED, DB_CLI_RT_RANDOM_SEED},
+        {"--repeat", DB_RUNTIME_OPT_REPEAT, DB_CLI_RT_REPEAT},
+        {"--resolution-sweep", DB_RUNTIME_OPT_RESOLUTION_SWEEP,
+         DB_CLI_RT_RESOLUTION_SWEEP},
+        {"--results-file", DB_RUNTIME_OPT_RESULTS_FILE, DB_CLI_RT_RESULTS_FILE},
+        {"--results-format", DB_RUNTIME_OPT_RESULTS_FORMAT,
+         DB_CLI_RT_RESULTS_FORMAT},
+        {"--start-frame", DB_RUNTIME_OPT_START_FRAME, DB_CLI_RT_START_FRAME},
+        {"--sweep", DB_RUNTIME_OPT_SWEEP, DB_CLI_RT_SWEEP},
+        {"--trace-file", DB_RUNTIME_OPT_TRACE_FILE, DB_CLI_RT_TRACE_FILE},
         {"--vsync", DB_RUNTIME_OPT_VSYNC, DB_CLI_RT_VSYNC},
+        {"--warmup-cv", DB_RUNTIME_OPT_WARMUP_CV, DB_CLI_RT_WARMUP_CV},
+        {"--warmup-frames", DB_RUNTIME_OPT_WARMUP_FRAMES,
+         DB_CLI_RT_WARMUP_FRAMES},
+        {"--warmup-ms", DB_RUNTIME_OPT_WARMUP_MS, DB_CLI_RT_WARMUP_MS},
     };
 
     for (size_t map_index = 0;
@@ -325,10 +735,96 @@ static int db_try_parse_runtime_override_option(const char *arg, int argc,
                 db_cli_set_runtime_random_seed_or_exit(value);
             } else if (mappings[map_index].kind == DB_CLI_RT_HASH_REPORT) {
                 cfg->hash_report = db_cli_parse_hash_report_or_exit(value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_HASH_ALGO) {
+                cfg->hash_algo = db_cli_parse_hash_algo_or_exit(value);
+            } else if (mappings[map_index].kind ==
+                       DB_CLI_RT_HASH_INCREMENTAL) {
+                cfg->hash_incremental =
+                    db_cli_parse_hash_incremental_or_exit(value);
+            } else if (mappings[map_index].kind ==
+                       DB_CLI_RT_HASH_QUEUE_DEPTH) {
+                cfg->hash_queue_depth =
+                    db_cli_parse_hash_queue_depth_or_exit(value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_HASH_TRACE) {
+                cfg->hash_trace_path =
+                    db_cli_parse_path_or_exit("--hash-trace", value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_HASH_VERIFY) {
+                cfg->hash_verify_path =
+                    db_cli_parse_path_or_exit("--hash-verify", value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_CHECKPOINT_FILE) {
+                cfg->checkpoint_path =
+                    db_cli_parse_path_or_exit("--checkpoint-file", value);
+            } else if (mappings[map_index].kind ==
+                       DB_CLI_RT_CHECKPOINT_INTERVAL) {
+                cfg->checkpoint_interval = db_cli_parse_frame_limit_or_exit(
+                    mappings[map_index].cli_option, value);
+                if (cfg->checkpoint_interval == 0U) {
+                    db_failf("driverbench_cli",
+                             "invalid value for --checkpoint-interval: %s "
+                             "(expected > 0)",
+                             value);
+                }
+            } else if (mappings[map_index].kind == DB_CLI_RT_START_FRAME) {
+                cfg->start_frame = db_cli_parse_frame_limit_or_exit(
+                    mappings[map_index].cli_option, value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_RESULTS_FILE) {
+                cfg->results_path =
+                    db_cli_parse_path_or_exit("--results-file", value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_TRACE_FILE) {
+                cfg->trace_path =
+                    db_cli_parse_path_or_exit("--trace-file", value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_RESULTS_FORMAT) {
+                cfg->results_format =
+                    db_cli_parse_results_format_or_exit(value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_PACER_CATCHUP) {
+                cfg->pacer_catchup = db_cli_parse_pacer_catchup_or_exit(value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_PACER_SPIN_US) {
+                cfg->pacer_spin_us = db_cli_parse_pacer_spin_us_or_exit(value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_PERF_COUNTERS) {
+                cfg->perf_counters_mask =
+                    db_cli_parse_perf_counters_or_exit(value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_SWEEP) {
+                db_cli_parse_sweep_or_exit(value, cfg);
+            } else if (mappings[map_index].kind == DB_CLI_RT_REPEAT) {
+                cfg->repeat_count = db_cli_parse_repeat_or_exit(value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_WARMUP_CV) {
+                cfg->warmup_cv_pct = db_cli_parse_non_negative_or_exit(
+                    mappings[map_index].cli_option, value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_WARMUP_FRAMES) {
+                cfg->warmup_frames = db_cli_parse_frame_limit_or_exit(
+                    mappings[map_index].cli_option, value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_WARMUP_MS) {
+                cfg->warmup_ms = db_cli_parse_non_negative_or_exit(
+                    mappings[map_index].cli_option, value);
             } else if (mappings[map_index].kind == DB_CLI_RT_HASH_MODE) {
                 cfg->hash_mode = db_cli_parse_hash_mode_or_exit(value);
             } else if (mappings[map_index].kind == DB_CLI_RT_BENCH_SPEED) {
                 db_cli_set_runtime_bench_speed_or_exit(value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_CPU_THREADS) {
+                db_cli_set_runtime_cpu_threads_or_exit(value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_CPU_KERNEL) {
+                db_cli_set_runtime_cpu_kernel_or_exit(value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_CPU_BLEND) {
+                db_cli_set_runtime_cpu_blend_or_exit(value);
+            } else if (mappings[map_index].kind ==
+                       DB_CLI_RT_GRADIENT_PLANNER) {
+                db_cli_set_runtime_gradient_planner_or_exit(value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_CPU_LAYOUT) {
+                db_cli_set_runtime_cpu_layout_or_exit(value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_CPU_MEM) {
+                db_cli_set_runtime_cpu_mem_or_exit(value);
+            } else if (mappings[map_index].kind == DB_CLI_RT_GRID) {
+                db_cli_set_runtime_grid_or_exit(value);
+            } else if (mappings[map_index].kind ==
+                       DB_CLI_RT_RESOLUTION_SWEEP) {
+                int parsed = 0;
+                if (db_parse_bool_text(value, &parsed) == 0) {
+                    db_failf("driverbench_cli",
+                             "invalid value for --resolution-sweep: %s "
+                             "(expected bool)",
+                             value);
+                }
+                cfg->resolution_sweep = (parsed != 0);
             } else if (mappings[map_index].kind == DB_CLI_RT_OFFSCREEN) {
                 int parsed = 0;
                 if (db_parse_bool_text(value, &parsed) == 0) {
@@ -458,6 +954,36 @@ static void db_cli_validate_hash_mode_or_exit(const db_cli_config_t *cfg) {
     }
 }
 
+static void db_cli_validate_hash_trace_or_exit(const db_cli_config_t *cfg) {
+    if ((cfg->hash_trace_path == NULL) && (cfg->hash_verify_path == NULL)) {
+        return;
+    }
+    if (db_cli_resolve_effective_api_or_exit(cfg) != DB_API_CPU) {
+        db_failf("driverbench_cli",
+                 "--hash-trace/--hash-verify require --api cpu");
+    }
+    if (cfg->resolution_sweep != 0) {
+        db_failf("driverbench_cli", "--hash-trace/--hash-verify cannot be "
+                                    "combined with --resolution-sweep");
+    }
+}
+
+static void db_cli_validate_start_frame_or_exit(const db_cli_config_t *cfg) {
+    if ((cfg->start_frame == 0U) && (cfg->checkpoint_path == NULL)) {
+        return;
+    }
+    if ((db_cli_resolve_effective_api_or_exit(cfg) != DB_API_CPU) ||
+        (cfg->display != DB_DISPLAY_OFFSCREEN)) {
+        db_failf("driverbench_cli", "--start-frame/--checkpoint-file require "
+                                    "--api cpu --display offscreen");
+    }
+    if ((cfg->resolution_sweep != 0) || (cfg->sweep_enabled != 0)) {
+        db_failf("driverbench_cli",
+                 "--start-frame/--checkpoint-file cannot be combined with "
+                 "--sweep or --resolution-sweep");
+    }
+}
+
 void db_cli_parse_or_exit(int argc, char **argv, db_cli_config_t *out_cfg) {
     if (out_cfg == NULL) {
         db_failf("driverbench_cli", "output config is null");
@@ -474,13 +1000,34 @@ void db_cli_parse_or_exit(int argc, char **argv, db_cli_config_t *out_cfg) {
         .kms_card = "/dev/dri/card0",
         .hash_mode = "none",
         .hash_report = "both",
+        .hash_algo = DB_HASH_ALGO_FNV1A,
+        .hash_incremental = DB_HASH_INCREMENTAL_OFF,
+        .hash_queue_depth = 0U,
+        .hash_trace_path = NULL,
+        .hash_verify_path = NULL,
+        .results_path = NULL,
+        .results_format = DB_RESULTS_FORMAT_JSONL,
+        .trace_path = NULL,
         .fps_cap = BENCH_FPS_CAP_D,
+        .pacer_spin_us = DB_PACER_DEFAULT_SPIN_US,
+        .pacer_catchup = DB_PACER_CATCHUP_SKIP_AHEAD,
         .frame_limit = 0U,
+        .start_frame = 0U,
+        .checkpoint_path = NULL,
+        .checkpoint_interval = DB_HASH_TRACE_CHECKPOINT_INTERVAL,
         .offscreen_enabled = 0,
         .vsync_enabled = (BENCH_GLFW_SWAP_INTERVAL != 0),
         .api_is_auto = 1,
         .display_is_set = 0,
         .renderer_is_auto = 1,
+        .cpu_renderer = DB_CPU_RENDERER_AUTO,
+        .cpu_renderer_is_set = 0,
+        .resolution_sweep = 0,
+        .repeat_count = 1U,
+        .warmup_frames = 0U,
+        .warmup_ms = 0.0,
+        .warmup_cv_pct = 0.0,
+        .perf_counters_mask = 0U,
     };
 
     for (int i = 1; i < argc; i++) {
@@ -520,6 +1067,45 @@ void db_cli_parse_or_exit(int argc, char **argv, db_cli_config_t *out_cfg) {
                                     "<offscreen|glfw_window|linux_kms_atomic>");
     }
 
+    if ((out_cfg->resolution_sweep != 0) && (out_cfg->frame_limit == 0U)) {
+        db_failf("driverbench_cli",
+                 "--resolution-sweep requires --frame-limit > 0");
+    }
+    if ((out_cfg->resolution_sweep != 0) && (out_cfg->repeat_count > 1U)) {
+        db_failf("driverbench_cli",
+                 "--repeat cannot be combined with --resolution-sweep");
+    }
+    if ((out_cfg->repeat_count > 1U) && (out_cfg->frame_limit == 0U)) {
+        db_failf("driverbench_cli", "--repeat requires --frame-limit > 0");
+    }
+    if ((out_cfg->sweep_enabled != 0) && (out_cfg->frame_limit == 0U)) {
+        db_failf("driverbench_cli", "--sweep requires --frame-limit > 0");
+    }
+    if ((out_cfg->sweep_enabled != 0) &&
+        ((out_cfg->resolution_sweep != 0) ||
+         (out_cfg->hash_trace_path != NULL) ||
+         (out_cfg->hash_verify_path != NULL))) {
+        db_failf("driverbench_cli",
+                 "--sweep cannot be combined with --resolution-sweep or "
+                 "--hash-trace/--hash-verify");
+    }
+    db_benchmark_warmup_set(out_cfg->warmup_frames, out_cfg->warmup_ms,
+                            out_cfg->warmup_cv_pct);
+    db_pacer_configure(out_cfg->pacer_spin_us, out_cfg->pacer_catchup);
+    db_perf_counters_configure(out_cfg->perf_counters_mask);
+
+    if (out_cfg->cpu_renderer_is_set != 0) {
+        if (out_cfg->api_is_auto != 0) {
+            out_cfg->api = DB_API_CPU;
+            out_cfg->api_is_auto = 0;
+        } else if (out_cfg->api != DB_API_CPU) {
+            db_failf("driverbench_cli", "--renderer %s requires --api cpu",
+                     db_cpu_renderer_name(out_cfg->cpu_renderer));
+        }
+    }
+
     db_cli_validate_compiled_support_or_exit(out_cfg);
     db_cli_validate_hash_mode_or_exit(out_cfg);
+    db_cli_validate_hash_trace_or_exit(out_cfg);
+    db_cli_validate_start_frame_or_exit(out_cfg);
 }
@@ -3,22 +3,73 @@
 
 #include <stdint.h>
 
+#include "core/db_core.h"
+#include "core/db_hash.h"
+#include "core/db_results.h"
 #include "displays/display_dispatch.h"
+#include "renderers/cpu_renderer/renderer_cpu_renderer.h"
+
+#define DB_SWEEP_AXIS_MAX 16U
+
+typedef struct {
+    const char *name;
+    int is_auto;
+    int is_cpu;
+    db_cpu_renderer_t cpu_renderer;
+    db_gl_renderer_t gl_renderer;
+} db_cli_sweep_renderer_t;
+
+// --sweep axes; an axis with count 0 keeps the value from the other flags.
+typedef struct {
+    const char *modes[DB_SWEEP_AXIS_MAX];
+    uint32_t mode_count;
+    const char *speeds[DB_SWEEP_AXIS_MAX];
+    uint32_t speed_count;
+    db_api_t apis[DB_SWEEP_AXIS_MAX];
+    uint32_t api_count;
+    db_cli_sweep_renderer_t renderers[DB_SWEEP_AXIS_MAX];
+    uint32_t renderer_count;
+} db_cli_sweep_t;
 
 typedef struct db_cli_config {
     db_api_t api;
     db_display_t display;
     db_gl_renderer_t renderer;
+    db_cpu_renderer_t cpu_renderer;
     const char *kms_card;
     const char *hash_mode;
     const char *hash_report;
+    db_hash_algo_t hash_algo;
+    db_hash_incremental_t hash_incremental;
+    uint32_t hash_queue_depth;
+    const char *hash_trace_path;
+    const char *hash_verify_path;
+    const char *results_path;
+    db_results_format_t results_format;
+    const char *trace_path;
     double fps_cap;
+    uint32_t pacer_spin_us;
+    db_pacer_catchup_t pacer_catchup;
     uint32_t frame_limit;
+    // Frame the run starts at; earlier frames are skipped by seeking.
+    uint32_t start_frame;
+    const char *checkpoint_path;
+    uint32_t checkpoint_interval;
     int offscreen_enabled;
     int vsync_enabled;
     int api_is_auto;
     int display_is_set;
     int renderer_is_auto;
+    int cpu_renderer_is_set;
+    int resolution_sweep;
+    uint32_t repeat_count;
+    uint32_t warmup_frames;
+    double warmup_ms;
+    double warmup_cv_pct;
+    // Bit per db_perf_event_t; 0 disables --perf-counters.
+    uint32_t perf_counters_mask;
+    int sweep_enabled;
+    db_cli_sweep_t sweep;
 } db_cli_config_t;
 
 void db_cli_parse_or_exit(int argc, char **argv, db_cli_config_t *out_cfg);
@@ -0,0 +1,433 @@
+#include "driverbench_compare.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/db_core.h"
+#include "core/db_stats.h"
+#include "displays/display_dispatch.h"
+
+#define DB_COMPARE_BACKEND "driverbench_compare"
+#define DB_COMPARE_LINE_BYTES 8192U
+#define DB_COMPARE_VALUE_BYTES 256U
+#define DB_COMPARE_KEY_BYTES 512U
+#define DB_COMPARE_CSV_COLUMNS_MAX 64U
+#define DB_COMPARE_SAMPLES_MAX (DB_REPEAT_COUNT_MAX + 28U)
+#define DB_COMPARE_METRIC_COUNT 3U
+
+typedef struct {
+    const char *field;
+    int higher_is_better;
+} db_compare_metric_t;
+
+static const db_compare_metric_t g_compare_metrics[DB_COMPARE_METRIC_COUNT] = {
+    {"ms_per_frame", 0},
+    {"p99_ms", 0},
+    {"mpix_per_s", 1},
+};
+
+// Record identity; two runs are comparable when all of these match.
+static const char *const g_compare_key_fields[] = {
+    "api",          "renderer",    "backend",    "capability_mode",
+    "cpu_renderer", "cpu_threads", "cpu_layout", "cpu_kernel",
+    "mode",         "speed",       "grid_width", "grid_height",
+    "hash_algo",
+};
+
+typedef struct {
+    double values[DB_COMPARE_SAMPLES_MAX];
+    uint32_t count;
+} db_compare_samples_t;
+
+typedef struct {
+    char key[DB_COMPARE_KEY_BYTES];
+    // [0] = baseline, [1] = candidate.
+    db_compare_samples_t samples[2][DB_COMPARE_METRIC_COUNT];
+} db_compare_cell_t;
+
+typedef struct {
+    db_compare_cell_t *cells;
+    size_t count;
+    size_t capacity;
+} db_compare_table_t;
+
+typedef struct {
+    int is_csv;
+    const char *json;
+    char *const *csv_header;
+    size_t csv_header_count;
+    char *csv_fields[DB_COMPARE_CSV_COLUMNS_MAX];
+    size_t csv_field_count;
+} db_compare_row_t;
+
+typedef struct {
+    const char *baseline_path;
+    const char *candidate_path;
+    double max_regress_pct[DB_COMPARE_METRIC_COUNT];
+    double alpha;
+} db_compare_options_t;
+
+static void db_compare_usage(void) {
+    fputs("Usage: driverbench compare <baseline> <candidate> [options]\n"
+          "\nOptions:\n"
+          "  --alpha <value>\n"
+          "  --max-mean-regress <percent>\n"
+          "  --max-mpix-regress <percent>\n"
+          "  --max-p99-regress <percent>\n",
+          stderr);
+}
+
+// Splits one CSV line in place; quoted fields may contain commas and "".
+static size_t db_compare_split_csv(char *line, char **fields,
+                                   size_t max_fields) {
+    size_t count = 0U;
+    char *read = line;
+    while ((count < max_fields) && (*read != '\0')) {
+        char *write = read;
+        fields[count++] = write;
+        int quoted = 0;
+        if (*read == '"') {
+            quoted = 1;
+            read++;
+        }
+        while (*read != '\0') {
+            if (quoted != 0) {
+                if ((read[0] == '"') && (read[1] == '"')) {
+                    *write++ = '"';
+                    read += 2;
+                    continue;
+                }
+                if (read[0] == '"') {
+                    quoted = 0;
+                    read++;
+                    continue;
+                }
+            } else if ((*read == ',') || (*read == '\n') || (*read == '\r')) {
+                break;
+            }
+            *write++ = *read++;
+        }
+        const char terminator = *read;
+        *write = '\0';
+        if (terminator != ',') {
+            break;
+        }
+        read++;
+        if (*read == '\0') {
+            fields[count++] = read;
+        }
+    }
+    return count;
+}
+
+// Copies a JSON string/number value; returns 0 for a missing key or null.
+static int db_compare_json_value(const char *json, const char *key, char *out,
+                                 size_t out_size) {
+    char pattern[DB_COMPARE_VALUE_BYTES];
+    (void)db_snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char *at = strstr(json, pattern);
+    if (at == NULL) {
+        return 0;
+    }
+    at += strlen(pattern);
+    size_t len = 0U;
+    if (*at == '"') {
+        at++;
+        while ((*at != '\0') && (*at != '"') && ((len + 1U) < out_size)) {
+            if ((at[0] == '\\') && (at[1] != '\0')) {
+                at++;
+            }
+            out[len++] = *at++;
+        }
+        out[len] = '\0';
+        return 1;
+    }
+    if (strncmp(at, "null", 4U) == 0) {
+        return 0;
+    }
+    while ((*at != '\0') && (*at != ',') && (*at != '}') &&
+           ((len + 1U) < out_size)) {
+        out[len++] = *at++;
+    }
+    out[len] = '\0';
+    return len > 0U;
+}
+
+static int db_compare_row_value(const db_compare_row_t *row, const char *key,
+                                char *out, size_t out_size) {
+    if (row->is_csv == 0) {
+        return db_compare_json_value(row->json, key, out, out_size);
+    }
+    for (size_t i = 0U; i < row->csv_header_count; i++) {
+        if (strcmp(row->csv_header[i], key) == 0) {
+            if ((i >= row->csv_field_count) ||
+                (row->csv_fields[i][0] == '\0')) {
+                return 0;
+            }
+            (void)db_snprintf(out, out_size, "%s", row->csv_fields[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static db_compare_cell_t *db_compare_find_cell(db_compare_table_t *table,
+                                               const char *key) {
+    for (size_t i = 0U; i < table->count; i++) {
+        if (strcmp(table->cells[i].key, key) == 0) {
+            return &table->cells[i];
+        }
+    }
+    if (table->count == table->capacity) {
+        const size_t capacity =
+            (table->capacity == 0U) ? 16U : (table->capacity * 2U);
+        db_compare_cell_t *cells = (db_compare_cell_t *)realloc(
+            table->cells, capacity * sizeof(db_compare_cell_t));
+        if (cells == NULL) {
+            db_failf(DB_COMPARE_BACKEND, "out of memory for %zu cells",
+                     capacity);
+        }
+        table->cells = cells;
+        table->capacity = capacity;
+    }
+    db_compare_cell_t *cell = &table->cells[table->count++];
+    memset(cell, 0, sizeof(*cell));
+    (void)db_snprintf(cell->key, sizeof(cell->key), "%s", key);
+    return cell;
+}
+
+static void db_compare_add_row(db_compare_table_t *table,
+                               const db_compare_row_t *row, size_t side,
+                               const char *path) {
+    char value[DB_COMPARE_VALUE_BYTES];
+    if ((db_compare_row_value(row, "record", value, sizeof(value)) == 0) ||
+        (strcmp(value, "final") != 0)) {
+        return;
+    }
+    char key[DB_COMPARE_KEY_BYTES] = {0};
+    size_t key_len = 0U;
+    for (size_t i = 0U;
+         i < (sizeof(g_compare_key_fields) / sizeof(g_compare_key_fields[0]));
+         i++) {
+        if (db_compare_row_value(row, g_compare_key_fields[i], value,
+                                 sizeof(value)) == 0) {
+            (void)db_snprintf(value, sizeof(value), "-");
+        }
+        const int written =
+            db_snprintf(&key[key_len], sizeof(key) - key_len, "%s%s=%s",
+                        (i > 0U) ? " " : "", g_compare_key_fields[i], value);
+        if ((written < 0) || ((size_t)written >= (sizeof(key) - key_len))) {
+            db_failf(DB_COMPARE_BACKEND, "record key too long in %s", path);
+        }
+        key_len += (size_t)written;
+    }
+
+    db_compare_cell_t *cell = db_compare_find_cell(table, key);
+    for (size_t m = 0U; m < DB_COMPARE_METRIC_COUNT; m++) {
+        if (db_compare_row_value(row, g_compare_metrics[m].field, value,
+                                 sizeof(value)) == 0) {
+            continue;
+        }
+        char *end = NULL;
+        const double parsed = strtod(value, &end);
+        if ((end == value) || !isfinite(parsed)) {
+            db_failf(DB_COMPARE_BACKEND, "invalid %s '%s' in %s",
+                     g_compare_metrics[m].field, value, path);
+        }
+        db_compare_samples_t *samples = &cell->samples[side][m];
+        if (samples->count >= DB_COMPARE_SAMPLES_MAX) {
+            db_failf(DB_COMPARE_BACKEND,
+                     "more than %u runs of one cell in %s",
+                     DB_COMPARE_SAMPLES_MAX, path);
+        }
+        samples->values[samples->count++] = parsed;
+    }
+}
+
+static void db_compare_load(db_compare_table_t *table, const char *path,
+                            size_t side) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        db_failf(DB_COMPARE_BACKEND, "failed to open results file: %s", path);
+    }
+    static char line[DB_COMPARE_LINE_BYTES];
+    static char header_line[DB_COMPARE_LINE_BYTES];
+    char *header[DB_COMPARE_CSV_COLUMNS_MAX];
+    size_t header_count = 0U;
+    int first_line = 1;
+    int is_csv = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (first_line != 0) {
+            first_line = 0;
+            if (line[0] != '{') {
+                is_csv = 1;
+                (void)db_snprintf(header_line, sizeof(header_line), "%s",
+                                  line);
+                header_count = db_compare_split_csv(
+                    header_line, header, DB_COMPARE_CSV_COLUMNS_MAX);
+                continue;
+            }
+        }
+        if ((line[0] == '\n') || (line[0] == '\0')) {
+            continue;
+        }
+        db_compare_row_t row = {
+            .is_csv = is_csv,
+            .json = line,
+            .csv_header = header,
+            .csv_header_count = header_count,
+        };
+        if (is_csv != 0) {
+            row.csv_field_count = db_compare_split_csv(
+                line, row.csv_fields, DB_COMPARE_CSV_COLUMNS_MAX);
+        }
+        db_compare_add_row(table, &row, side, path);
+    }
+    if (fclose(file) != 0) {
+        db_failf(DB_COMPARE_BACKEND, "failed to read results file: %s", path);
+    }
+}
+
+static double db_compare_parse_number_or_exit(const char *option,
+                                              const char *raw_value) {
+    char *end = NULL;
+    const double parsed = strtod(raw_value, &end);
+    if ((end == raw_value) || (end == NULL) || (*end != '\0') ||
+        !isfinite(parsed) || (parsed < 0.0)) {
+        db_failf(DB_COMPARE_BACKEND, "invalid value for %s: %s", option,
+                 raw_value);
+    }
+    return parsed;
+}
+
+static void db_compare_parse_or_exit(int argc, char **argv,
+                                     db_compare_options_t *out_options) {
+    *out_options = (db_compare_options_t){
+        .max_regress_pct = {DB_COMPARE_DEFAULT_MAX_MEAN_PCT,
+                            DB_COMPARE_DEFAULT_MAX_P99_PCT,
+                            DB_COMPARE_DEFAULT_MAX_MPIX_PCT},
+        .alpha = DB_COMPARE_DEFAULT_ALPHA,
+    };
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--help") == 0) {
+            db_compare_usage();
+            exit(EXIT_SUCCESS);
+        }
+        if (strncmp(arg, "--", 2U) != 0) {
+            if (out_options->baseline_path == NULL) {
+                out_options->baseline_path = arg;
+            } else if (out_options->candidate_path == NULL) {
+                out_options->candidate_path = arg;
+            } else {
+                db_compare_usage();
+                db_failf(DB_COMPARE_BACKEND, "unexpected argument: %s", arg);
+            }
+            continue;
+        }
+        if ((i + 1) >= argc) {
+            db_failf(DB_COMPARE_BACKEND, "missing value for option: %s", arg);
+        }
+        const char *value = argv[++i];
+        if (strcmp(arg, "--alpha") == 0) {
+            out_options->alpha = db_compare_parse_number_or_exit(arg, value);
+        } else if (strcmp(arg, "--max-mean-regress") == 0) {
+            out_options->max_regress_pct[0] =
+                db_compare_parse_number_or_exit(arg, value);
+        } else if (strcmp(arg, "--max-p99-regress") == 0) {
+            out_options->max_regress_pct[1] =
+                db_compare_parse_number_or_exit(arg, value);
+        } else if (strcmp(arg, "--max-mpix-regress") == 0) {
+            out_options->max_regress_pct[2] =
+                db_compare_parse_number_or_exit(arg, value);
+        } else {
+            db_compare_usage();
+            db_failf(DB_COMPARE_BACKEND, "unknown option: %s", arg);
+        }
+    }
+    if (out_options->candidate_path == NULL) {
+        db_compare_usage();
+        db_failf(DB_COMPARE_BACKEND, "baseline and candidate are required");
+    }
+}
+
+// A metric regresses when the candidate median is worse than the baseline
+// median by more than the threshold and, given enough runs on both sides,
+// the Mann-Whitney test says the shift is significant.
+static int db_compare_metric(const db_compare_options_t *options,
+                             const db_compare_cell_t *cell, size_t metric) {
+    const db_compare_metric_t *info = &g_compare_metrics[metric];
+    const db_compare_samples_t *base = &cell->samples[0][metric];
+    const db_compare_samples_t *cand = &cell->samples[1][metric];
+    if ((base->count == 0U) || (cand->count == 0U)) {
+        return 0;
+    }
+    const double base_median = db_stats_median(base->values, base->count);
+    const double cand_median = db_stats_median(cand->values, cand->count);
+    const double worse_by_pct =
+        (base_median != 0.0)
+            ? (100.0 *
+               ((info->higher_is_better != 0) ? (base_median - cand_median)
+                                              : (cand_median - base_median)) /
+               base_median)
+            : 0.0;
+    const double p_value =
+        (info->higher_is_better != 0)
+            ? db_stats_mann_whitney_p_greater(cand->values, cand->count,
+                                              base->values, base->count)
+            : db_stats_mann_whitney_p_greater(base->values, base->count,
+                                              cand->values, cand->count);
+    const int enough_samples = (base->count >= DB_COMPARE_MIN_SAMPLES) &&
+                               (cand->count >= DB_COMPARE_MIN_SAMPLES);
+    const int regressed =
+        (worse_by_pct > options->max_regress_pct[metric]) &&
+        ((enough_samples == 0) || (p_value < options->alpha));
+    printf("compare: %s %s base=%.4f cand=%.4f worse_by=%+.2f%% "
+           "limit=%.2f%% p=%s%.4f runs=%u/%u %s\n",
+           cell->key, info->field, base_median, cand_median, worse_by_pct,
+           options->max_regress_pct[metric],
+           (enough_samples != 0) ? "" : "n/a:", p_value, base->count,
+           cand->count, (regressed != 0) ? "REGRESSION" : "ok");
+    return regressed;
+}
+
+int db_compare_main(int argc, char **argv) {
+    db_compare_options_t options;
+    db_compare_parse_or_exit(argc, argv, &options);
+
+    db_compare_table_t table = {0};
+    db_compare_load(&table, options.baseline_path, 0U);
+    db_compare_load(&table, options.candidate_path, 1U);
+
+    uint32_t compared = 0U;
+    uint32_t regressions = 0U;
+    for (size_t i = 0U; i < table.count; i++) {
+        const db_compare_cell_t *cell = &table.cells[i];
+        if ((cell->samples[0][0].count == 0U) ||
+            (cell->samples[1][0].count == 0U)) {
+            db_infof(DB_COMPARE_BACKEND, "only in %s: %s",
+                     (cell->samples[0][0].count == 0U) ? "candidate"
+                                                       : "baseline",
+                     cell->key);
+            continue;
+        }
+        compared++;
+        for (size_t m = 0U; m < DB_COMPARE_METRIC_COUNT; m++) {
+            regressions += (uint32_t)db_compare_metric(&options, cell, m);
+        }
+    }
+    free(table.cells);
+
+    printf("compare summary: cells=%u regressions=%u\n", compared,
+           regressions);
+    if (compared == 0U) {
+        db_infof(DB_COMPARE_BACKEND,
+                 "no comparable final records in %s and %s",
+                 options.baseline_path, options.candidate_path);
+        return EXIT_FAILURE;
+    }
+    return (regressions > 0U) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,17 @@
+#ifndef DRIVERBENCH_COMPARE_H
+#define DRIVERBENCH_COMPARE_H
+
+#define DB_COMPARE_DEFAULT_ALPHA 0.05
+#define DB_COMPARE_DEFAULT_MAX_MEAN_PCT 5.0
+#define DB_COMPARE_DEFAULT_MAX_MPIX_PCT 5.0
+#define DB_COMPARE_DEFAULT_MAX_P99_PCT 10.0
+// Below this many runs per side the significance test cannot reach
+// alpha = 0.05, so only the threshold is applied.
+#define DB_COMPARE_MIN_SAMPLES 3U
+
+// `driverbench compare <baseline> <candidate> [options]`: compares the
+// final records of two --results-file outputs (jsonl or csv) cell by cell
+// and returns EXIT_FAILURE when any metric regressed.
+int db_compare_main(int argc, char **argv);
+
+#endif
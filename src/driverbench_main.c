@@ -1,18 +1,41 @@
+#include <string.h>
+
+#include "core/db_results.h"
+#include "core/db_trace.h"
 #include "displays/display_dispatch.h"
 #include "driverbench_cli.h"
+#include "driverbench_compare.h"
+#include "driverbench_verify.h"
 
 int main(int argc, char **argv) {
+    if ((argc > 1) && (strcmp(argv[1], "compare") == 0)) {
+        return db_compare_main(argc - 1, argv + 1);
+    }
+    if ((argc > 1) && (strcmp(argv[1], "verify") == 0)) {
+        return db_verify_main(argv[0], argc - 1, argv + 1);
+    }
+
     db_cli_config_t cfg = {0};
     db_cli_parse_or_exit(argc, argv, &cfg);
-
-    if (cfg.api_is_auto != 0) {
-        return db_run_display_auto(cfg.display, cfg.renderer, cfg.kms_card,
-                                   &cfg);
+    if (cfg.results_path != NULL) {
+        db_results_open_or_fail(cfg.results_path, cfg.results_format);
+    }
+    if (cfg.trace_path != NULL) {
+        db_trace_open_or_fail(cfg.trace_path);
     }
 
-    if (cfg.api != DB_API_OPENGL) {
-        cfg.renderer = DB_GL_RENDERER_GL3_3;
+    int status = 0;
+    if (cfg.api_is_auto != 0) {
+        status = db_run_display_auto(cfg.display, cfg.renderer, cfg.kms_card,
+                                     &cfg);
+    } else {
+        if (cfg.api != DB_API_OPENGL) {
+            cfg.renderer = DB_GL_RENDERER_GL3_3;
+        }
+        status = db_run_display(cfg.display, cfg.api, cfg.renderer,
+                                cfg.kms_card, &cfg);
     }
-    return db_run_display(cfg.display, cfg.api, cfg.renderer, cfg.kms_card,
-                          &cfg);
+    db_trace_close();
+    db_results_close();
+    return status;
 }
@@ -0,0 +1,373 @@
+#include "driverbench_verify.h"
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "core/db_core.h"
+#include "driverbench_cli.h"
+#include "renderers/renderer_benchmark_common.h"
+
+#define DB_VERIFY_BACKEND "driverbench_verify"
+#define DB_VERIFY_KEYS_MAX 4U
+#define DB_VERIFY_KEY_BYTES 64U
+#define DB_VERIFY_LINE_BYTES 4096U
+#define DB_VERIFY_NUMBER_BYTES 16U
+// Options appended after the forwarded ones (later flags win), plus NULL.
+#define DB_VERIFY_EXTRA_ARGS 15U
+
+typedef struct {
+    pid_t pid;
+    FILE *output;
+    uint32_t start_frame;
+    uint32_t frame_count;
+    uint64_t start_ns;
+    double elapsed_ms;
+    int status;
+} db_verify_segment_t;
+
+typedef struct {
+    char key[DB_VERIFY_KEY_BYTES];
+    uint64_t combined_hash;
+    uint64_t final_hash;
+    uint32_t segment_count;
+} db_verify_hash_t;
+
+typedef struct {
+    uint32_t segments;
+    uint32_t jobs;
+    // [self, forwarded run options..., appended options..., NULL]
+    char **run_argv;
+    int forwarded_argc;
+} db_verify_options_t;
+
+static void db_verify_usage(void) {
+    fputs("Usage: driverbench verify --segments <value> [--jobs <value>] "
+          "<run options>\n"
+          "\nRun options are those of a normal offscreen CPU run and must "
+          "include\n--frame-limit and --hash.\n",
+          stderr);
+}
+
+static uint32_t db_verify_parse_count_or_exit(const char *option,
+                                              const char *raw_value,
+                                              uint32_t max_value) {
+    char *end = NULL;
+    const unsigned long parsed = strtoul(raw_value, &end, 10);
+    if ((end == raw_value) || (end == NULL) || (*end != '\0') ||
+        (parsed == 0UL) || (parsed > max_value)) {
+        db_failf(DB_VERIFY_BACKEND, "invalid value for %s: %s (expected 1..%u)",
+                 option, raw_value, max_value);
+    }
+    return (uint32_t)parsed;
+}
+
+static void db_verify_parse_or_exit(const char *self_path, int argc,
+                                    char **argv,
+                                    db_verify_options_t *out_options) {
+    *out_options = (db_verify_options_t){0};
+    out_options->run_argv = (char **)db_alloc_array_or_fail(
+        DB_VERIFY_BACKEND, "run_argv",
+        (size_t)argc + DB_VERIFY_EXTRA_ARGS, sizeof(char *));
+    out_options->run_argv[0] = (char *)self_path;
+    int forwarded = 1;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--help") == 0) {
+            db_verify_usage();
+            exit(EXIT_SUCCESS);
+        }
+        if ((strcmp(arg, "--segments") != 0) && (strcmp(arg, "--jobs") != 0)) {
+            out_options->run_argv[forwarded++] = argv[i];
+            continue;
+        }
+        if ((i + 1) >= argc) {
+            db_failf(DB_VERIFY_BACKEND, "missing value for option: %s", arg);
+        }
+        const char *value = argv[++i];
+        if (strcmp(arg, "--segments") == 0) {
+            out_options->segments = db_verify_parse_count_or_exit(
+                arg, value, DB_VERIFY_SEGMENTS_MAX);
+        } else {
+            out_options->jobs =
+                db_verify_parse_count_or_exit(arg, value, UINT32_MAX);
+        }
+    }
+    out_options->forwarded_argc = forwarded;
+    if (out_options->segments == 0U) {
+        db_verify_usage();
+        db_failf(DB_VERIFY_BACKEND, "--segments is required");
+    }
+    if (out_options->jobs == 0U) {
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        out_options->jobs = (online > 0L) ? (uint32_t)online : 1U;
+    }
+}
+
+static void db_verify_validate_or_exit(const db_cli_config_t *cfg) {
+    if ((cfg->api_is_auto != 0) || (cfg->api != DB_API_CPU) ||
+        (cfg->display != DB_DISPLAY_OFFSCREEN)) {
+        db_failf(DB_VERIFY_BACKEND,
+                 "verify requires --api cpu --display offscreen");
+    }
+    if (cfg->frame_limit == 0U) {
+        db_failf(DB_VERIFY_BACKEND, "verify requires --frame-limit > 0");
+    }
+    if ((cfg->hash_mode == NULL) || (strcmp(cfg->hash_mode, "none") == 0)) {
+        db_failf(DB_VERIFY_BACKEND,
+                 "verify requires --hash <state|pixel|both>");
+    }
+    // Every segment would write the same file.
+    if ((cfg->results_path != NULL) || (cfg->trace_path != NULL) ||
+        (cfg->hash_trace_path != NULL) || (cfg->hash_verify_path != NULL) ||
+        (cfg->checkpoint_path != NULL)) {
+        db_failf(DB_VERIFY_BACKEND,
+                 "verify cannot be combined with --results-file, "
+                 "--trace-file, --hash-trace/--hash-verify or "
+                 "--checkpoint-file");
+    }
+    if ((cfg->repeat_count > 1U) || (cfg->sweep_enabled != 0) ||
+        (cfg->resolution_sweep != 0)) {
+        db_failf(DB_VERIFY_BACKEND,
+                 "verify cannot be combined with --repeat, --sweep or "
+                 "--resolution-sweep");
+    }
+}
+
+static void db_verify_spawn_or_exit(const char *self_path, char **run_argv,
+                                    db_verify_segment_t *segment) {
+    segment->output = tmpfile();
+    if (segment->output == NULL) {
+        db_failf(DB_VERIFY_BACKEND, "failed to create segment output file");
+    }
+    // Later children must not inherit the files of segments still running;
+    // dup2 below clears the flag on this child's own stdout/stderr.
+    const int output_fd = fileno(segment->output);
+    if ((output_fd < 0) || (fcntl(output_fd, F_SETFD, FD_CLOEXEC) != 0)) {
+        db_failf(DB_VERIFY_BACKEND,
+                 "failed to mark segment output close-on-exec");
+    }
+    // Nothing buffered may be duplicated into the child.
+    (void)fflush(stdout);
+    (void)fflush(stderr);
+    segment->start_ns = db_now_ns_monotonic();
+    const pid_t pid = fork();
+    if (pid < 0) {
+        db_failf(DB_VERIFY_BACKEND, "fork failed for segment at frame %u",
+                 segment->start_frame);
+    }
+    if (pid == 0) {
+        if ((dup2(output_fd, STDOUT_FILENO) >= 0) &&
+            (dup2(output_fd, STDERR_FILENO) >= 0)) {
+            (void)execvp(self_path, run_argv);
+        }
+        _exit(127);
+    }
+    segment->pid = pid;
+}
+
+static db_verify_hash_t *db_verify_hash_slot(db_verify_hash_t *hashes,
+                                             uint32_t *hash_count,
+                                             const char *key, size_t key_len) {
+    for (uint32_t i = 0U; i < *hash_count; i++) {
+        if ((strlen(hashes[i].key) == key_len) &&
+            (strncmp(hashes[i].key, key, key_len) == 0)) {
+            return &hashes[i];
+        }
+    }
+    if ((*hash_count >= DB_VERIFY_KEYS_MAX) ||
+        (key_len >= DB_VERIFY_KEY_BYTES)) {
+        return NULL;
+    }
+    db_verify_hash_t *slot = &hashes[(*hash_count)++];
+    *slot = (db_verify_hash_t){0};
+    memcpy(slot->key, key, key_len);
+    return slot;
+}
+
+// Folds the `<key>_final=0x...` and `<key>_combined=0x...` tokens of one
+// segment's log. Only the last segment's final hash is the run's.
+static void db_verify_collect(const db_verify_segment_t *segment,
+                              int is_last, db_verify_hash_t *hashes,
+                              uint32_t *hash_count) {
+    char line[DB_VERIFY_LINE_BYTES];
+    rewind(segment->output);
+    while (fgets(line, sizeof(line), segment->output) != NULL) {
+        char *save = NULL;
+        for (char *token = strtok_r(line, " \n", &save); token != NULL;
+             token = strtok_r(NULL, " \n", &save)) {
+            const char *eq = strstr(token, "=0x");
+            if (eq == NULL) {
+                continue;
+            }
+            const size_t name_len = (size_t)(eq - token);
+            const size_t combined_len = strlen("_combined");
+            const size_t final_len = strlen("_final");
+            const uint64_t value = strtoull(eq + 3, NULL, 16);
+            if ((name_len > combined_len) &&
+                (strncmp(eq - combined_len, "_combined", combined_len) ==
+                 0)) {
+                db_verify_hash_t *slot = db_verify_hash_slot(
+                    hashes, hash_count, token, name_len - combined_len);
+                if (slot != NULL) {
+                    slot->combined_hash += value;
+                    slot->segment_count++;
+                }
+            } else if ((is_last != 0) && (name_len > final_len) &&
+                       (strncmp(eq - final_len, "_final", final_len) == 0)) {
+                db_verify_hash_t *slot = db_verify_hash_slot(
+                    hashes, hash_count, token, name_len - final_len);
+                if (slot != NULL) {
+                    slot->final_hash = value;
+                }
+            }
+        }
+    }
+}
+
+static void db_verify_dump_output(const db_verify_segment_t *segment) {
+    char line[DB_VERIFY_LINE_BYTES];
+    rewind(segment->output);
+    while (fgets(line, sizeof(line), segment->output) != NULL) {
+        fputs(line, stderr);
+    }
+}
+
+int db_verify_main(const char *self_path, int argc, char **argv) {
+    db_verify_options_t options;
+    db_verify_parse_or_exit(self_path, argc, argv, &options);
+
+    db_cli_config_t cfg = {0};
+    db_cli_parse_or_exit(options.forwarded_argc, options.run_argv, &cfg);
+    db_verify_validate_or_exit(&cfg);
+
+    // Segments only line up when every one renders the same run, so pin
+    // the seed; the parallelism comes from processes, not render threads.
+    char seed_text[DB_VERIFY_NUMBER_BYTES];
+    char start_text[DB_VERIFY_NUMBER_BYTES];
+    char count_text[DB_VERIFY_NUMBER_BYTES];
+    char **extra = &options.run_argv[options.forwarded_argc];
+    int extra_count = 0;
+    extra[extra_count++] = "--fps-cap";
+    extra[extra_count++] = "0";
+    extra[extra_count++] = "--hash-report";
+    extra[extra_count++] = "combined";
+    if (db_runtime_option_get(DB_RUNTIME_OPT_RANDOM_SEED) == NULL) {
+        (void)db_snprintf(seed_text, sizeof(seed_text), "%u",
+                          db_pattern_seed_from_time());
+        extra[extra_count++] = "--random-seed";
+        extra[extra_count++] = seed_text;
+        db_infof(DB_VERIFY_BACKEND, "using --random-seed %s", seed_text);
+    }
+    if (db_runtime_option_get(DB_RUNTIME_OPT_CPU_THREADS) == NULL) {
+        extra[extra_count++] = "--cpu-threads";
+        extra[extra_count++] = "1";
+    }
+    extra[extra_count++] = "--start-frame";
+    extra[extra_count++] = start_text;
+    extra[extra_count++] = "--frame-limit";
+    extra[extra_count++] = count_text;
+    extra[extra_count] = NULL;
+
+    const uint32_t first_frame = cfg.start_frame;
+    const uint32_t total_frames = cfg.frame_limit;
+    const uint32_t per_segment =
+        (total_frames + options.segments - 1U) / options.segments;
+    const uint32_t segment_count =
+        (total_frames + per_segment - 1U) / per_segment;
+    db_verify_segment_t *segments =
+        (db_verify_segment_t *)db_alloc_array_or_fail(
+            DB_VERIFY_BACKEND, "segments", segment_count, sizeof(*segments));
+    for (uint32_t i = 0U; i < segment_count; i++) {
+        const uint32_t offset = i * per_segment;
+        segments[i] = (db_verify_segment_t){
+            .start_frame = first_frame + offset,
+            .frame_count = db_u32_min(per_segment, total_frames - offset),
+        };
+    }
+
+    const uint64_t start_ns = db_now_ns_monotonic();
+    uint32_t next = 0U;
+    uint32_t running = 0U;
+    uint32_t finished = 0U;
+    while (finished < segment_count) {
+        while ((running < options.jobs) && (next < segment_count)) {
+            (void)db_snprintf(start_text, sizeof(start_text), "%u",
+                              segments[next].start_frame);
+            (void)db_snprintf(count_text, sizeof(count_text), "%u",
+                              segments[next].frame_count);
+            db_verify_spawn_or_exit(self_path, options.run_argv,
+                                    &segments[next]);
+            next++;
+            running++;
+        }
+        int status = 0;
+        const pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            db_failf(DB_VERIFY_BACKEND, "waitpid failed");
+        }
+        for (uint32_t i = 0U; i < next; i++) {
+            if (segments[i].pid == pid) {
+                segments[i].status = status;
+                segments[i].elapsed_ms =
+                    (double)(db_now_ns_monotonic() - segments[i].start_ns) /
+                    DB_NS_PER_MS_D;
+                running--;
+                finished++;
+                break;
+            }
+        }
+    }
+    const double wall_ms =
+        (double)(db_now_ns_monotonic() - start_ns) / DB_NS_PER_MS_D;
+
+    db_verify_hash_t hashes[DB_VERIFY_KEYS_MAX];
+    uint32_t hash_count = 0U;
+    double segment_ms = 0.0;
+    for (uint32_t i = 0U; i < segment_count; i++) {
+        const db_verify_segment_t *segment = &segments[i];
+        if (!WIFEXITED(segment->status) ||
+            (WEXITSTATUS(segment->status) != EXIT_SUCCESS)) {
+            db_verify_dump_output(segment);
+            db_failf(DB_VERIFY_BACKEND, "segment %u (frames %u..%u) failed",
+                     i, segment->start_frame,
+                     segment->start_frame + segment->frame_count - 1U);
+        }
+        db_verify_collect(segment, (i + 1U) == segment_count, hashes,
+                          &hash_count);
+        (void)fclose(segment->output);
+        segment_ms += segment->elapsed_ms;
+        db_infof(DB_VERIFY_BACKEND, "segment %u: frames %u..%u in %.1f ms", i,
+                 segment->start_frame,
+                 segment->start_frame + segment->frame_count - 1U,
+                 segment->elapsed_ms);
+    }
+    free(segments);
+    free(options.run_argv);
+
+    if (hash_count == 0U) {
+        db_failf(DB_VERIFY_BACKEND, "segments reported no combined hashes");
+    }
+    for (uint32_t i = 0U; i < hash_count; i++) {
+        const db_verify_hash_t *hash = &hashes[i];
+        if (hash->segment_count != segment_count) {
+            db_failf(DB_VERIFY_BACKEND,
+                     "%s_combined reported by %u of %u segments", hash->key,
+                     hash->segment_count, segment_count);
+        }
+        db_infof(DB_VERIFY_BACKEND, "%s_final=0x%016llx %s_combined=0x%016llx",
+                 hash->key, (unsigned long long)hash->final_hash, hash->key,
+                 (unsigned long long)hash->combined_hash);
+    }
+    db_infof(DB_VERIFY_BACKEND,
+             "verified %u frames in %u segments (%u jobs): %.1f ms wall, "
+             "%.1f ms of segment time (%.2fx)",
+             total_frames, segment_count, options.jobs, wall_ms, segment_ms,
+             (wall_ms > 0.0) ? (segment_ms / wall_ms) : 0.0);
+    return EXIT_SUCCESS;
+}
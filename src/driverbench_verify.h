@@ -0,0 +1,13 @@
+#ifndef DRIVERBENCH_VERIFY_H
+#define DRIVERBENCH_VERIFY_H
+
+#define DB_VERIFY_SEGMENTS_MAX 4096U
+
+// `driverbench verify --segments K [--jobs J] <run options>`: splits the
+// --frame-limit range into K segments, runs each as its own driverbench
+// process entered with --start-frame (at most J at a time, default one per
+// online CPU) and adds up their --hash-report combined sums. The folded
+// `<key>_combined` equals the one a serial run of the same options reports.
+int db_verify_main(const char *self_path, int argc, char **argv);
+
+#endif
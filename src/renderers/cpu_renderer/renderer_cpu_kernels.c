@@ -0,0 +1,704 @@
+#include "renderer_cpu_kernels.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../core/db_core.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) &&                             \
+    (defined(__GNUC__) || defined(__clang__))
+#define DB_CPU_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+static void db_cpu_fill_u32_scalar(uint32_t *dst, uint32_t value,
+                                   size_t count) {
+    for (size_t i = 0U; i < count; i++) {
+        dst[i] = value;
+    }
+}
+
+static void db_cpu_blend_rgba8_scalar(uint32_t *out, const uint32_t *prior,
+                                      const float *weights, size_t count,
+                                      const float target_rgb[3]) {
+    for (size_t i = 0U; i < count; i++) {
+        float prior_red = 0.0F;
+        float prior_green = 0.0F;
+        float prior_blue = 0.0F;
+        db_cpu_unpack_rgb(prior[i], &prior_red, &prior_green, &prior_blue);
+        float out_red = 0.0F;
+        float out_green = 0.0F;
+        float out_blue = 0.0F;
+        db_blend_rgb(prior_red, prior_green, prior_blue, target_rgb[0],
+                     target_rgb[1], target_rgb[2], weights[i], &out_red,
+                     &out_green, &out_blue);
+        out[i] = db_cpu_pack_rgb(out_red, out_green, out_blue);
+    }
+}
+
+// Fixed-point lerp: prior and target are 8.8, weights are 0.14, so every
+// channel is accumulated as prior * (1 - w) + target * w in 8.22 and fits
+// a signed 32-bit lane. Worst-case drift from the exact real-valued blend is
+// under 0.01 of a u8 step, and the float path drifts far less, so results
+// further than DB_CPU_BLEND_FIXED_GUARD from a .5 rounding boundary agree
+// with the float path by construction. Anything closer is recomputed in
+// float.
+#define DB_CPU_BLEND_FIXED_FRAC_MASK                                         \
+    ((int32_t)((1U << DB_CPU_BLEND_FIXED_FRAC_BITS) - 1U))
+#define DB_CPU_BLEND_FIXED_HALF                                              \
+    ((int32_t)(1U << (DB_CPU_BLEND_FIXED_FRAC_BITS - 1U)))
+
+static int db_cpu_blend_target_q8(const float target_rgb[3],
+                                  int32_t out_target_q8[3]) {
+    for (size_t c = 0U; c < 3U; c++) {
+        // Targets outside [0, 1] clamp after the lerp in the float path,
+        // which a pre-clamped fixed-point target cannot reproduce.
+        if (!((target_rgb[c] >= 0.0F) && (target_rgb[c] <= 1.0F))) {
+            return 0;
+        }
+        out_target_q8[c] = (int32_t)(((double)target_rgb[c] *
+                                      DB_CPU_BLEND_TARGET_SCALE_Q8) +
+                                     0.5);
+    }
+    return 1;
+}
+
+static inline int db_cpu_blend_fixed_is_ambiguous(int32_t rounded) {
+    const int32_t frac = rounded & DB_CPU_BLEND_FIXED_FRAC_MASK;
+    return (frac < DB_CPU_BLEND_FIXED_GUARD) ||
+           (frac > (DB_CPU_BLEND_FIXED_FRAC_MASK - DB_CPU_BLEND_FIXED_GUARD));
+}
+
+static size_t db_cpu_blend_rgba8_fixed_scalar(uint32_t *out,
+                                              const uint32_t *prior,
+                                              const uint32_t *weights_q14,
+                                              const float *weights,
+                                              size_t count,
+                                              const float target_rgb[3]) {
+    static const uint32_t shifts[3] = {
+        DB_CPU_COLOR_SHIFT_R, DB_CPU_COLOR_SHIFT_G, DB_CPU_COLOR_SHIFT_B};
+    int32_t target_q8[3] = {0, 0, 0};
+    if (db_cpu_blend_target_q8(target_rgb, target_q8) == 0) {
+        db_cpu_blend_rgba8_scalar(out, prior, weights, count, target_rgb);
+        return count;
+    }
+
+    size_t fallback_count = 0U;
+    for (size_t i = 0U; i < count; i++) {
+        const int32_t weight_keep = (int32_t)(weights_q14[i] & 0xFFFFU);
+        const int32_t weight_take = (int32_t)(weights_q14[i] >> 16U);
+        uint32_t packed = DB_CPU_ALPHA_U8 << DB_CPU_COLOR_SHIFT_A;
+        int ambiguous = 0;
+        for (size_t c = 0U; c < 3U; c++) {
+            const int32_t channel_q8 =
+                (int32_t)(((prior[i] >> shifts[c]) & 255U) << 8U);
+            const int32_t rounded = (channel_q8 * weight_keep) +
+                                    (target_q8[c] * weight_take) +
+                                    DB_CPU_BLEND_FIXED_HALF;
+            ambiguous |= db_cpu_blend_fixed_is_ambiguous(rounded);
+            packed |= ((uint32_t)rounded >> DB_CPU_BLEND_FIXED_FRAC_BITS)
+                      << shifts[c];
+        }
+        if (ambiguous != 0) {
+            db_cpu_blend_rgba8_scalar(&out[i], &prior[i], &weights[i], 1U,
+                                      target_rgb);
+            fallback_count++;
+            continue;
+        }
+        out[i] = packed;
+    }
+    return fallback_count;
+}
+
+#ifdef DB_CPU_KERNELS_X86
+// The SIMD blends mirror the scalar op order exactly (divide, subtract,
+// multiply, add, clamp, scale, truncate) and never fuse multiply-adds, so
+// every variant rounds bit-identically to db_blend_rgb.
+
+__attribute__((target("sse2"))) static void
+db_cpu_fill_u32_sse2(uint32_t *dst, uint32_t value, size_t count) {
+    const __m128i fill = _mm_set1_epi32((int)value);
+    size_t i = 0U;
+    for (; (i + 16U) <= count; i += 16U) {
+        _mm_storeu_si128((__m128i *)&dst[i], fill);
+        _mm_storeu_si128((__m128i *)&dst[i + 4U], fill);
+        _mm_storeu_si128((__m128i *)&dst[i + 8U], fill);
+        _mm_storeu_si128((__m128i *)&dst[i + 12U], fill);
+    }
+    for (; (i + 4U) <= count; i += 4U) {
+        _mm_storeu_si128((__m128i *)&dst[i], fill);
+    }
+    for (; i < count; i++) {
+        dst[i] = value;
+    }
+}
+
+__attribute__((target("sse2"))) static __m128i
+db_cpu_blend_channel_sse2(__m128i pixels, uint32_t shift, __m128 target,
+                          __m128 weight, __m128 keep_prior,
+                          __m128 take_target) {
+    const __m128i mask_u8 = _mm_set1_epi32(255);
+    const __m128 u8_max = _mm_set1_ps(DB_CPU_U8_MAX_F);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0F);
+    const __m128i channel = _mm_and_si128(
+        _mm_srl_epi32(pixels, _mm_cvtsi32_si128((int)shift)), mask_u8);
+    const __m128 prior = _mm_div_ps(_mm_cvtepi32_ps(channel), u8_max);
+    const __m128 mixed =
+        _mm_add_ps(prior, _mm_mul_ps(_mm_sub_ps(target, prior), weight));
+    __m128 value = _mm_or_ps(_mm_and_ps(keep_prior, prior),
+                             _mm_andnot_ps(keep_prior, mixed));
+    value = _mm_or_ps(_mm_and_ps(take_target, target),
+                      _mm_andnot_ps(take_target, value));
+    value = _mm_min_ps(_mm_max_ps(value, zero), one);
+    const __m128 scaled = _mm_add_ps(_mm_mul_ps(value, u8_max),
+                                     _mm_set1_ps(DB_CPU_ROUND_HALF_UP_F));
+    return _mm_sll_epi32(_mm_cvttps_epi32(scaled),
+                         _mm_cvtsi32_si128((int)shift));
+}
+
+__attribute__((target("sse2"))) static void
+db_cpu_blend_rgba8_sse2(uint32_t *out, const uint32_t *prior,
+                        const float *weights, size_t count,
+                        const float target_rgb[3]) {
+    const __m128 target_r = _mm_set1_ps(target_rgb[0]);
+    const __m128 target_g = _mm_set1_ps(target_rgb[1]);
+    const __m128 target_b = _mm_set1_ps(target_rgb[2]);
+    const __m128i alpha =
+        _mm_set1_epi32((int)(DB_CPU_ALPHA_U8 << DB_CPU_COLOR_SHIFT_A));
+    size_t i = 0U;
+    for (; (i + 4U) <= count; i += 4U) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)&prior[i]);
+        const __m128 weight = _mm_loadu_ps(&weights[i]);
+        const __m128 keep_prior = _mm_cmple_ps(weight, _mm_setzero_ps());
+        const __m128 take_target = _mm_cmpge_ps(weight, _mm_set1_ps(1.0F));
+        __m128i packed = alpha;
+        packed = _mm_or_si128(
+            packed,
+            db_cpu_blend_channel_sse2(pixels, DB_CPU_COLOR_SHIFT_R, target_r,
+                                      weight, keep_prior, take_target));
+        packed = _mm_or_si128(
+            packed,
+            db_cpu_blend_channel_sse2(pixels, DB_CPU_COLOR_SHIFT_G, target_g,
+                                      weight, keep_prior, take_target));
+        packed = _mm_or_si128(
+            packed,
+            db_cpu_blend_channel_sse2(pixels, DB_CPU_COLOR_SHIFT_B, target_b,
+                                      weight, keep_prior, take_target));
+        _mm_storeu_si128((__m128i *)&out[i], packed);
+    }
+    db_cpu_blend_rgba8_scalar(&out[i], &prior[i], &weights[i], count - i,
+                              target_rgb);
+}
+
+// SSE2 has no 32-bit mullo, so the 8.22 accumulation is split into two
+// pmaddwd steps over 16-bit halves: with weight lanes (keep | take << 16),
+// (prior | target_hi << 16) yields prior * keep + target_hi * take and
+// (target_lo << 16) yields target_lo * take.
+__attribute__((target("sse2"))) static __m128i
+db_cpu_blend_fixed_channel_sse2(__m128i pixels, uint32_t shift,
+                                __m128i weight_pairs, __m128i target_hi,
+                                __m128i target_lo, __m128i *ambiguous) {
+    const __m128i channel = _mm_and_si128(
+        _mm_srl_epi32(pixels, _mm_cvtsi32_si128((int)shift)),
+        _mm_set1_epi32(255));
+    const __m128i high =
+        _mm_madd_epi16(_mm_or_si128(channel, target_hi), weight_pairs);
+    const __m128i low = _mm_madd_epi16(target_lo, weight_pairs);
+    const __m128i rounded =
+        _mm_add_epi32(_mm_add_epi32(_mm_slli_epi32(high, 8), low),
+                      _mm_set1_epi32(DB_CPU_BLEND_FIXED_HALF));
+    const __m128i frac =
+        _mm_and_si128(rounded, _mm_set1_epi32(DB_CPU_BLEND_FIXED_FRAC_MASK));
+    *ambiguous = _mm_or_si128(
+        *ambiguous,
+        _mm_or_si128(
+            _mm_cmplt_epi32(frac, _mm_set1_epi32(DB_CPU_BLEND_FIXED_GUARD)),
+            _mm_cmpgt_epi32(frac,
+                            _mm_set1_epi32(DB_CPU_BLEND_FIXED_FRAC_MASK -
+                                           DB_CPU_BLEND_FIXED_GUARD))));
+    return _mm_sll_epi32(_mm_srli_epi32(rounded, DB_CPU_BLEND_FIXED_FRAC_BITS),
+                         _mm_cvtsi32_si128((int)shift));
+}
+
+__attribute__((target("sse2"))) static size_t
+db_cpu_blend_rgba8_fixed_sse2(uint32_t *out, const uint32_t *prior,
+                              const uint32_t *weights_q14, const float *weights,
+                              size_t count, const float target_rgb[3]) {
+    int32_t target_q8[3] = {0, 0, 0};
+    if (db_cpu_blend_target_q8(target_rgb, target_q8) == 0) {
+        db_cpu_blend_rgba8_sse2(out, prior, weights, count, target_rgb);
+        return count;
+    }
+    __m128i target_hi[3];
+    __m128i target_lo[3];
+    for (size_t c = 0U; c < 3U; c++) {
+        target_hi[c] = _mm_set1_epi32((target_q8[c] >> 8) << 16);
+        target_lo[c] = _mm_set1_epi32((target_q8[c] & 255) << 16);
+    }
+    const __m128i alpha =
+        _mm_set1_epi32((int)(DB_CPU_ALPHA_U8 << DB_CPU_COLOR_SHIFT_A));
+    size_t fallback_count = 0U;
+    size_t i = 0U;
+    for (; (i + 4U) <= count; i += 4U) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)&prior[i]);
+        const __m128i weight_pairs =
+            _mm_loadu_si128((const __m128i *)&weights_q14[i]);
+        __m128i ambiguous = _mm_setzero_si128();
+        __m128i packed = alpha;
+        packed = _mm_or_si128(
+            packed, db_cpu_blend_fixed_channel_sse2(
+                        pixels, DB_CPU_COLOR_SHIFT_R, weight_pairs,
+                        target_hi[0], target_lo[0], &ambiguous));
+        packed = _mm_or_si128(
+            packed, db_cpu_blend_fixed_channel_sse2(
+                        pixels, DB_CPU_COLOR_SHIFT_G, weight_pairs,
+                        target_hi[1], target_lo[1], &ambiguous));
+        packed = _mm_or_si128(
+            packed, db_cpu_blend_fixed_channel_sse2(
+                        pixels, DB_CPU_COLOR_SHIFT_B, weight_pairs,
+                        target_hi[2], target_lo[2], &ambiguous));
+        // out may alias prior, so keep the source lanes for the fallback.
+        uint32_t prior_lanes[4];
+        _mm_storeu_si128((__m128i *)prior_lanes, pixels);
+        _mm_storeu_si128((__m128i *)&out[i], packed);
+        uint32_t lanes =
+            (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(ambiguous));
+        while (lanes != 0U) {
+            const size_t lane = (size_t)__builtin_ctz(lanes);
+            db_cpu_blend_rgba8_scalar(&out[i + lane], &prior_lanes[lane],
+                                      &weights[i + lane], 1U, target_rgb);
+            fallback_count++;
+            lanes &= lanes - 1U;
+        }
+    }
+    return fallback_count +
+           db_cpu_blend_rgba8_fixed_scalar(&out[i], &prior[i], &weights_q14[i],
+                                           &weights[i], count - i, target_rgb);
+}
+
+__attribute__((target("avx2"))) static void
+db_cpu_fill_u32_avx2(uint32_t *dst, uint32_t value, size_t count) {
+    const __m256i fill = _mm256_set1_epi32((int)value);
+    size_t i = 0U;
+    for (; (i + 32U) <= count; i += 32U) {
+        _mm256_storeu_si256((__m256i *)&dst[i], fill);
+        _mm256_storeu_si256((__m256i *)&dst[i + 8U], fill);
+        _mm256_storeu_si256((__m256i *)&dst[i + 16U], fill);
+        _mm256_storeu_si256((__m256i *)&dst[i + 24U], fill);
+    }
+    for (; (i + 8U) <= count; i += 8U) {
+        _mm256_storeu_si256((__m256i *)&dst[i], fill);
+    }
+    for (; i < count; i++) {
+        dst[i] = value;
+    }
+}
+
+__attribute__((target("avx2"))) static __m256i
+db_cpu_blend_channel_avx2(__m256i pixels, int shift, __m256 target,
+                          __m256 weight, __m256 keep_prior,
+                          __m256 take_target) {
+    const __m256 u8_max = _mm256_set1_ps(DB_CPU_U8_MAX_F);
+    const __m256i channel = _mm256_and_si256(
+        _mm256_srlv_epi32(pixels, _mm256_set1_epi32(shift)),
+        _mm256_set1_epi32(255));
+    const __m256 prior = _mm256_div_ps(_mm256_cvtepi32_ps(channel), u8_max);
+    const __m256 mixed = _mm256_add_ps(
+        prior, _mm256_mul_ps(_mm256_sub_ps(target, prior), weight));
+    __m256 value = _mm256_blendv_ps(mixed, prior, keep_prior);
+    value = _mm256_blendv_ps(value, target, take_target);
+    value = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()),
+                          _mm256_set1_ps(1.0F));
+    const __m256 scaled = _mm256_add_ps(
+        _mm256_mul_ps(value, u8_max), _mm256_set1_ps(DB_CPU_ROUND_HALF_UP_F));
+    return _mm256_sllv_epi32(_mm256_cvttps_epi32(scaled),
+                             _mm256_set1_epi32(shift));
+}
+
+__attribute__((target("avx2"))) static void
+db_cpu_blend_rgba8_avx2(uint32_t *out, const uint32_t *prior,
+                        const float *weights, size_t count,
+                        const float target_rgb[3]) {
+    const __m256 target_r = _mm256_set1_ps(target_rgb[0]);
+    const __m256 target_g = _mm256_set1_ps(target_rgb[1]);
+    const __m256 target_b = _mm256_set1_ps(target_rgb[2]);
+    const __m256i alpha =
+        _mm256_set1_epi32((int)(DB_CPU_ALPHA_U8 << DB_CPU_COLOR_SHIFT_A));
+    size_t i = 0U;
+    for (; (i + 8U) <= count; i += 8U) {
+        const __m256i pixels =
+            _mm256_loadu_si256((const __m256i *)&prior[i]);
+        const __m256 weight = _mm256_loadu_ps(&weights[i]);
+        const __m256 keep_prior =
+            _mm256_cmp_ps(weight, _mm256_setzero_ps(), _CMP_LE_OQ);
+        const __m256 take_target =
+            _mm256_cmp_ps(weight, _mm256_set1_ps(1.0F), _CMP_GE_OQ);
+        __m256i packed = alpha;
+        packed = _mm256_or_si256(
+            packed, db_cpu_blend_channel_avx2(
+                        pixels, (int)DB_CPU_COLOR_SHIFT_R, target_r, weight,
+                        keep_prior, take_target));
+        packed = _mm256_or_si256(
+            packed, db_cpu_blend_channel_avx2(
+                        pixels, (int)DB_CPU_COLOR_SHIFT_G, target_g, weight,
+                        keep_prior, take_target));
+        packed = _mm256_or_si256(
+            packed, db_cpu_blend_channel_avx2(
+                        pixels, (int)DB_CPU_COLOR_SHIFT_B, target_b, weight,
+                        keep_prior, take_target));
+        _mm256_storeu_si256((__m256i *)&out[i], packed);
+    }
+    db_cpu_blend_rgba8_sse2(&out[i], &prior[i], &weights[i], count - i,
+                            target_rgb);
+}
+
+__attribute__((target("avx2"))) static __m256i
+db_cpu_blend_fixed_channel_avx2(__m256i pixels, int shift,
+                                __m256i weight_pairs, __m256i target_hi,
+                                __m256i target_lo, __m256i *ambiguous) {
+    const __m256i channel =
+        _mm256_and_si256(_mm256_srlv_epi32(pixels, _mm256_set1_epi32(shift)),
+                         _mm256_set1_epi32(255));
+    const __m256i high = _mm256_madd_epi16(
+        _mm256_or_si256(channel, target_hi), weight_pairs);
+    const __m256i low = _mm256_madd_epi16(target_lo, weight_pairs);
+    const __m256i rounded = _mm256_add_epi32(
+        _mm256_add_epi32(_mm256_slli_epi32(high, 8), low),
+        _mm256_set1_epi32(DB_CPU_BLEND_FIXED_HALF));
+    const __m256i frac = _mm256_and_si256(
+        rounded, _mm256_set1_epi32(DB_CPU_BLEND_FIXED_FRAC_MASK));
+    *ambiguous = _mm256_or_si256(
+        *ambiguous,
+        _mm256_or_si256(
+            _mm256_cmpgt_epi32(_mm256_set1_epi32(DB_CPU_BLEND_FIXED_GUARD),
+                               frac),
+            _mm256_cmpgt_epi32(
+                frac, _mm256_set1_epi32(DB_CPU_BLEND_FIXED_FRAC_MASK -
+                                        DB_CPU_BLEND_FIXED_GUARD))));
+    return _mm256_sllv_epi32(
+        _mm256_srli_epi32(rounded, DB_CPU_BLEND_FIXED_FRAC_BITS),
+        _mm256_set1_epi32(shift));
+}
+
+__attribute__((target("avx2"))) static size_t
+db_cpu_blend_rgba8_fixed_avx2(uint32_t *out, const uint32_t *prior,
+                              const uint32_t *weights_q14, const float *weights,
+                              size_t count, const float target_rgb[3]) {
+    int32_t target_q8[3] = {0, 0, 0};
+    if (db_cpu_blend_target_q8(target_rgb, target_q8) == 0) {
+        db_cpu_blend_rgba8_avx2(out, prior, weights, count, target_rgb);
+        return count;
+    }
+    __m256i target_hi[3];
+    __m256i target_lo[3];
+    for (size_t c = 0U; c < 3U; c++) {
+        target_hi[c] = _mm256_set1_epi32((target_q8[c] >> 8) << 16);
+        target_lo[c] = _mm256_set1_epi32((target_q8[c] & 255) << 16);
+    }
+    const __m256i alpha =
+        _mm256_set1_epi32((int)(DB_CPU_ALPHA_U8 << DB_CPU_COLOR_SHIFT_A));
+    size_t fallback_count = 0U;
+    size_t i = 0U;
+    for (; (i + 8U) <= count; i += 8U) {
+        const __m256i pixels =
+            _mm256_loadu_si256((const __m256i *)&prior[i]);
+        const __m256i weight_pairs =
+            _mm256_loadu_si256((const __m256i *)&weights_q14[i]);
+        __m256i ambiguous = _mm256_setzero_si256();
+        __m256i packed = alpha;
+        packed = _mm256_or_si256(
+            packed, db_cpu_blend_fixed_channel_avx2(
+                        pixels, (int)DB_CPU_COLOR_SHIFT_R, weight_pairs,
+                        target_hi[0], target_lo[0], &ambiguous));
+        packed = _mm256_or_si256(
+            packed, db_cpu_blend_fixed_channel_avx2(
+                        pixels, (int)DB_CPU_COLOR_SHIFT_G, weight_pairs,
+                        target_hi[1], target_lo[1], &ambiguous));
+        packed = _mm256_or_si256(
+            packed, db_cpu_blend_fixed_channel_avx2(
+                        pixels, (int)DB_CPU_COLOR_SHIFT_B, weight_pairs,
+                        target_hi[2], target_lo[2], &ambiguous));
+        uint32_t prior_lanes[8];
+        _mm256_storeu_si256((__m256i *)prior_lanes, pixels);
+        _mm256_storeu_si256((__m256i *)&out[i], packed);
+        uint32_t lanes =
+            (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(ambiguous));
+        while (lanes != 0U) {
+            const size_t lane = (size_t)__builtin_ctz(lanes);
+            db_cpu_blend_rgba8_scalar(&out[i + lane], &prior_lanes[lane],
+                                      &weights[i + lane], 1U, target_rgb);
+            fallback_count++;
+            lanes &= lanes - 1U;
+        }
+    }
+    return fallback_count +
+           db_cpu_blend_rgba8_fixed_sse2(&out[i], &prior[i], &weights_q14[i],
+                                         &weights[i], count - i, target_rgb);
+}
+
+__attribute__((target("avx512f"))) static void
+db_cpu_fill_u32_avx512(uint32_t *dst, uint32_t value, size_t count) {
+    const __m512i fill = _mm512_set1_epi32((int)value);
+    size_t i = 0U;
+    for (; (i + 64U) <= count; i += 64U) {
+        _mm512_storeu_si512((void *)&dst[i], fill);
+        _mm512_storeu_si512((void *)&dst[i + 16U], fill);
+        _mm512_storeu_si512((void *)&dst[i + 32U], fill);
+        _mm512_storeu_si512((void *)&dst[i + 48U], fill);
+    }
+    for (; (i + 16U) <= count; i += 16U) {
+        _mm512_storeu_si512((void *)&dst[i], fill);
+    }
+    if (i < count) {
+        const __mmask16 tail = (__mmask16)((1U << (count - i)) - 1U);
+        _mm512_mask_storeu_epi32((void *)&dst[i], tail, fill);
+    }
+}
+
+__attribute__((target("avx512f"))) static __m512i
+db_cpu_blend_channel_avx512(__m512i pixels, unsigned int shift, __m512 target,
+                            __m512 weight, __mmask16 keep_prior,
+                            __mmask16 take_target) {
+    const __m512 u8_max = _mm512_set1_ps(DB_CPU_U8_MAX_F);
+    const __m512i channel = _mm512_and_si512(
+        _mm512_srli_epi32(pixels, shift), _mm512_set1_epi32(255));
+    const __m512 prior = _mm512_div_ps(_mm512_cvtepi32_ps(channel), u8_max);
+    const __m512 mixed = _mm512_add_ps(
+        prior, _mm512_mul_ps(_mm512_sub_ps(target, prior), weight));
+    __m512 value = _mm512_mask_blend_ps(keep_prior, mixed, prior);
+    value = _mm512_mask_blend_ps(take_target, value, target);
+    value = _mm512_min_ps(_mm512_max_ps(value, _mm512_setzero_ps()),
+                          _mm512_set1_ps(1.0F));
+    const __m512 scaled = _mm512_add_ps(
+        _mm512_mul_ps(value, u8_max), _mm512_set1_ps(DB_CPU_ROUND_HALF_UP_F));
+    return _mm512_slli_epi32(_mm512_cvttps_epi32(scaled), shift);
+}
+
+__attribute__((target("avx512f"))) static void
+db_cpu_blend_rgba8_avx512(uint32_t *out, const uint32_t *prior,
+                          const float *weights, size_t count,
+                          const float target_rgb[3]) {
+    const __m512 target_r = _mm512_set1_ps(target_rgb[0]);
+    const __m512 target_g = _mm512_set1_ps(target_rgb[1]);
+    const __m512 target_b = _mm512_set1_ps(target_rgb[2]);
+    const __m512i alpha =
+        _mm512_set1_epi32((int)(DB_CPU_ALPHA_U8 << DB_CPU_COLOR_SHIFT_A));
+    for (size_t i = 0U; i < count; i += 16U) {
+        const size_t lanes = ((count - i) < 16U) ? (count - i) : 16U;
+        const __mmask16 active = (__mmask16)((lanes == 16U)
+                                                 ? 0xFFFFU
+                                                 : ((1U << lanes) - 1U));
+        const __m512i pixels =
+            _mm512_maskz_loadu_epi32(active, (const void *)&prior[i]);
+        const __m512 weight = _mm512_maskz_loadu_ps(active, &weights[i]);
+        const __mmask16 keep_prior =
+            _mm512_cmp_ps_mask(weight, _mm512_setzero_ps(), _CMP_LE_OQ);
+        const __mmask16 take_target =
+            _mm512_cmp_ps_mask(weight, _mm512_set1_ps(1.0F), _CMP_GE_OQ);
+        __m512i packed = alpha;
+        packed = _mm512_or_si512(
+            packed, db_cpu_blend_channel_avx512(pixels, DB_CPU_COLOR_SHIFT_R,
+                                                target_r, weight, keep_prior,
+                                                take_target));
+        packed = _mm512_or_si512(
+            packed, db_cpu_blend_channel_avx512(pixels, DB_CPU_COLOR_SHIFT_G,
+                                                target_g, weight, keep_prior,
+                                                take_target));
+        packed = _mm512_or_si512(
+            packed, db_cpu_blend_channel_avx512(pixels, DB_CPU_COLOR_SHIFT_B,
+                                                target_b, weight, keep_prior,
+                                                take_target));
+        _mm512_mask_storeu_epi32((void *)&out[i], active, packed);
+    }
+}
+
+// AVX-512F has a native 32-bit mullo, so it skips the pmaddwd split.
+__attribute__((target("avx512f"))) static __m512i
+db_cpu_blend_fixed_channel_avx512(__m512i pixels, unsigned int shift,
+                                  __m512i weight_keep, __m512i weight_take,
+                                  __m512i target_q8, __mmask16 *ambiguous) {
+    const __m512i channel_q8 = _mm512_slli_epi32(
+        _mm512_and_si512(_mm512_srli_epi32(pixels, shift),
+                         _mm512_set1_epi32(255)),
+        8);
+    const __m512i rounded = _mm512_add_epi32(
+        _mm512_add_epi32(_mm512_mullo_epi32(channel_q8, weight_keep),
+                         _mm512_mullo_epi32(target_q8, weight_take)),
+        _mm512_set1_epi32(DB_CPU_BLEND_FIXED_HALF));
+    const __m512i frac = _mm512_and_si512(
+        rounded, _mm512_set1_epi32(DB_CPU_BLEND_FIXED_FRAC_MASK));
+    *ambiguous |=
+        (__mmask16)(_mm512_cmplt_epi32_mask(
+                        frac, _mm512_set1_epi32(DB_CPU_BLEND_FIXED_GUARD)) |
+                    _mm512_cmpgt_epi32_mask(
+                        frac,
+                        _mm512_set1_epi32(DB_CPU_BLEND_FIXED_FRAC_MASK -
+                                          DB_CPU_BLEND_FIXED_GUARD)));
+    return _mm512_slli_epi32(
+        _mm512_srli_epi32(rounded, DB_CPU_BLEND_FIXED_FRAC_BITS), shift);
+}
+
+__attribute__((target("avx512f"))) static size_t
+db_cpu_blend_rgba8_fixed_avx512(uint32_t *out, const uint32_t *prior,
+                                const uint32_t *weights_q14,
+                                const float *weights, size_t count,
+                                const float target_rgb[3]) {
+    int32_t target_q8[3] = {0, 0, 0};
+    if (db_cpu_blend_target_q8(target_rgb, target_q8) == 0) {
+        db_cpu_blend_rgba8_avx512(out, prior, weights, count, target_rgb);
+        return count;
+    }
+    const __m512i target_r = _mm512_set1_epi32(target_q8[0]);
+    const __m512i target_g = _mm512_set1_epi32(target_q8[1]);
+    const __m512i target_b = _mm512_set1_epi32(target_q8[2]);
+    const __m512i alpha =
+        _mm512_set1_epi32((int)(DB_CPU_ALPHA_U8 << DB_CPU_COLOR_SHIFT_A));
+    size_t fallback_count = 0U;
+    for (size_t i = 0U; i < count; i += 16U) {
+        const size_t lanes = ((count - i) < 16U) ? (count - i) : 16U;
+        const __mmask16 active = (__mmask16)((lanes == 16U)
+                                                 ? 0xFFFFU
+                                                 : ((1U << lanes) - 1U));
+        const __m512i pixels =
+            _mm512_maskz_loadu_epi32(active, (const void *)&prior[i]);
+        const __m512i weight_pairs =
+            _mm512_maskz_loadu_epi32(active, (const void *)&weights_q14[i]);
+        const __m512i weight_keep =
+            _mm512_and_si512(weight_pairs, _mm512_set1_epi32(0xFFFF));
+        const __m512i weight_take = _mm512_srli_epi32(weight_pairs, 16);
+        __mmask16 ambiguous = 0;
+        __m512i packed = alpha;
+        packed = _mm512_or_si512(
+            packed, db_cpu_blend_fixed_channel_avx512(
+                        pixels, DB_CPU_COLOR_SHIFT_R, weight_keep,
+                        weight_take, target_r, &ambiguous));
+        packed = _mm512_or_si512(
+            packed, db_cpu_blend_fixed_channel_avx512(
+                        pixels, DB_CPU_COLOR_SHIFT_G, weight_keep,
+                        weight_take, target_g, &ambiguous));
+        packed = _mm512_or_si512(
+            packed, db_cpu_blend_fixed_channel_avx512(
+                        pixels, DB_CPU_COLOR_SHIFT_B, weight_keep,
+                        weight_take, target_b, &ambiguous));
+        uint32_t prior_lanes[16];
+        _mm512_storeu_si512((void *)prior_lanes, pixels);
+        _mm512_mask_storeu_epi32((void *)&out[i], active, packed);
+        uint32_t fallback_lanes = (uint32_t)(ambiguous & active);
+        while (fallback_lanes != 0U) {
+            const size_t lane = (size_t)__builtin_ctz(fallback_lanes);
+            db_cpu_blend_rgba8_scalar(&out[i + lane], &prior_lanes[lane],
+                                      &weights[i + lane], 1U, target_rgb);
+            fallback_count++;
+            fallback_lanes &= fallback_lanes - 1U;
+        }
+    }
+    return fallback_count;
+}
+#endif
+
+static const db_cpu_kernels_t g_cpu_kernels[] = {
+    {DB_CPU_KERNEL_SCALAR, DB_CPU_KERNEL_NAME_SCALAR, db_cpu_fill_u32_scalar,
+     db_cpu_blend_rgba8_scalar, db_cpu_blend_rgba8_fixed_scalar},
+#ifdef DB_CPU_KERNELS_X86
+    {DB_CPU_KERNEL_SSE2, DB_CPU_KERNEL_NAME_SSE2, db_cpu_fill_u32_sse2,
+     db_cpu_blend_rgba8_sse2, db_cpu_blend_rgba8_fixed_sse2},
+    {DB_CPU_KERNEL_AVX2, DB_CPU_KERNEL_NAME_AVX2, db_cpu_fill_u32_avx2,
+     db_cpu_blend_rgba8_avx2, db_cpu_blend_rgba8_fixed_avx2},
+    {DB_CPU_KERNEL_AVX512, DB_CPU_KERNEL_NAME_AVX512, db_cpu_fill_u32_avx512,
+     db_cpu_blend_rgba8_avx512, db_cpu_blend_rgba8_fixed_avx512},
+#endif
+};
+
+int db_cpu_blend_mode_parse(const char *name, db_cpu_blend_mode_t *out_mode) {
+    if ((name == NULL) || (name[0] == '\0') ||
+        (strcmp(name, DB_CPU_BLEND_NAME_FIXED) == 0)) {
+        *out_mode = DB_CPU_BLEND_FIXED;
+        return 1;
+    }
+    if (strcmp(name, DB_CPU_BLEND_NAME_FLOAT) == 0) {
+        *out_mode = DB_CPU_BLEND_FLOAT;
+        return 1;
+    }
+    if (strcmp(name, DB_CPU_BLEND_NAME_VALIDATE) == 0) {
+        *out_mode = DB_CPU_BLEND_VALIDATE;
+        return 1;
+    }
+    return 0;
+}
+
+const char *db_cpu_blend_mode_name(db_cpu_blend_mode_t mode) {
+    switch (mode) {
+    case DB_CPU_BLEND_FLOAT:
+        return DB_CPU_BLEND_NAME_FLOAT;
+    case DB_CPU_BLEND_VALIDATE:
+        return DB_CPU_BLEND_NAME_VALIDATE;
+    case DB_CPU_BLEND_FIXED:
+    default:
+        return DB_CPU_BLEND_NAME_FIXED;
+    }
+}
+
+int db_cpu_kernel_name_is_valid(const char *name) {
+    if (name == NULL) {
+        return 0;
+    }
+    return (strcmp(name, DB_CPU_KERNEL_NAME_AUTO) == 0) ||
+           (strcmp(name, DB_CPU_KERNEL_NAME_SCALAR) == 0) ||
+           (strcmp(name, DB_CPU_KERNEL_NAME_SSE2) == 0) ||
+           (strcmp(name, DB_CPU_KERNEL_NAME_AVX2) == 0) ||
+           (strcmp(name, DB_CPU_KERNEL_NAME_AVX512) == 0);
+}
+
+int db_cpu_kernel_variant_is_supported(db_cpu_kernel_variant_t variant) {
+    if (variant == DB_CPU_KERNEL_SCALAR) {
+        return 1;
+    }
+#ifdef DB_CPU_KERNELS_X86
+    __builtin_cpu_init();
+    if (variant == DB_CPU_KERNEL_SSE2) {
+        return __builtin_cpu_supports("sse2") ? 1 : 0;
+    }
+    if (variant == DB_CPU_KERNEL_AVX2) {
+        return __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    if (variant == DB_CPU_KERNEL_AVX512) {
+        return __builtin_cpu_supports("avx512f") ? 1 : 0;
+    }
+#endif
+    return 0;
+}
+
+const db_cpu_kernels_t *db_cpu_kernels_select(const char *backend,
+                                              const char *requested_name) {
+    const size_t kernel_count =
+        sizeof(g_cpu_kernels) / sizeof(g_cpu_kernels[0]);
+    const int is_auto = (requested_name == NULL) ||
+                        (requested_name[0] == '\0') ||
+                        (strcmp(requested_name, DB_CPU_KERNEL_NAME_AUTO) == 0);
+    if (is_auto != 0) {
+        for (size_t i = kernel_count; i > 0U; i--) {
+            if (db_cpu_kernel_variant_is_supported(
+                    g_cpu_kernels[i - 1U].variant) != 0) {
+                return &g_cpu_kernels[i - 1U];
+            }
+        }
+        return &g_cpu_kernels[0];
+    }
+
+    for (size_t i = 0U; i < kernel_count; i++) {
+        if (strcmp(g_cpu_kernels[i].name, requested_name) != 0) {
+            continue;
+        }
+        if (db_cpu_kernel_variant_is_supported(g_cpu_kernels[i].variant) ==
+            0) {
+            db_failf(backend, "CPU kernel '%s' is not supported on this host",
+                     requested_name);
+        }
+        return &g_cpu_kernels[i];
+    }
+    db_failf(backend, "CPU kernel '%s' is not compiled in this build",
+             requested_name);
+    return &g_cpu_kernels[0];
+}
@@ -0,0 +1,109 @@
+#ifndef DRIVERBENCH_RENDERER_CPU_KERNELS_H
+#define DRIVERBENCH_RENDERER_CPU_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DB_CPU_ALPHA_U8 255U
+#define DB_CPU_BLEND_NAME_FIXED "fixed"
+#define DB_CPU_BLEND_NAME_FLOAT "float"
+#define DB_CPU_BLEND_NAME_VALIDATE "validate"
+#define DB_CPU_BLEND_FIXED_FRAC_BITS 22U
+#define DB_CPU_BLEND_FIXED_GUARD (1 << 16)
+#define DB_CPU_BLEND_WEIGHT_ONE_Q14 16384U
+#define DB_CPU_BLEND_TARGET_SCALE_Q8 65280.0
+#define DB_CPU_COLOR_SHIFT_A 24U
+#define DB_CPU_COLOR_SHIFT_B 16U
+#define DB_CPU_COLOR_SHIFT_G 8U
+#define DB_CPU_COLOR_SHIFT_R 0U
+#define DB_CPU_KERNEL_NAME_AUTO "auto"
+#define DB_CPU_KERNEL_NAME_AVX2 "avx2"
+#define DB_CPU_KERNEL_NAME_AVX512 "avx512"
+#define DB_CPU_KERNEL_NAME_SCALAR "scalar"
+#define DB_CPU_KERNEL_NAME_SSE2 "sse2"
+#define DB_CPU_ROUND_HALF_UP_F 0.5F
+#define DB_CPU_U8_MAX_F 255.0F
+
+typedef enum {
+    DB_CPU_KERNEL_SCALAR = 0,
+    DB_CPU_KERNEL_SSE2 = 1,
+    DB_CPU_KERNEL_AVX2 = 2,
+    DB_CPU_KERNEL_AVX512 = 3,
+} db_cpu_kernel_variant_t;
+
+typedef enum {
+    DB_CPU_BLEND_FIXED = 0,
+    DB_CPU_BLEND_FLOAT = 1,
+    // Runs both paths and fails on the first pixel that differs.
+    DB_CPU_BLEND_VALIDATE = 2,
+} db_cpu_blend_mode_t;
+
+typedef struct {
+    db_cpu_kernel_variant_t variant;
+    const char *name;
+    void (*fill_u32)(uint32_t *dst, uint32_t value, size_t count);
+    // out[i] = pack(blend(unpack(prior[i]), target_rgb, weights[i])), with
+    // rounding identical to db_blend_rgb + db_cpu_channel_to_u8.
+    void (*blend_rgba8)(uint32_t *out, const uint32_t *prior,
+                        const float *weights, size_t count,
+                        const float target_rgb[3]);
+    // Integer variant of blend_rgba8. weights_q14 holds packed
+    // (16384 - w) | (w << 16) pairs from db_cpu_blend_weight_q14_pack.
+    // Channels whose fixed-point result lands within a guard band of a
+    // rounding boundary are recomputed through the float path, so the
+    // output always equals blend_rgba8. Returns the fallback pixel count.
+    size_t (*blend_rgba8_fixed)(uint32_t *out, const uint32_t *prior,
+                                const uint32_t *weights_q14,
+                                const float *weights, size_t count,
+                                const float target_rgb[3]);
+} db_cpu_kernels_t;
+
+int db_cpu_blend_mode_parse(const char *name, db_cpu_blend_mode_t *out_mode);
+const char *db_cpu_blend_mode_name(db_cpu_blend_mode_t mode);
+int db_cpu_kernel_name_is_valid(const char *name);
+int db_cpu_kernel_variant_is_supported(db_cpu_kernel_variant_t variant);
+const db_cpu_kernels_t *db_cpu_kernels_select(const char *backend,
+                                              const char *requested_name);
+
+static inline uint32_t db_cpu_channel_to_u8(float value) {
+    float clamped = value;
+    if (clamped < 0.0F) {
+        clamped = 0.0F;
+    } else if (clamped > 1.0F) {
+        clamped = 1.0F;
+    }
+    return (uint32_t)((clamped * DB_CPU_U8_MAX_F) + DB_CPU_ROUND_HALF_UP_F);
+}
+
+static inline uint32_t db_cpu_pack_rgb(float red, float green, float blue) {
+    const uint32_t red_u8 = db_cpu_channel_to_u8(red);
+    const uint32_t green_u8 = db_cpu_channel_to_u8(green);
+    const uint32_t blue_u8 = db_cpu_channel_to_u8(blue);
+    return (DB_CPU_ALPHA_U8 << DB_CPU_COLOR_SHIFT_A) |
+           (blue_u8 << DB_CPU_COLOR_SHIFT_B) |
+           (green_u8 << DB_CPU_COLOR_SHIFT_G) |
+           (red_u8 << DB_CPU_COLOR_SHIFT_R);
+}
+
+static inline uint32_t db_cpu_blend_weight_q14_pack(float weight) {
+    float clamped = weight;
+    if (clamped < 0.0F) {
+        clamped = 0.0F;
+    } else if (clamped > 1.0F) {
+        clamped = 1.0F;
+    }
+    const uint32_t w_q14 =
+        (uint32_t)(((double)clamped * DB_CPU_BLEND_WEIGHT_ONE_Q14) + 0.5);
+    return (DB_CPU_BLEND_WEIGHT_ONE_Q14 - w_q14) | (w_q14 << 16U);
+}
+
+static inline void db_cpu_unpack_rgb(uint32_t rgba, float *out_red,
+                                     float *out_green, float *out_blue) {
+    *out_red = (float)((rgba >> DB_CPU_COLOR_SHIFT_R) & 255U) / DB_CPU_U8_MAX_F;
+    *out_green =
+        (float)((rgba >> DB_CPU_COLOR_SHIFT_G) & 255U) / DB_CPU_U8_MAX_F;
+    *out_blue =
+        (float)((rgba >> DB_CPU_COLOR_SHIFT_B) & 255U) / DB_CPU_U8_MAX_F;
+}
+
+#endif
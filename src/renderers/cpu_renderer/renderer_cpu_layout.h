@@ -0,0 +1,139 @@
+#ifndef DRIVERBENCH_RENDERER_CPU_LAYOUT_H
+#define DRIVERBENCH_RENDERER_CPU_LAYOUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define DB_CPU_LAYOUT_MORTON_SHIFT 5U
+#define DB_CPU_LAYOUT_MORTON_EDGE (1U << DB_CPU_LAYOUT_MORTON_SHIFT)
+#define DB_CPU_LAYOUT_NAME_LINEAR "linear"
+#define DB_CPU_LAYOUT_NAME_MORTON "morton"
+#define DB_CPU_LAYOUT_NAME_TILED "tiled"
+#define DB_CPU_LAYOUT_TILED_SHIFT 3U
+
+typedef enum {
+    DB_CPU_LAYOUT_LINEAR = 0,
+    // 8x8 tiles, row-major inside each tile, tiles row-major.
+    DB_CPU_LAYOUT_TILED = 1,
+    // 32x32 blocks in Z-order inside each block, blocks row-major.
+    DB_CPU_LAYOUT_MORTON = 2,
+} db_cpu_layout_kind_t;
+
+// Storage addressing for a CPU BO. Every layout keeps each band of
+// (1 << block_shift) rows contiguous, so band-granular copies stay memcpy.
+typedef struct {
+    db_cpu_layout_kind_t kind;
+    uint32_t width;
+    uint32_t height;
+    uint32_t block_shift;
+    uint32_t blocks_x;
+    size_t block_pixels;
+    size_t band_pixels;
+    size_t storage_pixels;
+    uint32_t morton_x[DB_CPU_LAYOUT_MORTON_EDGE];
+    uint32_t morton_y[DB_CPU_LAYOUT_MORTON_EDGE];
+} db_cpu_layout_t;
+
+static inline int db_cpu_layout_parse(const char *name,
+                                      db_cpu_layout_kind_t *out_kind) {
+    if ((name == NULL) || (name[0] == '\0') ||
+        (strcmp(name, DB_CPU_LAYOUT_NAME_LINEAR) == 0)) {
+        *out_kind = DB_CPU_LAYOUT_LINEAR;
+        return 1;
+    }
+    if (strcmp(name, DB_CPU_LAYOUT_NAME_TILED) == 0) {
+        *out_kind = DB_CPU_LAYOUT_TILED;
+        return 1;
+    }
+    if (strcmp(name, DB_CPU_LAYOUT_NAME_MORTON) == 0) {
+        *out_kind = DB_CPU_LAYOUT_MORTON;
+        return 1;
+    }
+    return 0;
+}
+
+static inline const char *db_cpu_layout_name(db_cpu_layout_kind_t kind) {
+    if (kind == DB_CPU_LAYOUT_TILED) {
+        return DB_CPU_LAYOUT_NAME_TILED;
+    }
+    if (kind == DB_CPU_LAYOUT_MORTON) {
+        return DB_CPU_LAYOUT_NAME_MORTON;
+    }
+    return DB_CPU_LAYOUT_NAME_LINEAR;
+}
+
+static inline uint32_t db_cpu_layout_spread_bits(uint32_t value) {
+    uint32_t spread = 0U;
+    for (uint32_t bit = 0U; bit < DB_CPU_LAYOUT_MORTON_SHIFT; bit++) {
+        spread |= ((value >> bit) & 1U) << (bit * 2U);
+    }
+    return spread;
+}
+
+static inline void db_cpu_layout_init(db_cpu_layout_t *layout,
+                                      db_cpu_layout_kind_t kind,
+                                      uint32_t width, uint32_t height) {
+    *layout = (db_cpu_layout_t){0};
+    layout->kind = kind;
+    layout->width = width;
+    layout->height = height;
+    if (kind == DB_CPU_LAYOUT_TILED) {
+        layout->block_shift = DB_CPU_LAYOUT_TILED_SHIFT;
+    } else if (kind == DB_CPU_LAYOUT_MORTON) {
+        layout->block_shift = DB_CPU_LAYOUT_MORTON_SHIFT;
+    }
+    const uint32_t edge = 1U << layout->block_shift;
+    const uint32_t edge_mask = edge - 1U;
+    const uint32_t blocks_y = (height + edge_mask) >> layout->block_shift;
+    layout->blocks_x = (width + edge_mask) >> layout->block_shift;
+    layout->block_pixels = (size_t)edge * (size_t)edge;
+    layout->band_pixels = (size_t)layout->blocks_x * layout->block_pixels;
+    layout->storage_pixels = (size_t)blocks_y * layout->band_pixels;
+    for (uint32_t i = 0U; i < DB_CPU_LAYOUT_MORTON_EDGE; i++) {
+        layout->morton_x[i] = db_cpu_layout_spread_bits(i);
+        layout->morton_y[i] = db_cpu_layout_spread_bits(i) << 1U;
+    }
+}
+
+static inline uint32_t db_cpu_layout_band_rows(const db_cpu_layout_t *layout) {
+    return 1U << layout->block_shift;
+}
+
+static inline size_t db_cpu_layout_offset(const db_cpu_layout_t *layout,
+                                          uint32_t row, uint32_t col) {
+    if (layout->kind == DB_CPU_LAYOUT_LINEAR) {
+        return ((size_t)row * layout->width) + col;
+    }
+    const uint32_t shift = layout->block_shift;
+    const uint32_t mask = (1U << shift) - 1U;
+    const size_t block_base =
+        (((size_t)(row >> shift) * layout->blocks_x) + (col >> shift)) *
+        layout->block_pixels;
+    if (layout->kind == DB_CPU_LAYOUT_TILED) {
+        return block_base + ((size_t)(row & mask) << shift) + (col & mask);
+    }
+    return block_base + layout->morton_x[col & mask] +
+           layout->morton_y[row & mask];
+}
+
+// Length of the contiguous storage run starting at (row, col), capped at
+// col_end.
+static inline uint32_t db_cpu_layout_run_length(const db_cpu_layout_t *layout,
+                                                uint32_t col,
+                                                uint32_t col_end) {
+    const uint32_t remaining = col_end - col;
+    if (layout->kind == DB_CPU_LAYOUT_LINEAR) {
+        return remaining;
+    }
+    if (layout->kind == DB_CPU_LAYOUT_TILED) {
+        const uint32_t mask = (1U << layout->block_shift) - 1U;
+        const uint32_t in_tile = (mask + 1U) - (col & mask);
+        return (in_tile < remaining) ? in_tile : remaining;
+    }
+    // Z-order keeps only horizontally adjacent even/odd pairs together.
+    const uint32_t in_pair = 2U - (col & 1U);
+    return (in_pair < remaining) ? in_pair : remaining;
+}
+
+#endif
@@ -3,47 +3,253 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #include "../../config/benchmark_config.h"
 #include "../../core/db_buffer_convert.h"
 #include "../../core/db_core.h"
 #include "../../core/db_hash.h"
+#include "../../core/db_mem.h"
+#include "../../core/db_results.h"
+#include "../../core/db_trace.h"
+#include "../../core/db_worker_pool.h"
 #include "../renderer_benchmark_common.h"
 #include "../renderer_snake_common.h"
 #include "../renderer_snake_shape_common.h"
+#include "renderer_cpu_kernels.h"
+#include "renderer_cpu_layout.h"
 
 #define BACKEND_NAME "renderer_cpu_renderer"
-#define DB_ALPHA_U8 255U
 #define DB_CAP_MODE_CPU_OFFSCREEN_BO "cpu_offscreen_bo"
-#define DB_COLOR_SHIFT_A 24U
-#define DB_COLOR_SHIFT_B 16U
-#define DB_COLOR_SHIFT_G 8U
-#define DB_COLOR_SHIFT_R 0U
-#define DB_ROUND_HALF_UP_F 0.5F
-#define DB_U8_MAX_F 255.0F
+#define DB_CAP_MODE_TEXT_LEN 64U
+#define DB_CPU_BLEND_TABLE_BATCHES (BENCH_SNAKE_PHASE_WINDOW_TILES + 1U)
 
 typedef struct {
     uint32_t width;
     uint32_t height;
     uint32_t *pixels_rgba8;
+    // Generation of the content held by each row; rows whose generation
+    // matches between two BOs are known to hold identical pixels.
+    uint64_t *row_generation;
 } db_cpu_bo_t;
 
+typedef enum {
+    DB_CPU_ROW_JOB_SYNC = 0,
+    DB_CPU_ROW_JOB_FILL = 1,
+    DB_CPU_ROW_JOB_BANDS = 2,
+    DB_CPU_ROW_JOB_GRADIENT = 3,
+    DB_CPU_ROW_JOB_DETILE = 4,
+} db_cpu_row_job_kind_t;
+
+typedef struct {
+    db_cpu_row_job_kind_t kind;
+    db_cpu_bo_t *dst;
+    const db_cpu_bo_t *src;
+    const uint32_t *band_colors;
+    const db_dirty_row_range_t *skip_ranges;
+    size_t skip_range_count;
+    uint64_t generation;
+    uint32_t row_begin;
+    uint32_t row_end;
+    uint32_t fill_rgba;
+    uint32_t head_row;
+    uint32_t cycle_index;
+    int direction_down;
+} db_cpu_row_job_t;
+
 typedef struct {
     db_cpu_bo_t bos[2];
+    // Linear copy of the read BO for presenters and hashers; only used when
+    // the BOs are stored in a non-linear layout.
+    db_cpu_bo_t present;
+    db_cpu_layout_t layout;
     db_dirty_row_range_t damage_rows[2];
     size_t damage_row_count;
     db_snake_shape_row_bounds_t *snake_row_bounds;
     size_t snake_row_bounds_capacity;
     uint64_t state_hash;
+    uint64_t generation;
     uint32_t frame_index;
+    int full_repaint_pending;
     int history_mode;
     int history_read_index;
     int initialized;
     db_benchmark_runtime_init_t runtime;
+    const db_cpu_kernels_t *kernels;
+    db_cpu_blend_mode_t blend_mode;
+    db_mem_policy_t mem_policy;
+    uint64_t blend_pixel_count;
+    uint64_t blend_fallback_count;
+    // Window blend weights indexed by [batch_size][update_index], so the
+    // per-tile cost of db_window_blend_factor is paid once at init.
+    float blend_weights[DB_CPU_BLEND_TABLE_BATCHES]
+                       [BENCH_SNAKE_PHASE_WINDOW_TILES];
+    uint32_t blend_weights_q14[DB_CPU_BLEND_TABLE_BATCHES]
+                              [BENCH_SNAKE_PHASE_WINDOW_TILES];
+    char capability_mode[DB_CAP_MODE_TEXT_LEN];
 } db_cpu_renderer_state_t;
 
 static db_cpu_renderer_state_t g_state = {0};
 
+static uint32_t db_cpu_threads_from_runtime(uint32_t default_threads) {
+    const char *value = db_runtime_option_get(DB_RUNTIME_OPT_CPU_THREADS);
+    if ((value == NULL) || (value[0] == '\0')) {
+        return default_threads;
+    }
+    char *end = NULL;
+    const unsigned long parsed = strtoul(value, &end, 10);
+    if ((end == value) || (end == NULL) || (*end != '\0') || (parsed == 0UL) ||
+        (parsed > DB_WORKER_POOL_MAX_THREADS)) {
+        db_failf(BACKEND_NAME, "Invalid %s='%s' (expected: 1..%u)",
+                 DB_RUNTIME_OPT_CPU_THREADS, value,
+                 DB_WORKER_POOL_MAX_THREADS);
+    }
+    return (uint32_t)parsed;
+}
+
+static db_cpu_blend_mode_t db_cpu_blend_mode_from_runtime(void) {
+    const char *value = db_runtime_option_get(DB_RUNTIME_OPT_CPU_BLEND);
+    db_cpu_blend_mode_t mode = DB_CPU_BLEND_FIXED;
+    if (db_cpu_blend_mode_parse(value, &mode) == 0) {
+        db_failf(BACKEND_NAME, "Invalid %s='%s' (expected: %s|%s|%s)",
+                 DB_RUNTIME_OPT_CPU_BLEND, value, DB_CPU_BLEND_NAME_FIXED,
+                 DB_CPU_BLEND_NAME_FLOAT, DB_CPU_BLEND_NAME_VALIDATE);
+    }
+    return mode;
+}
+
+static db_cpu_layout_kind_t db_cpu_layout_from_runtime(void) {
+    const char *value = db_runtime_option_get(DB_RUNTIME_OPT_CPU_LAYOUT);
+    db_cpu_layout_kind_t kind = DB_CPU_LAYOUT_LINEAR;
+    if (db_cpu_layout_parse(value, &kind) == 0) {
+        db_failf(BACKEND_NAME, "Invalid %s='%s' (expected: %s|%s|%s)",
+                 DB_RUNTIME_OPT_CPU_LAYOUT, value, DB_CPU_LAYOUT_NAME_LINEAR,
+                 DB_CPU_LAYOUT_NAME_TILED, DB_CPU_LAYOUT_NAME_MORTON);
+    }
+    return kind;
+}
+
+static uint32_t db_cpu_online_thread_count(void) {
+    const long online = sysconf(_SC_NPROCESSORS_ONLN);
+    if (online <= 0L) {
+        return 1U;
+    }
+    return db_u32_min((uint32_t)online, DB_WORKER_POOL_MAX_THREADS);
+}
+
+static uint32_t db_cpu_threads_for_renderer(db_cpu_renderer_t kind) {
+    if (kind == DB_CPU_RENDERER_THREADED) {
+        return db_cpu_threads_from_runtime(db_cpu_online_thread_count());
+    }
+    const uint32_t threads = db_cpu_threads_from_runtime(1U);
+    if ((kind != DB_CPU_RENDERER_AUTO) && (threads != 1U)) {
+        db_failf(BACKEND_NAME, "renderer %s is single-threaded (%s=%u)",
+                 db_cpu_renderer_name(kind), DB_RUNTIME_OPT_CPU_THREADS,
+                 threads);
+    }
+    return threads;
+}
+
+static const char *db_cpu_kernel_for_renderer(db_cpu_renderer_t kind) {
+    const char *value = db_runtime_option_get(DB_RUNTIME_OPT_CPU_KERNEL);
+    const int is_scalar = (value != NULL) &&
+                          (strcmp(value, DB_CPU_KERNEL_NAME_SCALAR) == 0);
+    const int is_set = (value != NULL) && (value[0] != '\0') &&
+                       (strcmp(value, DB_CPU_KERNEL_NAME_AUTO) != 0);
+    if ((kind == DB_CPU_RENDERER_SCALAR) && (is_set != 0) &&
+        (is_scalar == 0)) {
+        db_failf(BACKEND_NAME, "renderer %s requires %s=%s (got '%s')",
+                 DB_CPU_RENDERER_NAME_SCALAR, DB_RUNTIME_OPT_CPU_KERNEL,
+                 DB_CPU_KERNEL_NAME_SCALAR, value);
+    }
+    if ((kind != DB_CPU_RENDERER_AUTO) && (kind != DB_CPU_RENDERER_SCALAR) &&
+        (is_scalar != 0)) {
+        db_failf(BACKEND_NAME, "renderer %s cannot use %s=%s",
+                 db_cpu_renderer_name(kind), DB_RUNTIME_OPT_CPU_KERNEL,
+                 DB_CPU_KERNEL_NAME_SCALAR);
+    }
+    if (kind == DB_CPU_RENDERER_SCALAR) {
+        return DB_CPU_KERNEL_NAME_SCALAR;
+    }
+    return value;
+}
+
+static db_mem_policy_t db_cpu_mem_policy_from_runtime(void) {
+    const char *value = db_runtime_option_get(DB_RUNTIME_OPT_CPU_MEM);
+    db_mem_policy_t policy = {0};
+    if (db_mem_policy_parse(value, &policy) == 0) {
+        db_failf(BACKEND_NAME, "Invalid %s='%s' (expected: %s|%s|%sN)",
+                 DB_RUNTIME_OPT_CPU_MEM, value, DB_MEM_POLICY_NAME_DEFAULT,
+                 DB_MEM_POLICY_NAME_HUGEPAGE, DB_MEM_POLICY_NUMA_PREFIX);
+    }
+    return policy;
+}
+
+static void db_cpu_log_mem_stats(const char *label) {
+    db_mem_stats_t stats = {0};
+    db_mem_stats_sample(&stats);
+    char policy_text[32];
+    db_mem_policy_format(&g_state.mem_policy, policy_text,
+                         sizeof(policy_text));
+    if (stats.dtlb_available != 0) {
+        db_infof(BACKEND_NAME,
+                 "cpu mem %s (%s): minor_faults=%llu major_faults=%llu "
+                 "dtlb_load_misses=%llu",
+                 label, policy_text, (unsigned long long)stats.minor_faults,
+                 (unsigned long long)stats.major_faults,
+                 (unsigned long long)stats.dtlb_misses);
+        return;
+    }
+    db_infof(BACKEND_NAME,
+             "cpu mem %s (%s): minor_faults=%llu major_faults=%llu "
+             "dtlb_load_misses=n/a",
+             label, policy_text, (unsigned long long)stats.minor_faults,
+             (unsigned long long)stats.major_faults);
+}
+
+static void db_cpu_build_blend_tables(void) {
+    for (uint32_t batch = 0U; batch < DB_CPU_BLEND_TABLE_BATCHES; batch++) {
+        for (uint32_t i = 0U; i < BENCH_SNAKE_PHASE_WINDOW_TILES; i++) {
+            const float weight =
+                (i < batch) ? db_window_blend_factor(i, batch) : 0.0F;
+            g_state.blend_weights[batch][i] = weight;
+            g_state.blend_weights_q14[batch][i] =
+                db_cpu_blend_weight_q14_pack(weight);
+        }
+    }
+}
+
+static void db_cpu_blend_batch(uint32_t *pixels, const uint32_t *weights_q14,
+                               const float *weights, size_t count,
+                               const float target_rgb[3]) {
+    const db_cpu_kernels_t *kernels = g_state.kernels;
+    g_state.blend_pixel_count += count;
+    if (g_state.blend_mode == DB_CPU_BLEND_FLOAT) {
+        kernels->blend_rgba8(pixels, pixels, weights, count, target_rgb);
+        return;
+    }
+    if (g_state.blend_mode == DB_CPU_BLEND_FIXED) {
+        g_state.blend_fallback_count += kernels->blend_rgba8_fixed(
+            pixels, pixels, weights_q14, weights, count, target_rgb);
+        return;
+    }
+
+    uint32_t reference[BENCH_SNAKE_PHASE_WINDOW_TILES];
+    kernels->blend_rgba8(reference, pixels, weights, count, target_rgb);
+    g_state.blend_fallback_count += kernels->blend_rgba8_fixed(
+        pixels, pixels, weights_q14, weights, count, target_rgb);
+    for (size_t i = 0U; i < count; i++) {
+        if (pixels[i] != reference[i]) {
+            db_failf(BACKEND_NAME,
+                     "fixed-point blend mismatch at frame %u tile %zu: "
+                     "fixed=0x%08x float=0x%08x weight=%.9g",
+                     g_state.frame_index, i, pixels[i], reference[i],
+                     (double)weights[i]);
+        }
+    }
+}
+
 static void db_cpu_set_full_damage(const db_cpu_bo_t *bo) {
     if ((bo == NULL) || (bo->height == 0U)) {
         g_state.damage_row_count = 0U;
@@ -109,78 +315,309 @@ static void db_cpu_set_damage_from_spans(const db_snake_col_span_t *spans,
     g_state.damage_row_count = 1U;
 }
 
-static uint32_t db_channel_to_u8(float value) {
-    float clamped = value;
-    if (clamped < 0.0F) {
-        clamped = 0.0F;
-    } else if (clamped > 1.0F) {
-        clamped = 1.0F;
+static void db_bo_mark_rows(db_cpu_bo_t *bo, uint32_t row_start,
+                            uint32_t row_end, uint64_t generation) {
+    for (uint32_t row = row_start; row < row_end; row++) {
+        bo->row_generation[row] = generation;
     }
-    return (uint32_t)((clamped * DB_U8_MAX_F) + DB_ROUND_HALF_UP_F);
 }
 
-static uint32_t db_pack_rgb(float red, float green, float blue) {
-    const uint32_t red_u8 = db_channel_to_u8(red);
-    const uint32_t green_u8 = db_channel_to_u8(green);
-    const uint32_t blue_u8 = db_channel_to_u8(blue);
-    return (DB_ALPHA_U8 << DB_COLOR_SHIFT_A) | (blue_u8 << DB_COLOR_SHIFT_B) |
-           (green_u8 << DB_COLOR_SHIFT_G) | (red_u8 << DB_COLOR_SHIFT_R);
+static void db_bo_fill_row_span(db_cpu_bo_t *bo, uint32_t row,
+                                uint32_t col_start, uint32_t col_end,
+                                uint32_t rgba) {
+    const db_cpu_layout_t *layout = &g_state.layout;
+    uint32_t col = col_start;
+    while (col < col_end) {
+        const uint32_t run = db_cpu_layout_run_length(layout, col, col_end);
+        g_state.kernels->fill_u32(
+            &bo->pixels_rgba8[db_cpu_layout_offset(layout, row, col)], rgba,
+            (size_t)run);
+        col += run;
+    }
 }
 
-static void db_unpack_rgb(uint32_t rgba, float *out_red, float *out_green,
-                          float *out_blue) {
-    *out_red = (float)((rgba >> DB_COLOR_SHIFT_R) & 255U) / DB_U8_MAX_F;
-    *out_green = (float)((rgba >> DB_COLOR_SHIFT_G) & 255U) / DB_U8_MAX_F;
-    *out_blue = (float)((rgba >> DB_COLOR_SHIFT_B) & 255U) / DB_U8_MAX_F;
+// First and one-past-last storage index of the bands covering
+// [row_start, row_end); rows of a band are contiguous in every layout.
+static void db_bo_band_extent(uint32_t row_start, uint32_t row_end,
+                              size_t *out_begin, size_t *out_end) {
+    const db_cpu_layout_t *layout = &g_state.layout;
+    const uint32_t shift = layout->block_shift;
+    const uint32_t band_mask = db_cpu_layout_band_rows(layout) - 1U;
+    *out_begin = (size_t)(row_start >> shift) * layout->band_pixels;
+    *out_end = (size_t)((row_end + band_mask) >> shift) * layout->band_pixels;
 }
 
-static void db_bo_fill_solid(db_cpu_bo_t *bo, uint32_t rgba) {
-    const uint64_t pixel_count = (uint64_t)bo->width * (uint64_t)bo->height;
-    for (uint64_t idx = 0U; idx < pixel_count; idx++) {
-        bo->pixels_rgba8[idx] = rgba;
+static void db_bo_fill_solid_rows(db_cpu_bo_t *bo, uint32_t rgba,
+                                  uint32_t row_start, uint32_t row_end,
+                                  uint64_t generation) {
+    const uint32_t band_mask = db_cpu_layout_band_rows(&g_state.layout) - 1U;
+    if (((row_start & band_mask) == 0U) &&
+        (((row_end & band_mask) == 0U) || (row_end == bo->height))) {
+        size_t begin = 0U;
+        size_t end = 0U;
+        db_bo_band_extent(row_start, row_end, &begin, &end);
+        g_state.kernels->fill_u32(&bo->pixels_rgba8[begin], rgba, end - begin);
+    } else {
+        for (uint32_t row = row_start; row < row_end; row++) {
+            db_bo_fill_row_span(bo, row, 0U, bo->width, rgba);
+        }
     }
+    db_bo_mark_rows(bo, row_start, row_end, generation);
 }
 
-static void db_bo_copy(db_cpu_bo_t *dst, const db_cpu_bo_t *src) {
-    const size_t pixel_count =
-        (size_t)((uint64_t)dst->width * (uint64_t)dst->height);
-    db_copy_u32_buffer(dst->pixels_rgba8, src->pixels_rgba8, pixel_count);
+static int db_row_in_ranges(uint32_t row, const db_dirty_row_range_t *ranges,
+                            size_t range_count) {
+    for (size_t i = 0U; i < range_count; i++) {
+        if ((row >= ranges[i].row_start) &&
+            ((row - ranges[i].row_start) < ranges[i].row_count)) {
+            return 1;
+        }
+    }
+    return 0;
 }
 
-static size_t db_grid_index(uint32_t row, uint32_t col, uint32_t cols) {
-    return ((size_t)row * (size_t)cols) + (size_t)col;
+static int db_bo_row_needs_sync(const db_cpu_bo_t *dst,
+                                 const db_cpu_bo_t *src, uint32_t row,
+                                 const db_dirty_row_range_t *skip_ranges,
+                                 size_t skip_range_count) {
+    return (dst->row_generation[row] != src->row_generation[row]) &&
+           (db_row_in_ranges(row, skip_ranges, skip_range_count) == 0);
 }
 
-static void db_render_bands(db_cpu_bo_t *bo, uint32_t frame_index) {
+// Whole bands are the sync unit, so a non-linear layout copies every row of
+// a band that holds at least one stale row. Rows that were already current
+// are rewritten with identical content.
+static int db_bo_band_needs_sync(const db_cpu_bo_t *dst,
+                                 const db_cpu_bo_t *src, uint32_t band_start,
+                                 uint32_t band_end,
+                                 const db_dirty_row_range_t *skip_ranges,
+                                 size_t skip_range_count) {
+    for (uint32_t row = band_start; row < band_end; row++) {
+        if (db_bo_row_needs_sync(dst, src, row, skip_ranges,
+                                 skip_range_count) != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void db_bo_sync_rows(db_cpu_bo_t *dst, const db_cpu_bo_t *src,
+                            uint32_t row_start, uint32_t row_end,
+                            const db_dirty_row_range_t *skip_ranges,
+                            size_t skip_range_count) {
+    const uint32_t band_rows = db_cpu_layout_band_rows(&g_state.layout);
+    uint32_t row = row_start;
+    while (row < row_end) {
+        const uint32_t band_end = db_u32_min(row + band_rows, row_end);
+        if (db_bo_band_needs_sync(dst, src, row, band_end, skip_ranges,
+                                  skip_range_count) == 0) {
+            row = band_end;
+            continue;
+        }
+        uint32_t run_end = band_end;
+        while (run_end < row_end) {
+            const uint32_t next_end = db_u32_min(run_end + band_rows, row_end);
+            if (db_bo_band_needs_sync(dst, src, run_end, next_end, skip_ranges,
+                                      skip_range_count) == 0) {
+                break;
+            }
+            run_end = next_end;
+        }
+        size_t begin = 0U;
+        size_t end = 0U;
+        db_bo_band_extent(row, run_end, &begin, &end);
+        db_copy_u32_buffer(&dst->pixels_rgba8[begin],
+                           &src->pixels_rgba8[begin], end - begin);
+        for (uint32_t synced = row; synced < run_end; synced++) {
+            dst->row_generation[synced] = src->row_generation[synced];
+        }
+        row = run_end;
+    }
+}
+
+// Streams stale rows of a (possibly tiled) BO into the linear present BO.
+static void db_bo_detile_rows(db_cpu_bo_t *dst, const db_cpu_bo_t *src,
+                              uint32_t row_start, uint32_t row_end) {
+    const db_cpu_layout_t *layout = &g_state.layout;
+    const uint32_t cols = dst->width;
+    for (uint32_t row = row_start; row < row_end; row++) {
+        if (dst->row_generation[row] == src->row_generation[row]) {
+            continue;
+        }
+        uint32_t *dst_row = &dst->pixels_rgba8[(size_t)row * cols];
+        uint32_t col = 0U;
+        while (col < cols) {
+            const uint32_t run = db_cpu_layout_run_length(layout, col, cols);
+            db_copy_u32_buffer(
+                &dst_row[col],
+                &src->pixels_rgba8[db_cpu_layout_offset(layout, row, col)],
+                (size_t)run);
+            col += run;
+        }
+        dst->row_generation[row] = src->row_generation[row];
+    }
+}
+
+static void db_render_bands_rows(db_cpu_bo_t *bo, const uint32_t *band_colors,
+                                 uint32_t row_start, uint32_t row_end,
+                                 uint64_t generation) {
+    const uint32_t cols = bo->width;
+    for (uint32_t row = row_start; row < row_end; row++) {
+        for (uint32_t band = 0U; band < BENCH_BANDS; band++) {
+            const uint32_t x0 = (band * cols) / BENCH_BANDS;
+            const uint32_t x1 = ((band + 1U) * cols) / BENCH_BANDS;
+            db_bo_fill_row_span(bo, row, x0, x1, band_colors[band]);
+        }
+    }
+    db_bo_mark_rows(bo, row_start, row_end, generation);
+}
+
+static void db_render_gradient_rows(db_cpu_bo_t *bo, uint32_t head_row,
+                                    int direction_down, uint32_t cycle_index,
+                                    uint32_t row_start, uint32_t row_end,
+                                    uint64_t generation) {
     const uint32_t cols = bo->width;
-    const uint32_t rows = bo->height;
-    if ((cols == 0U) || (rows == 0U)) {
+    for (uint32_t row = row_start; row < row_end; row++) {
+        float row_red = 0.0F;
+        float row_green = 0.0F;
+        float row_blue = 0.0F;
+        db_gradient_row_color_rgb(row, head_row, direction_down, cycle_index,
+                                  &row_red, &row_green, &row_blue);
+        const uint32_t rgba = db_cpu_pack_rgb(row_red, row_green, row_blue);
+        db_bo_fill_row_span(bo, row, 0U, cols, rgba);
+    }
+    db_bo_mark_rows(bo, row_start, row_end, generation);
+}
+
+// Worker boundaries are rounded down to band starts so that no two workers
+// share a tile; the job's own begin/end are kept as-is.
+static uint32_t db_cpu_snap_row_to_band(const db_cpu_row_job_t *job,
+                                        uint32_t row) {
+    if ((row == job->row_begin) || (row == job->row_end)) {
+        return row;
+    }
+    const uint32_t band_mask = db_cpu_layout_band_rows(&g_state.layout) - 1U;
+    const uint32_t snapped = row & ~band_mask;
+    return (snapped < job->row_begin) ? job->row_begin : snapped;
+}
+
+static void db_cpu_row_job_task(void *ctx, uint32_t worker_index,
+                                uint32_t worker_count) {
+    const db_cpu_row_job_t *job = (const db_cpu_row_job_t *)ctx;
+    uint32_t row_start = 0U;
+    uint32_t row_end = 0U;
+    db_worker_pool_split_rows(job->row_end - job->row_begin, worker_index,
+                              worker_count, &row_start, &row_end);
+    row_start = db_cpu_snap_row_to_band(job, row_start + job->row_begin);
+    row_end = db_cpu_snap_row_to_band(job, row_end + job->row_begin);
+    if (row_end <= row_start) {
         return;
     }
+    switch (job->kind) {
+    case DB_CPU_ROW_JOB_SYNC:
+        db_bo_sync_rows(job->dst, job->src, row_start, row_end,
+                        job->skip_ranges, job->skip_range_count);
+        break;
+    case DB_CPU_ROW_JOB_FILL:
+        db_bo_fill_solid_rows(job->dst, job->fill_rgba, row_start, row_end,
+                              job->generation);
+        break;
+    case DB_CPU_ROW_JOB_BANDS:
+        db_render_bands_rows(job->dst, job->band_colors, row_start, row_end,
+                             job->generation);
+        break;
+    case DB_CPU_ROW_JOB_GRADIENT:
+        db_render_gradient_rows(job->dst, job->head_row, job->direction_down,
+                                job->cycle_index, row_start, row_end,
+                                job->generation);
+        break;
+    case DB_CPU_ROW_JOB_DETILE:
+        db_bo_detile_rows(job->dst, job->src, row_start, row_end);
+        break;
+    }
+}
 
+static void db_bo_fill_solid(db_cpu_bo_t *bo, uint32_t rgba,
+                             uint64_t generation) {
+    db_cpu_row_job_t job = {
+        .kind = DB_CPU_ROW_JOB_FILL,
+        .dst = bo,
+        .generation = generation,
+        .row_begin = 0U,
+        .row_end = bo->height,
+        .fill_rgba = rgba,
+    };
+    db_worker_pool_run(db_cpu_row_job_task, &job);
+}
+
+// Brings dst up to date with src, skipping rows that are about to be fully
+// repainted anyway.
+static void db_bo_sync(db_cpu_bo_t *dst, const db_cpu_bo_t *src,
+                       const db_dirty_row_range_t *skip_ranges,
+                       size_t skip_range_count) {
+    if (dst == src) {
+        return;
+    }
+    db_cpu_row_job_t job = {
+        .kind = DB_CPU_ROW_JOB_SYNC,
+        .dst = dst,
+        .src = src,
+        .skip_ranges = skip_ranges,
+        .skip_range_count = skip_range_count,
+        .row_begin = 0U,
+        .row_end = dst->height,
+    };
+    db_worker_pool_run(db_cpu_row_job_task, &job);
+}
+
+static void db_render_bands(db_cpu_bo_t *bo, uint32_t frame_index,
+                            uint64_t generation) {
+    if ((bo->width == 0U) || (bo->height == 0U)) {
+        return;
+    }
+
+    uint32_t band_colors[BENCH_BANDS];
     for (uint32_t band = 0U; band < BENCH_BANDS; band++) {
         float band_red = 0.0F;
         float band_green = 0.0F;
         float band_blue = 0.0F;
         db_band_color_rgb(band, BENCH_BANDS, frame_index, &band_red,
                           &band_green, &band_blue);
-        const uint32_t color = db_pack_rgb(band_red, band_green, band_blue);
-        const uint32_t x0 = (band * cols) / BENCH_BANDS;
-        const uint32_t x1 = ((band + 1U) * cols) / BENCH_BANDS;
-        for (uint32_t row = 0U; row < rows; row++) {
-            const size_t row_base = (size_t)row * cols;
-            for (uint32_t col = x0; col < x1; col++) {
-                bo->pixels_rgba8[row_base + col] = color;
-            }
-        }
+        band_colors[band] = db_cpu_pack_rgb(band_red, band_green, band_blue);
+    }
+    db_cpu_row_job_t job = {
+        .kind = DB_CPU_ROW_JOB_BANDS,
+        .dst = bo,
+        .band_colors = band_colors,
+        .generation = generation,
+        .row_begin = 0U,
+        .row_end = bo->height,
+    };
+    db_worker_pool_run(db_cpu_row_job_task, &job);
+}
+
+// Clips a snake row run to the grid and, for shapes, to the shape's bounds
+// on that row. Returns 0 when no tile of the run is painted.
+static int db_cpu_snake_run_clip(const db_snake_row_run_t *run,
+                                 const db_snake_shape_cache_t *shape_cache,
+                                 const db_cpu_bo_t *bo,
+                                 uint32_t *out_col_start,
+                                 uint32_t *out_col_end) {
+    if ((run->row >= bo->height) ||
+        (db_snake_row_run_clip_to_shape(run, shape_cache, out_col_start,
+                                        out_col_end) == 0)) {
+        return 0;
     }
+    *out_col_end = db_u32_min(*out_col_end, bo->width);
+    return (*out_col_end > *out_col_start) ? 1 : 0;
 }
 
 static void db_render_snake_step(
     db_cpu_bo_t *write_bo, const db_cpu_bo_t *read_bo,
     const db_snake_plan_t *plan, const db_snake_region_t *region,
     const db_snake_shape_cache_t *shape_cache_ptr, float target_red,
-    float target_green, float target_blue, int full_fill_on_phase_completed) {
+    float target_green, float target_blue, int full_fill_on_phase_completed,
+    uint64_t generation) {
     if ((plan == NULL) || (region == NULL)) {
         return;
     }
@@ -188,93 +625,111 @@ static void db_render_snake_step(
         return;
     }
 
-    const uint32_t cols = write_bo->width;
-    const uint32_t rows = write_bo->height;
     const uint32_t target_rgba =
-        db_pack_rgb(target_red, target_green, target_blue);
+        db_cpu_pack_rgb(target_red, target_green, target_blue);
     if ((full_fill_on_phase_completed != 0) && (plan->phase_completed != 0)) {
-        db_bo_fill_solid(write_bo, target_rgba);
+        db_bo_fill_solid(write_bo, target_rgba, generation);
         return;
     }
 
-    for (uint32_t update_index = 0U; update_index < plan->prev_count;
-         update_index++) {
-        const uint32_t step = plan->prev_start + update_index;
-        if (step >= plan->target_tile_count) {
-            break;
+    db_snake_row_run_t run;
+    uint32_t col_start = 0U;
+    uint32_t col_end = 0U;
+    db_snake_row_run_iter_t settled =
+        db_snake_row_run_iter_make(region, plan->prev_start, plan->prev_count);
+    while (db_snake_row_run_next(&settled, &run) != 0) {
+        if (db_cpu_snake_run_clip(&run, shape_cache_ptr, write_bo, &col_start,
+                                  &col_end) != 0) {
+            db_bo_fill_row_span(write_bo, run.row, col_start, col_end,
+                                target_rgba);
         }
-        const uint32_t tile_index = db_snake_tile_index_from_step(region, step);
-        const uint32_t row = tile_index / cols;
-        const uint32_t col = tile_index % cols;
-        if ((row >= rows) || (col >= cols)) {
-            continue;
-        }
-        if (shape_cache_ptr != NULL) {
-            const int inside =
-                db_snake_shape_cache_contains_tile(shape_cache_ptr, row, col);
-            if (inside == 0) {
-                continue;
-            }
-        }
-        write_bo->pixels_rgba8[db_grid_index(row, col, cols)] = target_rgba;
     }
 
-    for (uint32_t update_index = 0U; update_index < plan->batch_size;
-         update_index++) {
-        const uint32_t step = plan->active_cursor + update_index;
-        if (step >= plan->target_tile_count) {
-            break;
-        }
-        const uint32_t tile_index = db_snake_tile_index_from_step(region, step);
-        const uint32_t row = tile_index / cols;
-        const uint32_t col = tile_index % cols;
-        if ((row >= rows) || (col >= cols)) {
+    size_t blend_indices[BENCH_SNAKE_PHASE_WINDOW_TILES];
+    uint32_t blend_pixels[BENCH_SNAKE_PHASE_WINDOW_TILES];
+    float blend_weights[BENCH_SNAKE_PHASE_WINDOW_TILES];
+    uint32_t blend_weights_q14[BENCH_SNAKE_PHASE_WINDOW_TILES];
+    size_t blend_count = 0U;
+    const uint32_t batch_size =
+        db_u32_min(plan->batch_size, BENCH_SNAKE_PHASE_WINDOW_TILES);
+    const float *batch_weights = g_state.blend_weights[batch_size];
+    const uint32_t *batch_weights_q14 = g_state.blend_weights_q14[batch_size];
+    db_snake_row_run_iter_t active =
+        db_snake_row_run_iter_make(region, plan->active_cursor, batch_size);
+    while (db_snake_row_run_next(&active, &run) != 0) {
+        if (db_cpu_snake_run_clip(&run, shape_cache_ptr, write_bo, &col_start,
+                                  &col_end) == 0) {
             continue;
         }
-        if (shape_cache_ptr != NULL) {
-            const int inside =
-                db_snake_shape_cache_contains_tile(shape_cache_ptr, row, col);
-            if (inside == 0) {
+        const uint32_t run_steps = run.col_end - run.col_start;
+        for (uint32_t i = 0U; i < run_steps; i++) {
+            const uint32_t col = db_snake_row_run_col(&run, i);
+            if ((col < col_start) || (col >= col_end)) {
                 continue;
             }
+            const uint32_t update_index = run.step_offset + i;
+            const size_t idx =
+                db_cpu_layout_offset(&g_state.layout, run.row, col);
+            blend_indices[blend_count] = idx;
+            blend_pixels[blend_count] = read_bo->pixels_rgba8[idx];
+            blend_weights[blend_count] = batch_weights[update_index];
+            blend_weights_q14[blend_count] = batch_weights_q14[update_index];
+            blend_count++;
         }
-        const size_t idx = db_grid_index(row, col, cols);
-        float prior_red = 0.0F;
-        float prior_green = 0.0F;
-        float prior_blue = 0.0F;
-        db_unpack_rgb(read_bo->pixels_rgba8[idx], &prior_red, &prior_green,
-                      &prior_blue);
-        const float blend =
-            db_window_blend_factor(update_index, plan->batch_size);
-        float out_red = 0.0F;
-        float out_green = 0.0F;
-        float out_blue = 0.0F;
-        db_blend_rgb(prior_red, prior_green, prior_blue, target_red,
-                     target_green, target_blue, blend, &out_red, &out_green,
-                     &out_blue);
-        write_bo->pixels_rgba8[idx] = db_pack_rgb(out_red, out_green, out_blue);
-    }
-}
-
-static void db_render_gradient(db_cpu_bo_t *bo, uint32_t head_row,
-                               int direction_down, uint32_t cycle_index) {
-    const uint32_t cols = bo->width;
-    const uint32_t rows = bo->height;
-    for (uint32_t row = 0U; row < rows; row++) {
-        float row_red = 0.0F;
-        float row_green = 0.0F;
-        float row_blue = 0.0F;
-        db_gradient_row_color_rgb(row, head_row, direction_down, cycle_index,
-                                  &row_red, &row_green, &row_blue);
-        const uint32_t rgba = db_pack_rgb(row_red, row_green, row_blue);
-        const size_t row_base = (size_t)row * cols;
-        for (uint32_t col = 0U; col < cols; col++) {
-            bo->pixels_rgba8[row_base + col] = rgba;
-        }
+    }
+    if (blend_count == 0U) {
+        return;
+    }
+    const float target_rgb[3] = {target_red, target_green, target_blue};
+    db_cpu_blend_batch(blend_pixels, blend_weights_q14, blend_weights,
+                       blend_count, target_rgb);
+    for (size_t i = 0U; i < blend_count; i++) {
+        write_bo->pixels_rgba8[blend_indices[i]] = blend_pixels[i];
     }
 }
 
-void db_renderer_cpu_renderer_init(void) {
+static void db_render_gradient_range(db_cpu_bo_t *bo, uint32_t head_row,
+                                     int direction_down, uint32_t cycle_index,
+                                     const db_dirty_row_range_t *range,
+                                     uint64_t generation) {
+    db_cpu_row_job_t job = {
+        .kind = DB_CPU_ROW_JOB_GRADIENT,
+        .dst = bo,
+        .generation = generation,
+        .row_begin = range->row_start,
+        .row_end = range->row_start + range->row_count,
+        .head_row = head_row,
+        .cycle_index = cycle_index,
+        .direction_down = direction_down,
+    };
+    db_worker_pool_run(db_cpu_row_job_task, &job);
+}
+
+static void db_cpu_mark_damage_rows(db_cpu_bo_t *bo, uint64_t generation) {
+    for (size_t i = 0U; i < g_state.damage_row_count; i++) {
+        const db_dirty_row_range_t *range = &g_state.damage_rows[i];
+        db_bo_mark_rows(bo, range->row_start,
+                        range->row_start + range->row_count, generation);
+    }
+}
+
+// NULL means the whole region rectangle is painted.
+static const db_snake_shape_cache_t *
+db_cpu_snake_shape_cache(db_snake_shape_cache_t *shape_cache,
+                         uint32_t shape_index, const db_snake_region_t *region,
+                         db_snake_shape_kind_t shape_kind) {
+    if ((g_state.snake_row_bounds == NULL) ||
+        (g_state.snake_row_bounds_capacity == 0U) ||
+        (db_snake_shape_cache_init_from_index(
+             shape_cache, g_state.snake_row_bounds,
+             g_state.snake_row_bounds_capacity, g_state.runtime.pattern_seed,
+             shape_index, DB_U32_SALT_PALETTE, region, shape_kind) == 0)) {
+        return NULL;
+    }
+    return shape_cache;
+}
+
+static void db_cpu_renderer_init_variant(db_cpu_renderer_t renderer_kind) {
     if (g_state.initialized != 0) {
         return;
     }
@@ -292,29 +747,71 @@ void db_renderer_cpu_renderer_init(void) {
         db_failf(BACKEND_NAME, "invalid offscreen BO size: %ux%u", grid_cols,
                  grid_rows);
     }
+    db_cpu_layout_t layout = {0};
+    db_cpu_layout_init(&layout, db_cpu_layout_from_runtime(), grid_cols,
+                       grid_rows);
 
+    const db_mem_policy_t mem_policy = db_cpu_mem_policy_from_runtime();
+    // The perf counter must be open before the workers exist so they
+    // inherit it.
+    db_mem_stats_begin(BACKEND_NAME);
+    const db_cpu_kernels_t *kernels = db_cpu_kernels_select(
+        BACKEND_NAME, db_cpu_kernel_for_renderer(renderer_kind));
+    g_state.kernels = kernels;
+    g_state.layout = layout;
+    db_worker_pool_start(BACKEND_NAME,
+                         db_cpu_threads_for_renderer(renderer_kind));
+    if (mem_policy.kind == DB_MEM_POLICY_NUMA) {
+        uint32_t node_cpus[DB_MEM_NUMA_MAX_CPUS];
+        const size_t node_cpu_count =
+            db_mem_numa_node_cpus(BACKEND_NAME, mem_policy.numa_node,
+                                  node_cpus, DB_MEM_NUMA_MAX_CPUS);
+        db_worker_pool_pin_cpus(BACKEND_NAME, node_cpus, node_cpu_count);
+    }
+
+    // Pixel storage is first touched by the pooled phase0 fill below, so
+    // with numa=N each band lands on the node of the thread that owns it.
     db_cpu_bo_t bos[2] = {
         {.width = grid_cols,
          .height = grid_rows,
-         .pixels_rgba8 = (uint32_t *)db_alloc_array_or_fail(
-             BACKEND_NAME, "pixels_rgba8", (size_t)pixel_count,
-             sizeof(uint32_t))},
+         .pixels_rgba8 = (uint32_t *)db_mem_alloc_or_fail(
+             BACKEND_NAME, "pixels_rgba8", layout.storage_pixels,
+             sizeof(uint32_t), &mem_policy),
+         .row_generation = (uint64_t *)db_alloc_array_or_fail(
+             BACKEND_NAME, "row_generation", (size_t)grid_rows,
+             sizeof(uint64_t))},
         {.width = grid_cols,
          .height = grid_rows,
-         .pixels_rgba8 = (uint32_t *)db_alloc_array_or_fail(
-             BACKEND_NAME, "pixels_rgba8", (size_t)pixel_count,
-             sizeof(uint32_t))},
+         .pixels_rgba8 = (uint32_t *)db_mem_alloc_or_fail(
+             BACKEND_NAME, "pixels_rgba8", layout.storage_pixels,
+             sizeof(uint32_t), &mem_policy),
+         .row_generation = (uint64_t *)db_alloc_array_or_fail(
+             BACKEND_NAME, "row_generation", (size_t)grid_rows,
+             sizeof(uint64_t))},
     };
-    if ((bos[0].pixels_rgba8 == NULL) || (bos[1].pixels_rgba8 == NULL)) {
-        free(bos[0].pixels_rgba8);
-        free(bos[1].pixels_rgba8);
-        db_failf(BACKEND_NAME, "failed to allocate offscreen BOs");
+    db_cpu_bo_t present = {0};
+    if (layout.kind != DB_CPU_LAYOUT_LINEAR) {
+        present = (db_cpu_bo_t){
+            .width = grid_cols,
+            .height = grid_rows,
+            .pixels_rgba8 = (uint32_t *)db_mem_alloc_or_fail(
+                BACKEND_NAME, "present_pixels_rgba8", (size_t)pixel_count,
+                sizeof(uint32_t), &mem_policy),
+            .row_generation = (uint64_t *)db_alloc_array_or_fail(
+                BACKEND_NAME, "present_row_generation", (size_t)grid_rows,
+                sizeof(uint64_t)),
+        };
+        // No generation matches UINT64_MAX, so the first present detiles
+        // every row.
+        for (uint32_t row = 0U; row < grid_rows; row++) {
+            present.row_generation[row] = UINT64_MAX;
+        }
     }
 
-    const uint32_t phase0 = db_pack_rgb(
+    const uint32_t phase0 = db_cpu_pack_rgb(
         BENCH_GRID_PHASE0_R, BENCH_GRID_PHASE0_G, BENCH_GRID_PHASE0_B);
-    db_bo_fill_solid(&bos[0], phase0);
-    db_bo_fill_solid(&bos[1], phase0);
+    db_bo_fill_solid(&bos[0], phase0, 0U);
+    db_bo_fill_solid(&bos[1], phase0, 0U);
     db_snake_shape_row_bounds_t *snake_row_bounds = NULL;
     size_t snake_row_bounds_capacity = 0U;
     if (init_state.pattern == DB_PATTERN_SNAKE_SHAPES) {
@@ -330,31 +827,87 @@ void db_renderer_cpu_renderer_init(void) {
     g_state.runtime = init_state;
     g_state.bos[0] = bos[0];
     g_state.bos[1] = bos[1];
+    g_state.present = present;
+    g_state.layout = layout;
     g_state.history_mode = db_pattern_uses_history_texture(init_state.pattern);
     g_state.history_read_index = 0;
+    g_state.full_repaint_pending = 1;
     g_state.runtime.snake_shape_index = 0U;
     g_state.snake_row_bounds = snake_row_bounds;
     g_state.snake_row_bounds_capacity = snake_row_bounds_capacity;
+    g_state.kernels = kernels;
+    g_state.blend_mode = db_cpu_blend_mode_from_runtime();
+    g_state.mem_policy = mem_policy;
+    db_cpu_build_blend_tables();
+    // cpu_offscreen_bo[_<renderer>]_<kernel>[_<layout>][_t<threads>]; the
+    // renderer is left out for auto and the thread count when single.
+    char renderer_part[DB_CAP_MODE_TEXT_LEN] = "";
+    char layout_part[DB_CAP_MODE_TEXT_LEN] = "";
+    char threads_part[DB_CAP_MODE_TEXT_LEN] = "";
+    if (renderer_kind != DB_CPU_RENDERER_AUTO) {
+        (void)db_snprintf(renderer_part, sizeof(renderer_part), "_%s",
+                          db_cpu_renderer_name(renderer_kind));
+    }
+    if (layout.kind != DB_CPU_LAYOUT_LINEAR) {
+        (void)db_snprintf(layout_part, sizeof(layout_part), "_%s",
+                          db_cpu_layout_name(layout.kind));
+    }
+    if (db_worker_pool_thread_count() > 1U) {
+        (void)db_snprintf(threads_part, sizeof(threads_part), "_t%u",
+                          db_worker_pool_thread_count());
+    }
+    (void)db_snprintf(g_state.capability_mode, sizeof(g_state.capability_mode),
+                      "%s%s_%s%s%s", DB_CAP_MODE_CPU_OFFSCREEN_BO,
+                      renderer_part, kernels->name, layout_part, threads_part);
+    db_infof(BACKEND_NAME,
+             "cpu renderer: %s, kernel variant: %s, threads: %u, blend: %s, "
+             "layout: %s",
+             db_cpu_renderer_name(renderer_kind), kernels->name,
+             db_worker_pool_thread_count(),
+             db_cpu_blend_mode_name(g_state.blend_mode),
+             db_cpu_layout_name(layout.kind));
+    db_results_set_cpu_renderer(db_cpu_renderer_name(renderer_kind),
+                                db_worker_pool_thread_count(),
+                                db_cpu_layout_name(layout.kind),
+                                kernels->name);
+    db_cpu_log_mem_stats("init");
+}
+
+void db_renderer_cpu_renderer_init(void) {
+    db_cpu_renderer_init_variant(DB_CPU_RENDERER_AUTO);
+}
+
+static void db_cpu_renderer_scalar_init(void) {
+    db_cpu_renderer_init_variant(DB_CPU_RENDERER_SCALAR);
+}
+
+static void db_cpu_renderer_simd_init(void) {
+    db_cpu_renderer_init_variant(DB_CPU_RENDERER_SIMD);
+}
+
+static void db_cpu_renderer_threaded_init(void) {
+    db_cpu_renderer_init_variant(DB_CPU_RENDERER_THREADED);
 }
 
 void db_renderer_cpu_renderer_render_frame(uint32_t frame_index) {
     if (g_state.initialized == 0) {
         return;
     }
+    DB_TRACE_BEGIN("render_frame");
 
     int write_index = 0;
     if (g_state.history_mode != 0) {
         write_index = (g_state.history_read_index == 0) ? 1 : 0;
-        db_bo_copy(&g_state.bos[write_index],
-                   &g_state.bos[g_state.history_read_index]);
     }
 
     db_cpu_bo_t *write_bo = &g_state.bos[write_index];
     const db_cpu_bo_t *read_bo = &g_state.bos[g_state.history_read_index];
+    const uint64_t generation = ++g_state.generation;
 
     g_state.damage_row_count = 0U;
     if (g_state.runtime.pattern == DB_PATTERN_BANDS) {
-        db_render_bands(write_bo, frame_index);
+        // Every row is repainted, so nothing needs to be carried over.
+        db_render_bands(write_bo, frame_index, generation);
         db_cpu_set_full_damage(write_bo);
     } else if ((g_state.runtime.pattern == DB_PATTERN_SNAKE_GRID) ||
                (g_state.runtime.pattern == DB_PATTERN_SNAKE_RECT) ||
@@ -375,15 +928,9 @@ void db_renderer_cpu_renderer_render_frame(uint32_t frame_index) {
         db_snake_shape_cache_t shape_cache = {0};
         const db_snake_shape_cache_t *shape_cache_ptr = NULL;
         if (is_shapes != 0) {
-            if ((g_state.snake_row_bounds != NULL) &&
-                (g_state.snake_row_bounds_capacity > 0U) &&
-                (db_snake_shape_cache_init_from_index(
-                     &shape_cache, g_state.snake_row_bounds,
-                     g_state.snake_row_bounds_capacity,
-                     g_state.runtime.pattern_seed, plan.active_shape_index,
-                     DB_U32_SALT_PALETTE, &target.region, shape_kind) != 0)) {
-                shape_cache_ptr = &shape_cache;
-            }
+            shape_cache_ptr = db_cpu_snake_shape_cache(
+                &shape_cache, plan.active_shape_index, &target.region,
+                shape_kind);
         }
         if (target.has_next_mode_phase_flag != 0) {
             g_state.runtime.mode_phase_flag = target.next_mode_phase_flag;
@@ -391,12 +938,16 @@ void db_renderer_cpu_renderer_render_frame(uint32_t frame_index) {
         if (target.has_next_shape_index != 0) {
             g_state.runtime.snake_shape_index = target.next_shape_index;
         }
+        const int full_fill = (target.full_fill_on_phase_completed != 0) &&
+                              (plan.phase_completed != 0);
+        if (full_fill == 0) {
+            db_bo_sync(write_bo, read_bo, NULL, 0U);
+        }
         db_render_snake_step(write_bo, read_bo, &plan, &target.region,
                              shape_cache_ptr, target.target_r, target.target_g,
                              target.target_b,
-                             target.full_fill_on_phase_completed);
-        if ((target.full_fill_on_phase_completed != 0) &&
-            (plan.phase_completed != 0)) {
+                             target.full_fill_on_phase_completed, generation);
+        if (full_fill != 0) {
             db_cpu_set_full_damage(write_bo);
         } else {
             const size_t max_spans =
@@ -412,6 +963,7 @@ void db_renderer_cpu_renderer_render_frame(uint32_t frame_index) {
             } else {
                 db_cpu_set_full_damage(write_bo);
             }
+            db_cpu_mark_damage_rows(write_bo, generation);
         }
         g_state.runtime.snake_cursor = plan.next_cursor;
         g_state.runtime.snake_prev_start = plan.next_prev_start;
@@ -421,22 +973,181 @@ void db_renderer_cpu_renderer_render_frame(uint32_t frame_index) {
         const db_gradient_step_t gradient_step = db_gradient_step_from_runtime(
             g_state.runtime.pattern, g_state.runtime.gradient_head_row,
             g_state.runtime.mode_phase_flag, g_state.runtime.gradient_cycle,
-            g_state.runtime.bench_speed_step);
+            g_state.runtime.bench_speed_step, g_state.runtime.gradient_planner);
         const db_gradient_damage_plan_t *plan = &gradient_step.plan;
-        db_render_gradient(write_bo, plan->render_head_row,
-                           gradient_step.render_direction_down,
-                           plan->render_cycle_index);
-        db_cpu_set_damage_from_gradient_plan(plan, write_bo->height);
+        // Rows outside the plan's dirty ranges keep their color, so only
+        // those ranges are repainted; the first frame repaints everything
+        // because the BOs still hold the phase-0 clear color.
+        if (g_state.full_repaint_pending != 0) {
+            db_cpu_set_full_damage(write_bo);
+        } else {
+            db_cpu_set_damage_from_gradient_plan(plan, write_bo->height);
+        }
+        db_bo_sync(write_bo, read_bo, g_state.damage_rows,
+                   g_state.damage_row_count);
+        for (size_t i = 0U; i < g_state.damage_row_count; i++) {
+            db_render_gradient_range(write_bo, plan->render_head_row,
+                                     gradient_step.render_direction_down,
+                                     plan->render_cycle_index,
+                                     &g_state.damage_rows[i], generation);
+        }
         db_gradient_apply_step_to_runtime(&g_state.runtime, &gradient_step);
     }
 
     if (g_state.history_mode != 0) {
         g_state.history_read_index = write_index;
     }
+    g_state.full_repaint_pending = 0;
     g_state.state_hash =
         db_benchmark_runtime_state_hash(&g_state.runtime, g_state.frame_index,
                                         write_bo->width, write_bo->height);
     g_state.frame_index++;
+    DB_TRACE_END("render_frame");
+}
+
+// Writes the first `step_count` steps of a target solid into both BOs.
+static void db_cpu_seek_paint_steps(const db_snake_region_t *region,
+                                    const db_snake_shape_cache_t *shape_cache,
+                                    uint32_t step_count, uint32_t rgba) {
+    db_snake_row_run_iter_t iter =
+        db_snake_row_run_iter_make(region, 0U, step_count);
+    db_snake_row_run_t run;
+    uint32_t col_start = 0U;
+    uint32_t col_end = 0U;
+    while (db_snake_row_run_next(&iter, &run) != 0) {
+        if (db_cpu_snake_run_clip(&run, shape_cache, &g_state.bos[0],
+                                  &col_start, &col_end) != 0) {
+            db_bo_fill_row_span(&g_state.bos[0], run.row, col_start, col_end,
+                                rgba);
+            db_bo_fill_row_span(&g_state.bos[1], run.row, col_start, col_end,
+                                rgba);
+        }
+    }
+}
+
+// Rebuilds what shapes [0, shape_count) left in the BOs. Walking back from
+// the newest shape, each tile keeps the color of the first shape that covers
+// it, so the walk stops as soon as every tile is accounted for.
+static void db_cpu_seek_paint_shapes(uint32_t shape_count) {
+    const uint32_t cols = g_state.bos[0].width;
+    const uint32_t rows = g_state.bos[0].height;
+    const size_t tile_count = (size_t)cols * (size_t)rows;
+    uint8_t *covered = (uint8_t *)db_alloc_array_or_fail(
+        BACKEND_NAME, "seek_covered", tile_count, sizeof(uint8_t));
+    memset(covered, 0, tile_count);
+    const int is_shapes =
+        (g_state.runtime.pattern == DB_PATTERN_SNAKE_SHAPES);
+    size_t remaining = tile_count;
+    for (uint32_t shape_index = shape_count;
+         (shape_index > 0U) && (remaining > 0U); shape_index--) {
+        const db_snake_plan_t plan = {.active_shape_index = shape_index - 1U};
+        const db_snake_step_target_t target = db_snake_step_target_from_plan(
+            0, g_state.runtime.pattern_seed, &plan);
+        const db_snake_region_t *region = &target.region;
+        db_snake_shape_cache_t shape_cache = {0};
+        const db_snake_shape_cache_t *shape_cache_ptr =
+            (is_shapes != 0)
+                ? db_cpu_snake_shape_cache(&shape_cache,
+                                           plan.active_shape_index, region,
+                                           target.shape_kind)
+                : NULL;
+        const uint32_t rgba =
+            db_cpu_pack_rgb(target.target_r, target.target_g, target.target_b);
+        const uint32_t row_end = db_u32_min(region->y + region->height, rows);
+        const uint32_t col_end = db_u32_min(region->x + region->width, cols);
+        for (uint32_t row = region->y; row < row_end; row++) {
+            for (uint32_t col = region->x; col < col_end; col++) {
+                const size_t tile = ((size_t)row * cols) + col;
+                if ((covered[tile] != 0U) ||
+                    ((shape_cache_ptr != NULL) &&
+                     (db_snake_shape_cache_contains_tile(shape_cache_ptr, row,
+                                                         col) == 0))) {
+                    continue;
+                }
+                covered[tile] = 1U;
+                remaining--;
+                const size_t idx =
+                    db_cpu_layout_offset(&g_state.layout, row, col);
+                g_state.bos[0].pixels_rgba8[idx] = rgba;
+                g_state.bos[1].pixels_rgba8[idx] = rgba;
+            }
+        }
+    }
+    free(covered);
+}
+
+// Snake BOs are rebuilt from the shapes that still show plus the settled
+// prefix of the current target; only the last frames of that target, whose
+// blend windows overlap, are rendered for real.
+void db_renderer_cpu_renderer_seek(uint32_t frame_index) {
+    if ((g_state.initialized == 0) || (frame_index == 0U)) {
+        return;
+    }
+    if (db_benchmark_seek(&g_state.runtime, frame_index) != 0) {
+        // The first rendered frame repaints everything from the new state.
+        g_state.frame_index = frame_index;
+        return;
+    }
+
+    const int is_grid = (g_state.runtime.pattern == DB_PATTERN_SNAKE_GRID);
+    const uint32_t target_start =
+        db_snake_seek(&g_state.runtime, frame_index);
+    const uint64_t generation = ++g_state.generation;
+    if (is_grid != 0) {
+        if (target_start > 0U) {
+            float red = 0.0F;
+            float green = 0.0F;
+            float blue = 0.0F;
+            db_grid_target_color_rgb(!g_state.runtime.mode_phase_flag, &red,
+                                     &green, &blue);
+            const uint32_t rgba = db_cpu_pack_rgb(red, green, blue);
+            db_bo_fill_solid(&g_state.bos[0], rgba, generation);
+            db_bo_fill_solid(&g_state.bos[1], rgba, generation);
+        }
+    } else {
+        db_cpu_seek_paint_shapes(g_state.runtime.snake_shape_index);
+    }
+
+    const db_snake_plan_t plan = {
+        .active_shape_index = g_state.runtime.snake_shape_index,
+        .clearing_phase = g_state.runtime.mode_phase_flag,
+    };
+    const db_snake_step_target_t target = db_snake_step_target_from_plan(
+        is_grid, g_state.runtime.pattern_seed, &plan);
+    const uint32_t tile_count = target.region.width * target.region.height;
+    const uint32_t speed_step =
+        db_u32_max(g_state.runtime.bench_speed_step, 1U);
+    // A tile stays in the blend window for ceil(tiles_per_step / step)
+    // frames and turns solid on the next one.
+    const uint32_t blend_frames =
+        ((db_snake_grid_tiles_per_step(tile_count) + speed_step - 1U) /
+         speed_step) +
+        2U;
+    const uint32_t local_frame = frame_index - target_start;
+    uint32_t replay_start = target_start;
+    if (local_frame > (blend_frames + 1U)) {
+        const uint32_t resume_frame = local_frame - blend_frames;
+        const uint32_t settled = db_snake_seek_within_target(
+            &g_state.runtime, tile_count, resume_frame);
+        db_snake_shape_cache_t shape_cache = {0};
+        const db_snake_shape_cache_t *shape_cache_ptr =
+            (g_state.runtime.pattern == DB_PATTERN_SNAKE_SHAPES)
+                ? db_cpu_snake_shape_cache(&shape_cache,
+                                           plan.active_shape_index,
+                                           &target.region, target.shape_kind)
+                : NULL;
+        db_cpu_seek_paint_steps(
+            &target.region, shape_cache_ptr, settled,
+            db_cpu_pack_rgb(target.target_r, target.target_g, target.target_b));
+        replay_start = target_start + resume_frame;
+    }
+    db_bo_mark_rows(&g_state.bos[0], 0U, g_state.bos[0].height, generation);
+    db_bo_mark_rows(&g_state.bos[1], 0U, g_state.bos[1].height, generation);
+
+    g_state.frame_index = replay_start;
+    for (uint32_t frame = replay_start; frame < frame_index; frame++) {
+        db_renderer_cpu_renderer_render_frame(frame);
+    }
 }
 
 const uint32_t *db_renderer_cpu_renderer_pixels_rgba8(uint32_t *out_width,
@@ -444,13 +1155,25 @@ const uint32_t *db_renderer_cpu_renderer_pixels_rgba8(uint32_t *out_width,
     if (g_state.initialized == 0) {
         return NULL;
     }
+    const db_cpu_bo_t *read_bo = &g_state.bos[g_state.history_read_index];
     if (out_width != NULL) {
-        *out_width = g_state.bos[g_state.history_read_index].width;
+        *out_width = read_bo->width;
     }
     if (out_height != NULL) {
-        *out_height = g_state.bos[g_state.history_read_index].height;
+        *out_height = read_bo->height;
     }
-    return g_state.bos[g_state.history_read_index].pixels_rgba8;
+    if (g_state.layout.kind == DB_CPU_LAYOUT_LINEAR) {
+        return read_bo->pixels_rgba8;
+    }
+    db_cpu_row_job_t job = {
+        .kind = DB_CPU_ROW_JOB_DETILE,
+        .dst = &g_state.present,
+        .src = read_bo,
+        .row_begin = 0U,
+        .row_end = read_bo->height,
+    };
+    db_worker_pool_run(db_cpu_row_job_task, &job);
+    return g_state.present.pixels_rgba8;
 }
 
 uint32_t db_renderer_cpu_renderer_work_unit_count(void) {
@@ -461,13 +1184,24 @@ uint32_t db_renderer_cpu_renderer_work_unit_count(void) {
 }
 
 const char *db_renderer_cpu_renderer_capability_mode(void) {
-    return DB_CAP_MODE_CPU_OFFSCREEN_BO;
+    if (g_state.initialized == 0) {
+        return DB_CAP_MODE_CPU_OFFSCREEN_BO;
+    }
+    return g_state.capability_mode;
 }
 
 uint64_t db_renderer_cpu_renderer_state_hash(void) {
     return g_state.state_hash;
 }
 
+const db_benchmark_runtime_init_t *
+db_renderer_cpu_renderer_runtime_state(void) {
+    if (g_state.initialized == 0) {
+        return NULL;
+    }
+    return &g_state.runtime;
+}
+
 const db_dirty_row_range_t *
 db_renderer_cpu_renderer_damage_rows(size_t *out_count) {
     if (out_count != NULL) {
@@ -487,8 +1221,96 @@ void db_renderer_cpu_renderer_shutdown(void) {
     if (g_state.initialized == 0) {
         return;
     }
+    db_worker_pool_stop();
+    if ((g_state.blend_mode != DB_CPU_BLEND_FLOAT) &&
+        (g_state.blend_pixel_count > 0U)) {
+        db_infof(BACKEND_NAME,
+                 "%s blend: %llu pixels, %llu guard-band float fallbacks",
+                 db_cpu_blend_mode_name(g_state.blend_mode),
+                 (unsigned long long)g_state.blend_pixel_count,
+                 (unsigned long long)g_state.blend_fallback_count);
+    }
+    db_cpu_log_mem_stats("total");
+    db_mem_stats_end();
     free(g_state.snake_row_bounds);
-    free(g_state.bos[0].pixels_rgba8);
-    free(g_state.bos[1].pixels_rgba8);
+    db_snake_shape_row_bounds_cache_release(BACKEND_NAME);
+    db_mem_free(g_state.bos[0].pixels_rgba8);
+    db_mem_free(g_state.bos[1].pixels_rgba8);
+    free(g_state.bos[0].row_generation);
+    free(g_state.bos[1].row_generation);
+    db_mem_free(g_state.present.pixels_rgba8);
+    free(g_state.present.row_generation);
     g_state = (db_cpu_renderer_state_t){0};
 }
+
+int db_cpu_renderer_parse(const char *name, db_cpu_renderer_t *out_kind) {
+    if ((name == NULL) || (name[0] == '\0') ||
+        (strcmp(name, DB_CPU_RENDERER_NAME_AUTO) == 0)) {
+        *out_kind = DB_CPU_RENDERER_AUTO;
+        return 1;
+    }
+    if (strcmp(name, DB_CPU_RENDERER_NAME_SCALAR) == 0) {
+        *out_kind = DB_CPU_RENDERER_SCALAR;
+        return 1;
+    }
+    if (strcmp(name, DB_CPU_RENDERER_NAME_SIMD) == 0) {
+        *out_kind = DB_CPU_RENDERER_SIMD;
+        return 1;
+    }
+    if (strcmp(name, DB_CPU_RENDERER_NAME_THREADED) == 0) {
+        *out_kind = DB_CPU_RENDERER_THREADED;
+        return 1;
+    }
+    return 0;
+}
+
+const char *db_cpu_renderer_name(db_cpu_renderer_t kind) {
+    if (kind == DB_CPU_RENDERER_SCALAR) {
+        return DB_CPU_RENDERER_NAME_SCALAR;
+    }
+    if (kind == DB_CPU_RENDERER_SIMD) {
+        return DB_CPU_RENDERER_NAME_SIMD;
+    }
+    if (kind == DB_CPU_RENDERER_THREADED) {
+        return DB_CPU_RENDERER_NAME_THREADED;
+    }
+    return DB_CPU_RENDERER_NAME_AUTO;
+}
+
+#define DB_CPU_RENDERER_VTABLE(variant_name, init_fn)                          \
+    {                                                                          \
+        .name = (variant_name),                                                \
+        .init = (init_fn),                                                     \
+        .render_frame = db_renderer_cpu_renderer_render_frame,                 \
+        .seek = db_renderer_cpu_renderer_seek,                                 \
+        .shutdown = db_renderer_cpu_renderer_shutdown,                         \
+        .work_unit_count = db_renderer_cpu_renderer_work_unit_count,           \
+        .capability_mode = db_renderer_cpu_renderer_capability_mode,           \
+        .pixels_rgba8 = db_renderer_cpu_renderer_pixels_rgba8,                 \
+        .damage_rows = db_renderer_cpu_renderer_damage_rows,                   \
+        .state_hash = db_renderer_cpu_renderer_state_hash,                     \
+        .runtime_state = db_renderer_cpu_renderer_runtime_state,               \
+    }
+
+// Indexed by db_cpu_renderer_t.
+static const db_cpu_renderer_vtable_t g_cpu_renderer_vtables[] = {
+    DB_CPU_RENDERER_VTABLE(DB_CPU_RENDERER_NAME_AUTO,
+                           db_renderer_cpu_renderer_init),
+    DB_CPU_RENDERER_VTABLE(DB_CPU_RENDERER_NAME_SCALAR,
+                           db_cpu_renderer_scalar_init),
+    DB_CPU_RENDERER_VTABLE(DB_CPU_RENDERER_NAME_SIMD,
+                           db_cpu_renderer_simd_init),
+    DB_CPU_RENDERER_VTABLE(DB_CPU_RENDERER_NAME_THREADED,
+                           db_cpu_renderer_threaded_init),
+};
+
+#undef DB_CPU_RENDERER_VTABLE
+
+const db_cpu_renderer_vtable_t *db_cpu_renderer_vtable(db_cpu_renderer_t kind) {
+    const size_t count =
+        sizeof(g_cpu_renderer_vtables) / sizeof(g_cpu_renderer_vtables[0]);
+    if ((size_t)kind >= count) {
+        return &g_cpu_renderer_vtables[DB_CPU_RENDERER_AUTO];
+    }
+    return &g_cpu_renderer_vtables[kind];
+}
@@ -6,8 +6,49 @@
 
 #include "../renderer_benchmark_common.h"
 
+#define DB_CPU_RENDERER_NAME_AUTO "auto"
+#define DB_CPU_RENDERER_NAME_SCALAR "scalar"
+#define DB_CPU_RENDERER_NAME_SIMD "simd"
+#define DB_CPU_RENDERER_NAME_THREADED "threaded"
+
+typedef enum {
+    // Honors --cpu-kernel and --cpu-threads as given.
+    DB_CPU_RENDERER_AUTO = 0,
+    // Scalar kernels on the render thread only.
+    DB_CPU_RENDERER_SCALAR = 1,
+    // cpuid-selected SIMD kernels on the render thread only.
+    DB_CPU_RENDERER_SIMD = 2,
+    // cpuid-selected SIMD kernels across the worker pool (one thread per
+    // online CPU unless --cpu-threads is given).
+    DB_CPU_RENDERER_THREADED = 3,
+} db_cpu_renderer_t;
+
+// Every CPU renderer variant must produce identical pixels and state
+// hashes; displays only talk to the renderer through this table.
+typedef struct {
+    const char *name;
+    void (*init)(void);
+    void (*render_frame)(uint32_t frame_index);
+    // Puts the renderer in the state it holds before rendering frame
+    // `frame_index`; only valid straight after init.
+    void (*seek)(uint32_t frame_index);
+    void (*shutdown)(void);
+    uint32_t (*work_unit_count)(void);
+    const char *(*capability_mode)(void);
+    const uint32_t *(*pixels_rgba8)(uint32_t *out_width, uint32_t *out_height);
+    const db_dirty_row_range_t *(*damage_rows)(size_t *out_count);
+    uint64_t (*state_hash)(void);
+    // Runtime fields folded into state_hash for the last rendered frame.
+    const db_benchmark_runtime_init_t *(*runtime_state)(void);
+} db_cpu_renderer_vtable_t;
+
+int db_cpu_renderer_parse(const char *name, db_cpu_renderer_t *out_kind);
+const char *db_cpu_renderer_name(db_cpu_renderer_t kind);
+const db_cpu_renderer_vtable_t *db_cpu_renderer_vtable(db_cpu_renderer_t kind);
+
 void db_renderer_cpu_renderer_init(void);
 void db_renderer_cpu_renderer_render_frame(uint32_t frame_index);
+void db_renderer_cpu_renderer_seek(uint32_t frame_index);
 void db_renderer_cpu_renderer_shutdown(void);
 
 uint32_t db_renderer_cpu_renderer_work_unit_count(void);
@@ -17,5 +58,7 @@ const uint32_t *db_renderer_cpu_renderer_pixels_rgba8(uint32_t *out_width,
 const db_dirty_row_range_t *
 db_renderer_cpu_renderer_damage_rows(size_t *out_count);
 uint64_t db_renderer_cpu_renderer_state_hash(void);
+const db_benchmark_runtime_init_t *
+db_renderer_cpu_renderer_runtime_state(void);
 
 #endif
@@ -8,6 +8,7 @@
 #include "../../config/benchmark_config.h"
 #include "../../core/db_core.h"
 #include "../../core/db_hash.h"
+#include "../../core/db_trace.h"
 #include "../renderer_benchmark_common.h"
 #include "../renderer_gl_common.h"
 #include "../renderer_snake_common.h"
@@ -134,93 +135,86 @@ static void db_render_snake_step(const db_snake_plan_t *plan,
             shape_cache_ptr = &shape_cache;
         }
     }
+    const uint32_t cols = db_grid_cols_effective();
+    db_snake_row_run_t run;
+    uint32_t col_start = 0U;
+    uint32_t col_end = 0U;
     float prior_rgb[BENCH_SNAKE_PHASE_WINDOW_TILES * 3U] = {0.0F};
-    for (uint32_t update_index = 0U; update_index < plan->batch_size;
-         update_index++) {
-        const size_t prior_base = (size_t)update_index * 3U;
-        const uint32_t step = plan->active_cursor + update_index;
-        if (step >= plan->target_tile_count) {
-            break;
+    db_snake_row_run_iter_t active = db_snake_row_run_iter_make(
+        region, plan->active_cursor, plan->batch_size);
+    while (db_snake_row_run_next(&active, &run) != 0) {
+        if (db_snake_row_run_clip_to_shape(&run, shape_cache_ptr, &col_start,
+                                           &col_end) == 0) {
+            continue;
         }
-        const uint32_t tile_index = db_snake_tile_index_from_step(region, step);
-        const uint32_t row = tile_index / db_grid_cols_effective();
-        const uint32_t col = tile_index % db_grid_cols_effective();
-        if (shape_cache_ptr != NULL) {
-            const int inside =
-                db_snake_shape_cache_contains_tile(shape_cache_ptr, row, col);
-            if (inside == 0) {
+        const uint32_t run_steps = run.col_end - run.col_start;
+        for (uint32_t i = 0U; i < run_steps; i++) {
+            const uint32_t col = db_snake_row_run_col(&run, i);
+            if ((col < col_start) || (col >= col_end)) {
                 continue;
             }
+            const size_t prior_base = (size_t)(run.step_offset + i) * 3U;
+            const size_t tile_index = ((size_t)run.row * cols) + col;
+            const float *unit =
+                &g_state.vertex.vertices[tile_index * DB_RECT_VERTEX_COUNT *
+                                         g_state.vertex.vertex_stride];
+            prior_rgb[prior_base] = unit[DB_VERTEX_POSITION_FLOAT_COUNT + 0U];
+            prior_rgb[prior_base + 1U] =
+                unit[DB_VERTEX_POSITION_FLOAT_COUNT + 1U];
+            prior_rgb[prior_base + 2U] =
+                unit[DB_VERTEX_POSITION_FLOAT_COUNT + 2U];
         }
-        const size_t tile_float_offset = (size_t)tile_index *
-                                         DB_RECT_VERTEX_COUNT *
-                                         g_state.vertex.vertex_stride;
-        float *unit = &g_state.vertex.vertices[tile_float_offset];
-        prior_rgb[prior_base] = unit[DB_VERTEX_POSITION_FLOAT_COUNT + 0U];
-        prior_rgb[prior_base + 1U] = unit[DB_VERTEX_POSITION_FLOAT_COUNT + 1U];
-        prior_rgb[prior_base + 2U] = unit[DB_VERTEX_POSITION_FLOAT_COUNT + 2U];
     }
 
-    for (uint32_t update_index = 0U; update_index < plan->prev_count;
-         update_index++) {
-        const uint32_t step = plan->prev_start + update_index;
-        if (step >= plan->target_tile_count) {
-            break;
+    db_snake_row_run_iter_t settled =
+        db_snake_row_run_iter_make(region, plan->prev_start, plan->prev_count);
+    while (db_snake_row_run_next(&settled, &run) != 0) {
+        if (db_snake_row_run_clip_to_shape(&run, shape_cache_ptr, &col_start,
+                                           &col_end) == 0) {
+            continue;
         }
-        const uint32_t tile_index = db_snake_tile_index_from_step(region, step);
-        const uint32_t row = tile_index / db_grid_cols_effective();
-        const uint32_t col = tile_index % db_grid_cols_effective();
-        if (shape_cache_ptr != NULL) {
-            const int inside =
-                db_snake_shape_cache_contains_tile(shape_cache_ptr, row, col);
-            if (inside == 0) {
-                continue;
-            }
+        for (uint32_t col = col_start; col < col_end; col++) {
+            const size_t tile_index = ((size_t)run.row * cols) + col;
+            float *unit =
+                &g_state.vertex.vertices[tile_index * DB_RECT_VERTEX_COUNT *
+                                         g_state.vertex.vertex_stride];
+            db_set_rect_unit_rgb(unit, g_state.vertex.vertex_stride,
+                                 DB_VERTEX_POSITION_FLOAT_COUNT, target_r,
+                                 target_g, target_b);
         }
-        const size_t tile_float_offset = (size_t)tile_index *
-                                         DB_RECT_VERTEX_COUNT *
-                                         g_state.vertex.vertex_stride;
-        float *unit = &g_state.vertex.vertices[tile_float_offset];
-        db_set_rect_unit_rgb(unit, g_state.vertex.vertex_stride,
-                             DB_VERTEX_POSITION_FLOAT_COUNT, target_r, target_g,
-                             target_b);
     }
 
-    for (uint32_t update_index = 0U; update_index < plan->batch_size;
-         update_index++) {
-        const uint32_t step = plan->active_cursor + update_index;
-        if (step >= plan->target_tile_count) {
-            break;
+    active = db_snake_row_run_iter_make(region, plan->active_cursor,
+                                        plan->batch_size);
+    while (db_snake_row_run_next(&active, &run) != 0) {
+        if (db_snake_row_run_clip_to_shape(&run, shape_cache_ptr, &col_start,
+                                           &col_end) == 0) {
+            continue;
         }
-        const uint32_t tile_index = db_snake_tile_index_from_step(region, step);
-        const uint32_t row = tile_index / db_grid_cols_effective();
-        const uint32_t col = tile_index % db_grid_cols_effective();
-        if (shape_cache_ptr != NULL) {
-            const int inside =
-                db_snake_shape_cache_contains_tile(shape_cache_ptr, row, col);
-            if (inside == 0) {
+        const uint32_t run_steps = run.col_end - run.col_start;
+        for (uint32_t i = 0U; i < run_steps; i++) {
+            const uint32_t col = db_snake_row_run_col(&run, i);
+            if ((col < col_start) || (col >= col_end)) {
                 continue;
             }
+            const uint32_t update_index = run.step_offset + i;
+            const float blend_factor =
+                db_window_blend_factor(update_index, plan->batch_size);
+            const size_t tile_index = ((size_t)run.row * cols) + col;
+            float *unit =
+                &g_state.vertex.vertices[tile_index * DB_RECT_VERTEX_COUNT *
+                                         g_state.vertex.vertex_stride];
+            const size_t prior_base = (size_t)update_index * 3U;
+            float out_r = 0.0F;
+            float out_g = 0.0F;
+            float out_b = 0.0F;
+            db_blend_rgb(prior_rgb[prior_base], prior_rgb[prior_base + 1U],
+                         prior_rgb[prior_base + 2U], target_r, target_g,
+                         target_b, blend_factor, &out_r, &out_g, &out_b);
+            db_set_rect_unit_rgb(unit, g_state.vertex.vertex_stride,
+                                 DB_VERTEX_POSITION_FLOAT_COUNT, out_r, out_g,
+                                 out_b);
         }
-        const float blend_factor =
-            db_window_blend_factor(update_index, plan->batch_size);
-
-        const size_t tile_float_offset = (size_t)tile_index *
-                                         DB_RECT_VERTEX_COUNT *
-                                         g_state.vertex.vertex_stride;
-        float *unit = &g_state.vertex.vertices[tile_float_offset];
-        const size_t prior_base = (size_t)update_index * 3U;
-        const float prior_r = prior_rgb[prior_base];
-        const float prior_g = prior_rgb[prior_base + 1U];
-        const float prior_b = prior_rgb[prior_base + 2U];
-        float out_r = 0.0F;
-        float out_g = 0.0F;
-        float out_b = 0.0F;
-        db_blend_rgb(prior_r, prior_g, prior_b, target_r, target_g, target_b,
-                     blend_factor, &out_r, &out_g, &out_b);
-        db_set_rect_unit_rgb(unit, g_state.vertex.vertex_stride,
-                             DB_VERTEX_POSITION_FLOAT_COUNT, out_r, out_g,
-                             out_b);
     }
 }
 
@@ -844,6 +838,7 @@ void db_renderer_opengl_gl1_5_gles1_1_init(void) {
 }
 
 void db_renderer_opengl_gl1_5_gles1_1_render_frame(uint32_t frame_index) {
+    DB_TRACE_BEGIN("render_frame");
     db_snake_plan_t plan = {0};
     uint32_t snake_prev_start = 0U;
     uint32_t snake_prev_count = 0U;
@@ -913,7 +908,7 @@ void db_renderer_opengl_gl1_5_gles1_1_render_frame(uint32_t frame_index) {
         const db_gradient_step_t gradient_step = db_gradient_step_from_runtime(
             g_state.runtime.pattern, g_state.runtime.gradient_head_row,
             g_state.runtime.mode_phase_flag, g_state.runtime.gradient_cycle,
-            g_state.runtime.bench_speed_step);
+            g_state.runtime.bench_speed_step, g_state.runtime.gradient_planner);
         const db_gradient_damage_plan_t *gradient_plan = &gradient_step.plan;
         gradient_dirty_count = db_gradient_collect_dirty_ranges(
             gradient_plan, gradient_dirty_ranges);
@@ -1048,6 +1043,7 @@ void db_renderer_opengl_gl1_5_gles1_1_render_frame(uint32_t frame_index) {
         &g_state.runtime, g_state.frame_index, db_grid_cols_effective(),
         db_grid_rows_effective());
     g_state.frame_index++;
+    DB_TRACE_END("render_frame");
 }
 
 void db_renderer_opengl_gl1_5_gles1_1_shutdown(void) {
@@ -1066,6 +1062,7 @@ void db_renderer_opengl_gl1_5_gles1_1_shutdown(void) {
     free(g_state.snake_spans);
     free(g_state.snake_row_bounds);
     free(g_state.vertex.vertices);
+    db_snake_shape_row_bounds_cache_release(BACKEND_NAME);
     g_state = (renderer_state_t){0};
 }
 
@@ -6,6 +6,7 @@
 
 #include "../../config/benchmark_config.h"
 #include "../../core/db_core.h"
+#include "../../core/db_trace.h"
 #include "../renderer_benchmark_common.h"
 #include "../renderer_gl_common.h"
 #include "../renderer_snake_common.h"
@@ -490,6 +491,7 @@ void db_renderer_opengl_gl3_3_init(void) {
 }
 
 void db_renderer_opengl_gl3_3_render_frame(uint32_t frame_index) {
+    DB_TRACE_BEGIN("render_frame");
     db_gl3_ensure_history_targets();
     if (g_state.u_viewport_width >= 0) {
         int viewport_width = 0;
@@ -541,7 +543,7 @@ void db_renderer_opengl_gl3_3_render_frame(uint32_t frame_index) {
         const db_gradient_step_t gradient_step = db_gradient_step_from_runtime(
             g_state.runtime.pattern, g_state.runtime.gradient_head_row,
             g_state.runtime.mode_phase_flag, g_state.runtime.gradient_cycle,
-            g_state.runtime.bench_speed_step);
+            g_state.runtime.bench_speed_step, g_state.runtime.gradient_planner);
         const db_gradient_damage_plan_t *plan = &gradient_step.plan;
         db_gradient_apply_step_to_runtime(&g_state.runtime, &gradient_step);
         db_set_uniform1ui_u32_if_changed(
@@ -572,6 +574,7 @@ void db_renderer_opengl_gl3_3_render_frame(uint32_t frame_index) {
             &g_state.runtime, g_state.frame_index, db_grid_cols_effective(),
             db_grid_rows_effective());
         g_state.frame_index++;
+        DB_TRACE_END("render_frame");
         return;
     }
     if ((g_state.history_read_index < 0) || (g_state.history_width <= 0) ||
@@ -580,6 +583,7 @@ void db_renderer_opengl_gl3_3_render_frame(uint32_t frame_index) {
             &g_state.runtime, g_state.frame_index, db_grid_cols_effective(),
             db_grid_rows_effective());
         g_state.frame_index++;
+        DB_TRACE_END("render_frame");
         return;
     }
 
@@ -614,6 +618,7 @@ void db_renderer_opengl_gl3_3_render_frame(uint32_t frame_index) {
         &g_state.runtime, g_state.frame_index, db_grid_cols_effective(),
         db_grid_rows_effective());
     g_state.frame_index++;
+    DB_TRACE_END("render_frame");
 }
 
 void db_renderer_opengl_gl3_3_shutdown(void) {
@@ -627,6 +632,7 @@ void db_renderer_opengl_gl3_3_shutdown(void) {
     db_gl_vbo_delete_if_valid((unsigned int)g_state.vbo);
     glDeleteVertexArrays(1, &g_state.vao);
     free(g_state.vertex.vertices);
+    db_snake_shape_row_bounds_cache_release(BACKEND_NAME);
     g_state = (renderer_state_t){0};
 }
 
@@ -13,6 +13,7 @@
 #include "../config/benchmark_config.h"
 #include "../core/db_core.h"
 #include "../core/db_hash.h"
+#include "../core/db_results.h"
 
 #define DB_RECT_VERTEX_COUNT 6U
 #define DB_VERTEX_POSITION_FLOAT_COUNT 2U
@@ -33,6 +34,9 @@
 #define DB_COLOR_CHANNEL_BIAS 0.20F
 #define DB_COLOR_CHANNEL_SCALE 0.75F
 #define DB_GRADIENT_WINDOW_ROWS 32U
+#define DB_GRADIENT_PLANNER_NAME_CLOSED "closed"
+#define DB_GRADIENT_PLANNER_NAME_ITERATIVE "iterative"
+#define DB_GRADIENT_PLANNER_NAME_VALIDATE "validate"
 #define DB_PALETTE_SALT_BASE_STEP DB_U32_GOLDEN_RATIO
 
 typedef enum {
@@ -44,6 +48,14 @@ typedef enum {
     DB_PATTERN_SNAKE_SHAPES = 5,
 } db_pattern_t;
 
+typedef enum {
+    DB_GRADIENT_PLANNER_CLOSED = 0,
+    // Reference planner that walks every step of the frame.
+    DB_GRADIENT_PLANNER_ITERATIVE = 1,
+    // Runs both and fails the run on any difference.
+    DB_GRADIENT_PLANNER_VALIDATE = 2,
+} db_gradient_planner_t;
+
 typedef struct {
     uint32_t render_head_row;
     int render_direction_down;
@@ -84,6 +96,7 @@ typedef struct {
     uint32_t bench_speed_step;
     uint32_t random_seed;
     uint32_t pattern_seed;
+    db_gradient_planner_t gradient_planner;
 } db_benchmark_runtime_init_t;
 
 static inline uint64_t
@@ -114,11 +127,11 @@ db_benchmark_runtime_state_hash(const db_benchmark_runtime_init_t *runtime,
 }
 
 static inline uint32_t db_grid_rows_effective(void) {
-    return (uint32_t)BENCH_WINDOW_HEIGHT_PX;
+    return db_grid_height();
 }
 
 static inline uint32_t db_grid_cols_effective(void) {
-    return (uint32_t)BENCH_WINDOW_WIDTH_PX;
+    return db_grid_width();
 }
 
 static inline int
@@ -172,6 +185,37 @@ static inline const char *db_pattern_mode_name(db_pattern_t pattern) {
     }
 }
 
+static inline int db_gradient_planner_parse(const char *name,
+                                            db_gradient_planner_t *out) {
+    if ((name == NULL) ||
+        (strcmp(name, DB_GRADIENT_PLANNER_NAME_CLOSED) == 0)) {
+        *out = DB_GRADIENT_PLANNER_CLOSED;
+        return 1;
+    }
+    if (strcmp(name, DB_GRADIENT_PLANNER_NAME_ITERATIVE) == 0) {
+        *out = DB_GRADIENT_PLANNER_ITERATIVE;
+        return 1;
+    }
+    if (strcmp(name, DB_GRADIENT_PLANNER_NAME_VALIDATE) == 0) {
+        *out = DB_GRADIENT_PLANNER_VALIDATE;
+        return 1;
+    }
+    return 0;
+}
+
+static inline const char *
+db_gradient_planner_name(db_gradient_planner_t planner) {
+    switch (planner) {
+    case DB_GRADIENT_PLANNER_ITERATIVE:
+        return DB_GRADIENT_PLANNER_NAME_ITERATIVE;
+    case DB_GRADIENT_PLANNER_VALIDATE:
+        return DB_GRADIENT_PLANNER_NAME_VALIDATE;
+    case DB_GRADIENT_PLANNER_CLOSED:
+    default:
+        return DB_GRADIENT_PLANNER_NAME_CLOSED;
+    }
+}
+
 static inline uint32_t db_gradient_window_rows_effective(void) {
     const uint32_t rows =
         db_u32_min(db_grid_rows_effective(), DB_GRADIENT_WINDOW_ROWS);
@@ -241,6 +285,8 @@ static inline void db_log_benchmark_mode(const char *backend_name,
                                          db_pattern_t pattern,
                                          uint32_t pattern_seed,
                                          uint32_t bench_speed_step) {
+    db_results_set_benchmark(db_pattern_mode_name(pattern), pattern_seed,
+                             bench_speed_step);
     if ((pattern == DB_PATTERN_SNAKE_RECT) ||
         (pattern == DB_PATTERN_SNAKE_SHAPES)) {
         const char *shape_desc =
@@ -321,6 +367,16 @@ db_init_benchmark_runtime_common(const char *backend_name,
         backend_name, "draw_vertex_count", draw_vertex_count_u64);
     out_state->bench_speed_step =
         db_benchmark_speed_step_from_runtime(backend_name);
+    const char *planner =
+        db_runtime_option_get(DB_RUNTIME_OPT_GRADIENT_PLANNER);
+    if (db_gradient_planner_parse(planner, &out_state->gradient_planner) ==
+        0) {
+        db_failf(backend_name, "Invalid %s='%s' (expected: %s|%s|%s)",
+                 DB_RUNTIME_OPT_GRADIENT_PLANNER, planner,
+                 DB_GRADIENT_PLANNER_NAME_CLOSED,
+                 DB_GRADIENT_PLANNER_NAME_ITERATIVE,
+                 DB_GRADIENT_PLANNER_NAME_VALIDATE);
+    }
 
     if (requested != DB_PATTERN_BANDS) {
         out_state->random_seed =
@@ -465,9 +521,10 @@ static inline void db_palette_cycle_color_rgb(uint32_t cycle_index,
 }
 
 static inline db_gradient_damage_plan_t
-db_gradient_plan_next_frame(uint32_t head_row, int direction_down,
-                            uint32_t cycle_index, int restart_at_top_only,
-                            uint32_t head_step) {
+db_gradient_plan_next_frame_iterative(uint32_t head_row, int direction_down,
+                                      uint32_t cycle_index,
+                                      int restart_at_top_only,
+                                      uint32_t head_step) {
     db_gradient_damage_plan_t plan = {0};
     const uint32_t rows = db_grid_rows_effective();
     if (rows == 0U) {
@@ -664,15 +721,254 @@ db_gradient_plan_next_frame(uint32_t head_row, int direction_down,
     return plan;
 }
 
+// Where a gradient head ends up after `step_count` steps, plus the lowest and
+// highest head rows it passed through after the first step.
+typedef struct {
+    uint32_t head_row;
+    int direction_down;
+    // Palette cycles started on the way: wraps in fill mode, turns in sweep.
+    uint64_t cycle_advance;
+    uint32_t min_head_row;
+    uint32_t max_head_row;
+} db_gradient_walk_t;
+
+// Whether some q in [first, last] satisfies q % period == residue.
+static inline int db_u64_range_hits_residue(uint64_t first, uint64_t last,
+                                            uint64_t residue,
+                                            uint64_t period) {
+    const uint64_t offset = (residue + period - (first % period)) % period;
+    return (last >= first) && ((last - first) >= offset);
+}
+
+static inline uint32_t db_gradient_phase_head(uint64_t phase,
+                                              uint32_t max_head) {
+    return (phase <= max_head)
+               ? (uint32_t)phase
+               : (uint32_t)((2U * (uint64_t)max_head) + 1U - phase);
+}
+
+static inline void db_gradient_walk_visit(db_gradient_walk_t *walk,
+                                          uint32_t low, uint32_t high) {
+    walk->min_head_row = db_u32_min(walk->min_head_row, low);
+    walk->max_head_row = db_u32_max(walk->max_head_row, high);
+}
+
+// Closed form of the per-step head update in
+// db_gradient_plan_next_frame_iterative. Both modes are a walk on a ring of
+// phases: fill restarts at the top, so phase == head over max_head + 1 slots;
+// sweep bounces, and spending one step on each turn makes it a ring of
+// 2 * (max_head + 1) phases (down at h is phase h, up at h is phase
+// 2 * max_head + 1 - h). A new palette cycle starts whenever the phase
+// crosses a multiple of max_head + 1.
+static inline db_gradient_walk_t
+db_gradient_walk(uint32_t head_row, int direction_down, int restart_at_top_only,
+                 uint32_t max_head, uint64_t step_count) {
+    db_gradient_walk_t walk = {
+        .head_row = head_row,
+        .direction_down = (restart_at_top_only != 0) || (direction_down != 0),
+        .cycle_advance = 0U,
+        .min_head_row = UINT32_MAX,
+        .max_head_row = 0U,
+    };
+    if (step_count == 0U) {
+        walk.min_head_row = head_row;
+        walk.max_head_row = head_row;
+        return walk;
+    }
+    const uint64_t span = (uint64_t)max_head + 1U;
+    uint64_t remaining = step_count;
+    uint64_t phase = 0U;
+    // Heads past max_head (never produced by the walk itself) take their
+    // first steps off the ring.
+    if (head_row > max_head) {
+        if (restart_at_top_only != 0) {
+            db_gradient_walk_visit(&walk, 0U, 0U);
+            walk.cycle_advance = 1U;
+            remaining--;
+            phase = 0U;
+        } else if (walk.direction_down != 0) {
+            db_gradient_walk_visit(&walk, max_head, max_head);
+            walk.cycle_advance = 1U;
+            remaining--;
+            phase = span;
+        } else {
+            const uint64_t above = (uint64_t)head_row - max_head;
+            if (remaining <= above) {
+                walk.head_row = (uint32_t)(head_row - remaining);
+                db_gradient_walk_visit(&walk, walk.head_row, head_row - 1U);
+                return walk;
+            }
+            db_gradient_walk_visit(&walk, max_head, head_row - 1U);
+            remaining -= above;
+            phase = span;
+        }
+        if (remaining == 0U) {
+            walk.head_row = (phase == 0U) ? 0U : max_head;
+            walk.direction_down = (phase == 0U) ? 1 : 0;
+            return walk;
+        }
+    } else if ((restart_at_top_only != 0) || (walk.direction_down != 0)) {
+        phase = head_row;
+    } else {
+        phase = (2U * (uint64_t)max_head) + 1U - head_row;
+    }
+
+    const uint64_t ring = (restart_at_top_only != 0) ? span : (2U * span);
+    const uint64_t first = phase + 1U;
+    const uint64_t last = phase + remaining;
+    walk.cycle_advance += (last / span) - (phase / span);
+    const uint32_t first_head = db_gradient_phase_head(first % ring, max_head);
+    const uint32_t last_head = db_gradient_phase_head(last % ring, max_head);
+    walk.head_row = last_head;
+    walk.direction_down = ((last % ring) <= max_head);
+    // Between the turning points the head is monotonic, so the extremes are
+    // either a turning point inside the range or one of its ends.
+    const int hits_top =
+        db_u64_range_hits_residue(first, last, 0U, ring) ||
+        ((restart_at_top_only == 0) &&
+         db_u64_range_hits_residue(first, last, ring - 1U, ring));
+    const int hits_bottom =
+        db_u64_range_hits_residue(first, last, max_head, ring) ||
+        ((restart_at_top_only == 0) &&
+         db_u64_range_hits_residue(first, last, span, ring));
+    db_gradient_walk_visit(
+        &walk, (hits_top != 0) ? 0U : db_u32_min(first_head, last_head),
+        (hits_bottom != 0) ? max_head : db_u32_max(first_head, last_head));
+    return walk;
+}
+
+// Same plan as db_gradient_plan_next_frame_iterative in O(1) for any step.
+static inline db_gradient_damage_plan_t
+db_gradient_plan_next_frame(uint32_t head_row, int direction_down,
+                            uint32_t cycle_index, int restart_at_top_only,
+                            uint32_t head_step) {
+    db_gradient_damage_plan_t plan = {0};
+    const uint32_t rows = db_grid_rows_effective();
+    if (rows == 0U) {
+        return plan;
+    }
+
+    const uint32_t window_rows = db_gradient_window_rows_effective();
+    const uint32_t max_head = db_checked_add_u32(
+        DB_BENCH_COMMON_BACKEND, "gradient_max_head", rows, window_rows);
+    const db_gradient_walk_t walk =
+        db_gradient_walk(head_row, direction_down, restart_at_top_only,
+                         max_head, db_u32_max(head_step, 1U));
+    const uint32_t next_cycle = db_checked_u64_to_u32(
+        DB_BENCH_COMMON_BACKEND, "gradient_cycle_next",
+        (uint64_t)cycle_index + walk.cycle_advance);
+
+    const uint32_t prev_head_start =
+        db_u32_saturating_sub(head_row, window_rows);
+    const uint32_t prev_head_end =
+        db_checked_add_u32(DB_BENCH_COMMON_BACKEND, "gradient_prev_head_end",
+                           prev_head_start, window_rows);
+    // Window start and end are monotonic in the head row, so the union of
+    // every traversed window spans from the lowest to the highest head.
+    uint32_t traversed_dirty_start = db_u32_min(
+        prev_head_start,
+        db_u32_saturating_sub(walk.min_head_row, window_rows));
+    uint32_t traversed_dirty_end = db_u32_max(
+        db_u32_max(db_u32_min(prev_head_end, rows), prev_head_start),
+        db_u32_min(db_u32_saturating_sub(walk.max_head_row, window_rows) +
+                       window_rows,
+                   rows));
+
+    if (walk.cycle_advance > 1U) {
+        plan.dirty_row_start = 0U;
+        plan.dirty_row_count = rows;
+    } else if ((walk.cycle_advance == 1U) && (restart_at_top_only != 0)) {
+        // Fill-mode wrap: only the bottom rows the head left and the top rows
+        // it re-entered changed, unless the two ranges touch.
+        const uint32_t next_head_end = db_u32_min(
+            db_u32_saturating_sub(walk.head_row, window_rows) + window_rows,
+            rows);
+        if (next_head_end >= prev_head_start) {
+            plan.dirty_row_start = 0U;
+            plan.dirty_row_count = rows;
+        } else {
+            if (rows > prev_head_start) {
+                plan.dirty_row_start = prev_head_start;
+                plan.dirty_row_count = rows - prev_head_start;
+            }
+            if (next_head_end > 0U) {
+                plan.dirty_row_start_second = 0U;
+                plan.dirty_row_count_second = next_head_end;
+            }
+        }
+    } else if (traversed_dirty_end > traversed_dirty_start) {
+        plan.dirty_row_start = traversed_dirty_start;
+        plan.dirty_row_count = traversed_dirty_end - traversed_dirty_start;
+    }
+
+    plan.render_head_row = walk.head_row;
+    plan.render_direction_down = walk.direction_down;
+    plan.render_cycle_index = next_cycle;
+    plan.next_head_row = walk.head_row;
+    plan.next_direction_down = walk.direction_down;
+    plan.next_cycle_index = next_cycle;
+    return plan;
+}
+
+static inline void
+db_gradient_plan_validate_or_fail(const db_gradient_damage_plan_t *closed,
+                                  const db_gradient_damage_plan_t *iterative,
+                                  uint32_t head_row, uint32_t head_step) {
+    if ((closed->render_head_row == iterative->render_head_row) &&
+        (closed->render_direction_down == iterative->render_direction_down) &&
+        (closed->render_cycle_index == iterative->render_cycle_index) &&
+        (closed->next_head_row == iterative->next_head_row) &&
+        (closed->next_direction_down == iterative->next_direction_down) &&
+        (closed->next_cycle_index == iterative->next_cycle_index) &&
+        (closed->dirty_row_start == iterative->dirty_row_start) &&
+        (closed->dirty_row_count == iterative->dirty_row_count) &&
+        (closed->dirty_row_start_second ==
+         iterative->dirty_row_start_second) &&
+        (closed->dirty_row_count_second ==
+         iterative->dirty_row_count_second)) {
+        return;
+    }
+    db_failf(DB_BENCH_COMMON_BACKEND,
+             "gradient planner mismatch (head=%u step=%u): closed "
+             "head=%u down=%d cycle=%u dirty=%u+%u,%u+%u; iterative "
+             "head=%u down=%d cycle=%u dirty=%u+%u,%u+%u",
+             head_row, head_step, closed->next_head_row,
+             closed->next_direction_down, closed->next_cycle_index,
+             closed->dirty_row_start, closed->dirty_row_count,
+             closed->dirty_row_start_second, closed->dirty_row_count_second,
+             iterative->next_head_row, iterative->next_direction_down,
+             iterative->next_cycle_index, iterative->dirty_row_start,
+             iterative->dirty_row_count, iterative->dirty_row_start_second,
+             iterative->dirty_row_count_second);
+}
+
 static inline db_gradient_step_t
 db_gradient_step_from_runtime(db_pattern_t pattern, uint32_t head_row,
                               int mode_phase_flag, uint32_t cycle_index,
-                              uint32_t head_step) {
+                              uint32_t head_step,
+                              db_gradient_planner_t planner) {
     db_gradient_step_t result = {0};
     const int is_sweep = (pattern == DB_PATTERN_GRADIENT_SWEEP);
-    result.plan =
-        db_gradient_plan_next_frame(head_row, is_sweep ? mode_phase_flag : 1,
-                                    cycle_index, is_sweep ? 0 : 1, head_step);
+    const int direction_down = is_sweep ? mode_phase_flag : 1;
+    const int restart_at_top_only = is_sweep ? 0 : 1;
+    if (planner == DB_GRADIENT_PLANNER_ITERATIVE) {
+        result.plan = db_gradient_plan_next_frame_iterative(
+            head_row, direction_down, cycle_index, restart_at_top_only,
+            head_step);
+    } else {
+        result.plan =
+            db_gradient_plan_next_frame(head_row, direction_down, cycle_index,
+                                        restart_at_top_only, head_step);
+    }
+    if (planner == DB_GRADIENT_PLANNER_VALIDATE) {
+        const db_gradient_damage_plan_t reference =
+            db_gradient_plan_next_frame_iterative(head_row, direction_down,
+                                                  cycle_index,
+                                                  restart_at_top_only,
+                                                  head_step);
+        db_gradient_plan_validate_or_fail(&result.plan, &reference, head_row,
+                                          head_step);
+    }
     result.render_direction_down =
         is_sweep ? result.plan.render_direction_down : 1;
     result.next_mode_phase_flag = result.plan.next_direction_down;
@@ -712,6 +1008,43 @@ db_gradient_apply_step_to_runtime(db_benchmark_runtime_init_t *runtime,
     runtime->gradient_cycle = step->plan.next_cycle_index;
 }
 
+// Moves a runtime fresh from db_init_benchmark_runtime_common to the state
+// it holds before rendering frame `frame_index`, in O(1). Bands frames depend
+// only on the frame index. Snake modes return 0: their BO depends on every
+// shape still showing, so they seek through db_snake_seek and the renderer.
+static inline int db_benchmark_seek(db_benchmark_runtime_init_t *runtime,
+                                    uint32_t frame_index) {
+    if (runtime == NULL) {
+        return 0;
+    }
+    if (runtime->pattern == DB_PATTERN_BANDS) {
+        return 1;
+    }
+    if ((runtime->pattern != DB_PATTERN_GRADIENT_SWEEP) &&
+        (runtime->pattern != DB_PATTERN_GRADIENT_FILL)) {
+        return 0;
+    }
+    const uint32_t rows = db_grid_rows_effective();
+    if (rows == 0U) {
+        return 1;
+    }
+    const int is_sweep = (runtime->pattern == DB_PATTERN_GRADIENT_SWEEP);
+    const uint32_t max_head =
+        db_checked_add_u32(DB_BENCH_COMMON_BACKEND, "gradient_max_head", rows,
+                           db_gradient_window_rows_effective());
+    const uint64_t step_count =
+        (uint64_t)frame_index * db_u32_max(runtime->bench_speed_step, 1U);
+    const db_gradient_walk_t walk = db_gradient_walk(
+        runtime->gradient_head_row, is_sweep ? runtime->mode_phase_flag : 1,
+        is_sweep ? 0 : 1, max_head, step_count);
+    runtime->gradient_head_row = walk.head_row;
+    runtime->mode_phase_flag = walk.direction_down;
+    runtime->gradient_cycle = db_checked_u64_to_u32(
+        DB_BENCH_COMMON_BACKEND, "gradient_cycle_seek",
+        (uint64_t)runtime->gradient_cycle + walk.cycle_advance);
+    return 1;
+}
+
 static inline void db_gradient_row_color_rgb(uint32_t row_index,
                                              uint32_t head_row,
                                              int direction_down,
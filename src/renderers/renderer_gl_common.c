@@ -10,6 +10,7 @@
 #include "../core/db_buffer_convert.h"
 #include "../core/db_core.h"
 #include "../core/db_hash.h"
+#include "../core/db_trace.h"
 #include "renderer_benchmark_common.h"
 #include "renderer_snake_common.h"
 #include "renderer_snake_shape_common.h"
@@ -801,7 +802,7 @@ db_gl_upload_ranges_subdata_target(GLenum target, const void *source_base,
     }
 }
 
-void db_gl_upload_ranges_target(
+static void db_gl_upload_ranges_target_impl(
     const void *source_base, size_t total_bytes,
     const db_gl_upload_range_t *ranges, size_t range_count,
     db_gl_upload_target_t target, unsigned int target_buffer,
@@ -872,6 +873,20 @@ void db_gl_upload_ranges_target(
                                        range_count);
 }
 
+void db_gl_upload_ranges_target(
+    const void *source_base, size_t total_bytes,
+    const db_gl_upload_range_t *ranges, size_t range_count,
+    db_gl_upload_target_t target, unsigned int target_buffer,
+    int use_persistent_upload, void *persistent_mapped_ptr,
+    int use_map_range_upload, int use_map_buffer_upload) {
+    DB_TRACE_BEGIN("gl_upload_ranges");
+    db_gl_upload_ranges_target_impl(
+        source_base, total_bytes, ranges, range_count, target, target_buffer,
+        use_persistent_upload, persistent_mapped_ptr, use_map_range_upload,
+        use_map_buffer_upload);
+    DB_TRACE_END("gl_upload_ranges");
+}
+
 void db_gl_upload_buffer(const void *source, size_t bytes,
                          int use_persistent_upload, void *persistent_mapped_ptr,
                          int use_map_range_upload, int use_map_buffer_upload) {
@@ -1007,10 +1022,9 @@ db_gl_collect_damage_upload_ranges(const db_gl_damage_upload_plan_t *plan,
         out_capacity);
 }
 
-size_t
-db_gl_collect_pattern_upload_ranges(const db_gl_pattern_upload_collect_t *ctx,
-                                    db_gl_upload_range_t *out_ranges,
-                                    size_t out_capacity) {
+static size_t db_gl_collect_pattern_upload_ranges_impl(
+    const db_gl_pattern_upload_collect_t *ctx, db_gl_upload_range_t *out_ranges,
+    size_t out_capacity) {
     if ((ctx == NULL) || (out_ranges == NULL) || (out_capacity == 0U)) {
         return 0U;
     }
@@ -1113,6 +1127,17 @@ db_gl_collect_pattern_upload_ranges(const db_gl_pattern_upload_collect_t *ctx,
     return db_gl_collect_damage_upload_ranges(&upload_plan, out_ranges, 1U);
 }
 
+size_t
+db_gl_collect_pattern_upload_ranges(const db_gl_pattern_upload_collect_t *ctx,
+                                    db_gl_upload_range_t *out_ranges,
+                                    size_t out_capacity) {
+    DB_TRACE_BEGIN("gl_collect_upload_ranges");
+    const size_t range_count =
+        db_gl_collect_pattern_upload_ranges_impl(ctx, out_ranges, out_capacity);
+    DB_TRACE_END("gl_collect_upload_ranges");
+    return range_count;
+}
+
 size_t db_gl_for_each_upload_row_span(const char *backend_name,
                                       uint32_t row_unit_width,
                                       const db_gl_upload_range_t *ranges,
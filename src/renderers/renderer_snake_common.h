@@ -7,6 +7,7 @@
 #include "../config/benchmark_config.h"
 #include "../core/db_core.h"
 #include "../core/db_hash.h"
+#include "renderer_benchmark_common.h"
 #include "renderer_snake_shape_common.h"
 
 #define DB_SNAKE_COMMON_BACKEND "renderer_snake_common"
@@ -22,11 +23,11 @@
 #define DB_SNAKE_REGION_SALT_ORIGIN_Y DB_U32_SALT_ORIGIN_Y
 
 static inline uint32_t db_snake_grid_rows_effective(void) {
-    return (uint32_t)BENCH_WINDOW_HEIGHT_PX;
+    return db_grid_height();
 }
 
 static inline uint32_t db_snake_grid_cols_effective(void) {
-    return (uint32_t)BENCH_WINDOW_WIDTH_PX;
+    return db_grid_width();
 }
 
 static inline float db_snake_color_channel(uint32_t seed) {
@@ -187,58 +188,129 @@ db_snake_region_from_index(uint32_t seed, uint32_t shape_index) {
     return region;
 }
 
-static inline uint32_t
-db_snake_tile_index_from_step(const db_snake_region_t *region, uint32_t step) {
+// A run of consecutive snake steps along one grid row. Even region rows walk
+// columns upward from col_start, odd rows downward from col_end - 1.
+typedef struct {
+    uint32_t row;
+    uint32_t col_start;
+    uint32_t col_end;
+    // Steps of the walk that precede this run.
+    uint32_t step_offset;
+    int reversed;
+} db_snake_row_run_t;
+
+typedef struct {
+    uint32_t region_x;
+    uint32_t region_y;
+    uint32_t region_width;
+    uint32_t local_row;
+    uint32_t local_col_step;
+    uint32_t step_offset;
+    uint32_t remaining;
+} db_snake_row_run_iter_t;
+
+// Walks steps [step_start, step_start + step_count), clamped to the region,
+// one row run at a time. Only the start position needs a division.
+static inline db_snake_row_run_iter_t
+db_snake_row_run_iter_make(const db_snake_region_t *region,
+                           uint32_t step_start, uint32_t step_count) {
+    db_snake_row_run_iter_t iter = {0};
     if ((region == NULL) || (region->width == 0U) || (region->height == 0U)) {
-        return 0U;
+        return iter;
     }
-    const uint32_t cols = db_snake_grid_cols_effective();
-    const uint32_t local_row = step / region->width;
-    const uint32_t local_col_step = step % region->width;
-    const uint32_t local_col = ((local_row & 1U) == 0U)
-                                   ? local_col_step
-                                   : ((region->width - 1U) - local_col_step);
-    return ((region->y + local_row) * cols) + (region->x + local_col);
+    const uint32_t tile_count = region->width * region->height;
+    if (step_start >= tile_count) {
+        return iter;
+    }
+    iter.region_x = region->x;
+    iter.region_y = region->y;
+    iter.region_width = region->width;
+    iter.local_row = step_start / region->width;
+    iter.local_col_step = step_start % region->width;
+    iter.remaining = db_u32_min(step_count, tile_count - step_start);
+    return iter;
 }
 
+static inline int db_snake_row_run_next(db_snake_row_run_iter_t *iter,
+                                        db_snake_row_run_t *out_run) {
+    if (iter->remaining == 0U) {
+        return 0;
+    }
+    const uint32_t width = iter->region_width;
+    const uint32_t run_steps =
+        db_u32_min(iter->remaining, width - iter->local_col_step);
+    const int reversed = ((iter->local_row & 1U) != 0U) ? 1 : 0;
+    const uint32_t first_local_col =
+        (reversed != 0) ? (width - iter->local_col_step - run_steps)
+                        : iter->local_col_step;
+    *out_run = (db_snake_row_run_t){
+        .row = iter->region_y + iter->local_row,
+        .col_start = iter->region_x + first_local_col,
+        .col_end = iter->region_x + first_local_col + run_steps,
+        .step_offset = iter->step_offset,
+        .reversed = reversed,
+    };
+    iter->step_offset += run_steps;
+    iter->remaining -= run_steps;
+    iter->local_row++;
+    iter->local_col_step = 0U;
+    return 1;
+}
+
+// Column of the `index`-th step of a run.
+static inline uint32_t db_snake_row_run_col(const db_snake_row_run_t *run,
+                                            uint32_t index) {
+    return (run->reversed != 0) ? (run->col_end - 1U - index)
+                                : (run->col_start + index);
+}
+
+// Narrows a run to the columns the shape covers on its row; without a shape
+// cache the whole run is kept. Returns 0 when nothing is left.
+static inline int
+db_snake_row_run_clip_to_shape(const db_snake_row_run_t *run,
+                               const db_snake_shape_cache_t *shape_cache,
+                               uint32_t *out_col_start, uint32_t *out_col_end) {
+    *out_col_start = run->col_start;
+    *out_col_end = run->col_end;
+    if (shape_cache == NULL) {
+        return 1;
+    }
+    return db_snake_shape_cache_clip_row_span(shape_cache, run->row,
+                                              out_col_start, out_col_end);
+}
+
+// Appends the row runs of a step range as spans. A run that touches the
+// previous span on the same row (the settled and active windows meet mid
+// row) extends it instead of adding a span.
 static inline void db_snake_append_step_spans_for_region(
     db_snake_col_span_t *spans, size_t max_spans, size_t *inout_span_count,
-    uint32_t region_x, uint32_t region_y, uint32_t region_cols,
-    uint32_t region_rows, uint32_t step_start, uint32_t step_count) {
-    if ((spans == NULL) || (inout_span_count == NULL) || (region_cols == 0U) ||
-        (region_rows == 0U) || (step_count == 0U)) {
+    const db_snake_region_t *region, uint32_t step_start,
+    uint32_t step_count) {
+    if ((spans == NULL) || (inout_span_count == NULL)) {
         return;
     }
-
-    uint32_t remaining = step_count;
-    uint32_t step_cursor = step_start;
-    while (remaining > 0U) {
-        const uint32_t local_row = step_cursor / region_cols;
-        if (local_row >= region_rows) {
-            return;
-        }
-        const uint32_t local_col_step = step_cursor % region_cols;
-        const uint32_t steps_left_in_row = region_cols - local_col_step;
-        const uint32_t chunk_steps = db_u32_min(remaining, steps_left_in_row);
-        uint32_t first_local_col = 0U;
-        if ((local_row & 1U) == 0U) {
-            first_local_col = local_col_step;
-        } else {
-            first_local_col =
-                (region_cols - 1U) - (local_col_step + chunk_steps - 1U);
+    db_snake_row_run_iter_t iter =
+        db_snake_row_run_iter_make(region, step_start, step_count);
+    db_snake_row_run_t run;
+    while (db_snake_row_run_next(&iter, &run) != 0) {
+        if (*inout_span_count > 0U) {
+            db_snake_col_span_t *last = &spans[*inout_span_count - 1U];
+            if ((last->row == run.row) && (last->col_end >= run.col_start) &&
+                (run.col_end >= last->col_start)) {
+                last->col_start = db_u32_min(last->col_start, run.col_start);
+                last->col_end = db_u32_max(last->col_end, run.col_end);
+                continue;
+            }
         }
-
         if (*inout_span_count >= max_spans) {
             return;
         }
         spans[*inout_span_count] = (db_snake_col_span_t){
-            .row = region_y + local_row,
-            .col_start = region_x + first_local_col,
-            .col_end = region_x + first_local_col + chunk_steps,
+            .row = run.row,
+            .col_start = run.col_start,
+            .col_end = run.col_end,
         };
         (*inout_span_count)++;
-        step_cursor += chunk_steps;
-        remaining -= chunk_steps;
     }
 }
 
@@ -253,12 +325,11 @@ db_snake_collect_damage_spans(db_snake_col_span_t *spans, size_t max_spans,
         return 0U;
     }
     size_t span_count = 0U;
-    db_snake_append_step_spans_for_region(
-        spans, max_spans, &span_count, region->x, region->y, region->width,
-        region->height, settled_start, settled_count);
-    db_snake_append_step_spans_for_region(
-        spans, max_spans, &span_count, region->x, region->y, region->width,
-        region->height, active_start, active_count);
+    db_snake_append_step_spans_for_region(spans, max_spans, &span_count,
+                                          region, settled_start,
+                                          settled_count);
+    db_snake_append_step_spans_for_region(spans, max_spans, &span_count,
+                                          region, active_start, active_count);
     if (shape_cache != NULL) {
         span_count = db_snake_filter_spans_for_shape_cache(spans, span_count,
                                                            shape_cache);
@@ -379,6 +450,94 @@ db_snake_plan_next_step(const db_snake_plan_request_t *request) {
         request->prev_count, 0, request->speed_step, 0, 1);
 }
 
+// Frames one target (a shape, or one full-grid phase) lasts: the pre-entry
+// frame, ceil(tiles / step) advancing frames and the completion frame.
+static inline uint64_t db_snake_target_frame_count(uint32_t tile_count,
+                                                   uint32_t speed_step) {
+    const uint64_t step = db_u32_max(speed_step, 1U);
+    return (((uint64_t)tile_count + step - 1U) / step) + 2U;
+}
+
+// Cursor of a target after `advance_count` advancing frames.
+static inline uint32_t db_snake_cursor_after(uint32_t tile_count,
+                                             uint32_t speed_step,
+                                             uint64_t advance_count) {
+    const uint64_t cursor = advance_count * db_u32_max(speed_step, 1U);
+    return (cursor < tile_count) ? (uint32_t)cursor : tile_count;
+}
+
+// Moves a runtime fresh from db_init_benchmark_runtime_common to the start
+// of the target that frame `frame_index` falls in and returns that target's
+// first frame. Whole targets are skipped by their tile counts, so the cost
+// is one region per completed shape (or O(1) for snake_grid).
+static inline uint32_t db_snake_seek(db_benchmark_runtime_init_t *runtime,
+                                     uint32_t frame_index) {
+    const uint32_t speed_step = runtime->bench_speed_step;
+    if (runtime->pattern == DB_PATTERN_SNAKE_GRID) {
+        const uint32_t tile_count =
+            db_snake_grid_cols_effective() * db_snake_grid_rows_effective();
+        const uint64_t phase_frames =
+            db_snake_target_frame_count(tile_count, speed_step);
+        const uint64_t phases = frame_index / phase_frames;
+        if (phases > 0U) {
+            runtime->mode_phase_flag ^= (int)(phases & 1U);
+            runtime->snake_prev_start = tile_count;
+            runtime->snake_prev_count = 0U;
+        }
+        return (uint32_t)(phases * phase_frames);
+    }
+
+    uint64_t target_start = 0U;
+    uint32_t prev_tile_count = 0U;
+    uint32_t shape_index = runtime->snake_shape_index;
+    for (;;) {
+        const db_snake_region_t region =
+            db_snake_region_from_index(runtime->pattern_seed, shape_index);
+        const uint32_t tile_count = region.width * region.height;
+        const uint64_t shape_frames =
+            db_snake_target_frame_count(tile_count, speed_step);
+        if ((tile_count == 0U) ||
+            ((target_start + shape_frames) > frame_index)) {
+            break;
+        }
+        target_start += shape_frames;
+        prev_tile_count = tile_count;
+        shape_index++;
+    }
+    if (shape_index != runtime->snake_shape_index) {
+        runtime->snake_shape_index = shape_index;
+        runtime->snake_prev_start = prev_tile_count;
+        runtime->snake_prev_count = 0U;
+    }
+    return (uint32_t)target_start;
+}
+
+// Sets the cursor fields to the state before local frame `local_frame`
+// (>= 1; local frame 0 is the pre-entry frame db_snake_seek stops at) of a
+// target with `tile_count` tiles. Returns how many leading steps are settled
+// to the solid target color by then; the steps after them are still inside
+// an overlapping blend window and have to be rendered to be reproduced.
+static inline uint32_t
+db_snake_seek_within_target(db_benchmark_runtime_init_t *runtime,
+                            uint32_t tile_count, uint32_t local_frame) {
+    const uint32_t speed_step = runtime->bench_speed_step;
+    const uint32_t advanced = local_frame - 1U;
+    runtime->snake_cursor =
+        db_snake_cursor_after(tile_count, speed_step, advanced);
+    if (advanced == 0U) {
+        runtime->snake_prev_start = 0U;
+        runtime->snake_prev_count = 0U;
+        return 0U;
+    }
+    const uint32_t prev_cursor =
+        db_snake_cursor_after(tile_count, speed_step, advanced - 1U);
+    runtime->snake_prev_start = prev_cursor;
+    runtime->snake_prev_count =
+        db_u32_max(db_snake_grid_tiles_per_step(tile_count),
+                   runtime->snake_cursor - prev_cursor);
+    return prev_cursor;
+}
+
 static inline float db_window_blend_factor(uint32_t window_index,
                                            uint32_t window_size) {
     const uint32_t span = db_u32_max(window_size, 1U);
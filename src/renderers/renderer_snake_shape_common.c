@@ -0,0 +1,126 @@
+#include "renderer_snake_shape_common.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../core/db_core.h"
+
+#define BACKEND_NAME "renderer_snake_shape_common"
+
+typedef struct {
+    db_snake_shape_row_bounds_key_t key;
+    db_snake_shape_row_bounds_t *row_bounds;
+    size_t row_bounds_capacity;
+    // 0 marks an empty slot.
+    uint64_t last_used;
+} db_snake_shape_row_bounds_entry_t;
+
+static struct {
+    pthread_mutex_t mutex;
+    db_snake_shape_row_bounds_entry_t
+        entries[DB_SNAKE_SHAPE_ROW_BOUNDS_CACHE_ENTRIES];
+    uint64_t tick;
+    uint64_t hits;
+    uint64_t misses;
+} g_row_bounds_cache = {.mutex = PTHREAD_MUTEX_INITIALIZER};
+
+static int
+db_snake_shape_row_bounds_key_equal(const db_snake_shape_row_bounds_key_t *a,
+                                    const db_snake_shape_row_bounds_key_t *b) {
+    return (a->pattern_seed == b->pattern_seed) &&
+           (a->shape_index == b->shape_index) &&
+           (a->shape_salt == b->shape_salt) &&
+           (a->shape_kind == b->shape_kind) && (a->region_x == b->region_x) &&
+           (a->region_y == b->region_y) &&
+           (a->region_width == b->region_width) &&
+           (a->region_height == b->region_height) &&
+           (a->row_count == b->row_count);
+}
+
+static db_snake_shape_row_bounds_entry_t *
+db_snake_shape_row_bounds_cache_find(
+    const db_snake_shape_row_bounds_key_t *key) {
+    for (uint32_t i = 0U; i < DB_SNAKE_SHAPE_ROW_BOUNDS_CACHE_ENTRIES; i++) {
+        db_snake_shape_row_bounds_entry_t *entry =
+            &g_row_bounds_cache.entries[i];
+        if ((entry->last_used != 0U) &&
+            db_snake_shape_row_bounds_key_equal(&entry->key, key)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+int db_snake_shape_row_bounds_cache_fetch(
+    const db_snake_shape_row_bounds_key_t *key,
+    db_snake_shape_row_bounds_t *out_row_bounds) {
+    (void)pthread_mutex_lock(&g_row_bounds_cache.mutex);
+    db_snake_shape_row_bounds_entry_t *entry =
+        db_snake_shape_row_bounds_cache_find(key);
+    if (entry == NULL) {
+        g_row_bounds_cache.misses++;
+        (void)pthread_mutex_unlock(&g_row_bounds_cache.mutex);
+        return 0;
+    }
+    memcpy(out_row_bounds, entry->row_bounds,
+           (size_t)key->row_count * sizeof(*out_row_bounds));
+    entry->last_used = ++g_row_bounds_cache.tick;
+    g_row_bounds_cache.hits++;
+    (void)pthread_mutex_unlock(&g_row_bounds_cache.mutex);
+    return 1;
+}
+
+void db_snake_shape_row_bounds_cache_store(
+    const db_snake_shape_row_bounds_key_t *key,
+    const db_snake_shape_row_bounds_t *row_bounds) {
+    (void)pthread_mutex_lock(&g_row_bounds_cache.mutex);
+    if (db_snake_shape_row_bounds_cache_find(key) != NULL) {
+        // Another thread built the same shape first.
+        (void)pthread_mutex_unlock(&g_row_bounds_cache.mutex);
+        return;
+    }
+    db_snake_shape_row_bounds_entry_t *victim = &g_row_bounds_cache.entries[0];
+    for (uint32_t i = 1U; i < DB_SNAKE_SHAPE_ROW_BOUNDS_CACHE_ENTRIES; i++) {
+        db_snake_shape_row_bounds_entry_t *entry =
+            &g_row_bounds_cache.entries[i];
+        if (entry->last_used < victim->last_used) {
+            victim = entry;
+        }
+    }
+    if (victim->row_bounds_capacity < key->row_count) {
+        free(victim->row_bounds);
+        victim->row_bounds = (db_snake_shape_row_bounds_t *)
+            db_alloc_array_or_fail(BACKEND_NAME, "row_bounds_cache",
+                                   key->row_count, sizeof(*row_bounds));
+        victim->row_bounds_capacity = key->row_count;
+    }
+    memcpy(victim->row_bounds, row_bounds,
+           (size_t)key->row_count * sizeof(*row_bounds));
+    victim->key = *key;
+    victim->last_used = ++g_row_bounds_cache.tick;
+    (void)pthread_mutex_unlock(&g_row_bounds_cache.mutex);
+}
+
+void db_snake_shape_row_bounds_cache_release(const char *backend) {
+    (void)pthread_mutex_lock(&g_row_bounds_cache.mutex);
+    const uint64_t lookups =
+        g_row_bounds_cache.hits + g_row_bounds_cache.misses;
+    if (lookups > 0U) {
+        db_infof(backend,
+                 "shape row bounds cache: %llu hits, %llu misses (%.1f%%)",
+                 (unsigned long long)g_row_bounds_cache.hits,
+                 (unsigned long long)g_row_bounds_cache.misses,
+                 (100.0 * (double)g_row_bounds_cache.hits) / (double)lookups);
+    }
+    for (uint32_t i = 0U; i < DB_SNAKE_SHAPE_ROW_BOUNDS_CACHE_ENTRIES; i++) {
+        free(g_row_bounds_cache.entries[i].row_bounds);
+        g_row_bounds_cache.entries[i] = (db_snake_shape_row_bounds_entry_t){0};
+    }
+    g_row_bounds_cache.tick = 0U;
+    g_row_bounds_cache.hits = 0U;
+    g_row_bounds_cache.misses = 0U;
+    (void)pthread_mutex_unlock(&g_row_bounds_cache.mutex);
+}
@@ -25,6 +25,7 @@
 #define DB_SNAKE_SHAPE_RECT_HALF_HEIGHT_MIN_F 0.30F
 #define DB_SNAKE_SHAPE_RECT_HALF_WIDTH_MAX_F 0.50F
 #define DB_SNAKE_SHAPE_RECT_HALF_WIDTH_MIN_F 0.30F
+#define DB_SNAKE_SHAPE_ROW_BOUNDS_CACHE_ENTRIES 16U
 #define DB_SNAKE_SHAPE_ROTATION_FULL_TURN_RAD_F 6.2831853F
 #define DB_SNAKE_SHAPE_SALT_CIRCLE_RX DB_HASH_MIX_MUL_A
 #define DB_SNAKE_SHAPE_SALT_CIRCLE_RY DB_HASH_MIX_MUL_B
@@ -102,6 +103,31 @@ typedef struct {
     size_t row_bounds_capacity;
 } db_snake_shape_cache_t;
 
+// Everything the exact row bounds of a shape are derived from.
+typedef struct {
+    uint32_t pattern_seed;
+    uint32_t shape_index;
+    uint32_t shape_salt;
+    uint32_t shape_kind;
+    uint32_t region_x;
+    uint32_t region_y;
+    uint32_t region_width;
+    uint32_t region_height;
+    uint32_t row_count;
+} db_snake_shape_row_bounds_key_t;
+
+// Process-wide LRU of built row bounds, shared by every renderer: a shape
+// stays active for many frames but its bounds only need solving once.
+// Entries are copied in and out under a lock, so callers keep their buffers.
+int db_snake_shape_row_bounds_cache_fetch(
+    const db_snake_shape_row_bounds_key_t *key,
+    db_snake_shape_row_bounds_t *out_row_bounds);
+void db_snake_shape_row_bounds_cache_store(
+    const db_snake_shape_row_bounds_key_t *key,
+    const db_snake_shape_row_bounds_t *row_bounds);
+// Logs the hit/miss counters (if the cache was used) and frees all entries.
+void db_snake_shape_row_bounds_cache_release(const char *backend);
+
 static inline db_snake_shape_kind_t
 db_snake_shapes_kind_from_index(uint32_t seed, uint32_t shape_index,
                                 uint32_t shape_salt) {
@@ -565,7 +591,29 @@ static inline int db_snake_shape_cache_init_from_index(
         .row_bounds_count = 0U,
         .row_bounds_capacity = row_bounds_capacity,
     };
-    return db_snake_shape_cache_build(shape_cache);
+    const db_snake_shape_row_bounds_key_t key = {
+        .pattern_seed = pattern_seed,
+        .shape_index = shape_index,
+        .shape_salt = shape_salt,
+        .shape_kind = (uint32_t)shape_kind,
+        .region_x = region->x,
+        .region_y = region->y,
+        .region_width = region->width,
+        .region_height = region->height,
+        .row_count = db_u32_min(region->height, (uint32_t)row_bounds_capacity),
+    };
+    if (key.row_count == 0U) {
+        return 0;
+    }
+    if (db_snake_shape_row_bounds_cache_fetch(&key, row_bounds) != 0) {
+        shape_cache->row_bounds_count = key.row_count;
+        return 1;
+    }
+    if (db_snake_shape_cache_build(shape_cache) == 0) {
+        return 0;
+    }
+    db_snake_shape_row_bounds_cache_store(&key, row_bounds);
+    return 1;
 }
 
 static inline int
@@ -1,6 +1,7 @@
 #include <stdint.h>
 
 #include "../../core/db_core.h"
+#include "../../core/db_trace.h"
 #include "../renderer_benchmark_common.h"
 #include "renderer_vulkan_1_2_multi_gpu_internal.h"
 
@@ -110,10 +111,16 @@ void db_renderer_vulkan_1_2_multi_gpu_init(
 }
 
 db_vk_frame_result_t db_renderer_vulkan_1_2_multi_gpu_render_frame(void) {
-    return db_vk_render_frame_impl();
+    DB_TRACE_BEGIN("render_frame");
+    const db_vk_frame_result_t result = db_vk_render_frame_impl();
+    DB_TRACE_END("render_frame");
+    return result;
 }
 
-void db_renderer_vulkan_1_2_multi_gpu_shutdown(void) { db_vk_shutdown_impl(); }
+void db_renderer_vulkan_1_2_multi_gpu_shutdown(void) {
+    db_vk_shutdown_impl();
+    db_snake_shape_row_bounds_cache_release(BACKEND_NAME);
+}
 
 const char *db_renderer_vulkan_1_2_multi_gpu_capability_mode(void) {
     return db_vk_capability_mode_impl();
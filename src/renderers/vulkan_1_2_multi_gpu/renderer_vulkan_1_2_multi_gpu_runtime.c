@@ -3,6 +3,7 @@
 
 #include "../../config/benchmark_config.h"
 #include "../../core/db_core.h"
+#include "../../core/db_trace.h"
 #include "../renderer_benchmark_common.h"
 #include "renderer_vulkan_1_2_multi_gpu.h"
 #include "renderer_vulkan_1_2_multi_gpu_internal.h"
@@ -370,7 +371,7 @@ db_vk_frame_result_t db_vk_render_frame_impl(void) {
         const db_gradient_step_t gradient_step = db_gradient_step_from_runtime(
             g_state.runtime.pattern, g_state.runtime.gradient_head_row,
             g_state.runtime.mode_phase_flag, g_state.runtime.gradient_cycle,
-            g_state.runtime.bench_speed_step);
+            g_state.runtime.bench_speed_step, g_state.runtime.gradient_planner);
         const db_gradient_damage_plan_t *plan = &gradient_step.plan;
         if ((grid_rows > 0U) && (grid_cols > 0U)) {
             const float shader_ignored_color[3] = {0.0F, 0.0F, 0.0F};
@@ -530,7 +531,9 @@ db_vk_frame_result_t db_vk_render_frame_impl(void) {
     pi.swapchainCount = 1;
     pi.pSwapchains = &g_state.swapchain_state.swapchain;
     pi.pImageIndices = &imgIndex;
+    DB_TRACE_BEGIN("queue_present");
     VkResult present_result = vkQueuePresentKHR(g_state.queue, &pi);
+    DB_TRACE_END("queue_present");
     if ((present_result != VK_SUCCESS) &&
         (present_result != VK_SUBOPTIMAL_KHR) &&
         (present_result != VK_ERROR_OUT_OF_DATE_KHR)) {
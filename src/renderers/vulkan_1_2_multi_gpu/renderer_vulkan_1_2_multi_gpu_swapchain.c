@@ -40,8 +40,8 @@ db_vk_choose_surface_extent(const db_vk_wsi_config_t *wsi_config,
         wsi_config->get_framebuffer_size(wsi_config->window_handle, &width,
                                          &height, wsi_config->user_data);
         if ((width <= 0) || (height <= 0)) {
-            width = BENCH_WINDOW_WIDTH_PX;
-            height = BENCH_WINDOW_HEIGHT_PX;
+            width = (int)db_grid_width();
+            height = (int)db_grid_height();
         }
         extent.width =
             db_checked_int_to_u32(BACKEND_NAME, "surface_extent_width", width);